@@ -46,6 +46,7 @@ QT += svg
 QT += sql
 QT += core
 QT += quick
+QT += network
 QT += location
 QT += concurrent
 QT += serialport
@@ -98,14 +99,58 @@ HEADERS += \
     src/crc32.h \
     src/Constants.h \
     src/AppQuiter.h \
-    src/Translator.h
+    src/Translator.h \
+    src/PacketFramer.h \
+    src/SpscQueue.h \
+    src/FrameReader.h \
+    src/FrameBatch.h \
+    src/AsyncFileWriter.h \
+    src/CaptureFile.h \
+    src/TelemetryFrame.h \
+    src/NumberParser.h \
+    src/TelemetryHistory.h \
+    src/TelemetryPlot.h \
+    src/TelemetryStatistics.h \
+    src/SequenceTracker.h \
+    src/FrameMerger.h \
+    src/Transport.h \
+    src/SerialTransport.h \
+    src/NetworkTransport.h \
+    src/DescriptorTransport.h \
+    src/FileTransport.h \
+    src/ReplayEngine.h \
+    src/LatencyMonitor.h \
+    src/TraceWriter.h \
+    src/CsvWriter.h \
+    src/TelemetryDatabase.h
 
 SOURCES += \
     src/DataParser.cpp \
     src/main.cpp \
     src/SerialManager.cpp \
-    src/crc32.c \
-    src/Translator.cpp
+    src/crc32.cpp \
+    src/Translator.cpp \
+    src/PacketFramer.cpp \
+    src/FrameReader.cpp \
+    src/FrameBatch.cpp \
+    src/AsyncFileWriter.cpp \
+    src/CaptureFile.cpp \
+    src/NumberParser.cpp \
+    src/TelemetryHistory.cpp \
+    src/TelemetryPlot.cpp \
+    src/TelemetryStatistics.cpp \
+    src/SequenceTracker.cpp \
+    src/FrameMerger.cpp \
+    src/Transport.cpp \
+    src/SerialTransport.cpp \
+    src/NetworkTransport.cpp \
+    src/DescriptorTransport.cpp \
+    src/FileTransport.cpp \
+    src/ReplayEngine.cpp \
+    src/LatencyMonitor.cpp \
+    src/TraceWriter.cpp \
+    src/CsvWriter.cpp \
+    src/TelemetryDatabase.cpp
 
 DISTFILES += \
     assets/qml/Components/ComConsole.qml \
@@ -119,7 +164,10 @@ DISTFILES += \
     assets/qml/UI.qml \
     assets/qml/Modules/Dashboard.qml \
     assets/qml/Modules/GpsMap.qml \
-    assets/qml/Components/DataLabel.qml
+    assets/qml/Components/DataLabel.qml \
+    assets/qml/Components/Plots.qml \
+    assets/qml/Components/Replay.qml \
+    assets/qml/Components/Diagnostics.qml
 
 RESOURCES += \
     assets/qml/qml.qrc \
@@ -329,6 +329,99 @@ GridLayout {
                 title: qsTr("Packets Parsed") + Translator.dummy
                 dataset: CDataParser.successCount
             }
+
+            DataLabel {
+                title: qsTr("Dropped Data") + Translator.dummy
+                dataset: CSerialManager.droppedBytes
+            }
+        }
+    }
+
+    //
+    // Link quality (packet loss, duplicates & re-ordering)
+    //
+    GroupBox {
+        font.family: app.monoFont
+        title: "// " + qsTr("Link Quality") + Translator.dummy
+        Layout.columnSpan: 2
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+
+        background: Rectangle {
+            color: "#000"
+            opacity: 0.75
+            border.width: 2
+            anchors.fill: parent
+            anchors.topMargin: 32
+            border.color: "#646464"
+        }
+
+        GridLayout {
+            columns: 2
+            rowSpacing: app.spacing
+            columnSpacing: app.spacing
+            anchors.centerIn: parent
+
+            DataLabel {
+                units: "%"
+                title: qsTr("Packet Loss") + Translator.dummy
+                dataset: (CDataParser.sequence.lossRate * 100).toFixed(2)
+            }
+
+            DataLabel {
+                units: "%"
+                title: qsTr("Recent Loss") + Translator.dummy
+                dataset: (CDataParser.sequence.windowLossRate * 100).toFixed(2)
+            }
+
+            DataLabel {
+                title: qsTr("Lost Packets") + Translator.dummy
+                dataset: CDataParser.sequence.lost
+            }
+
+            DataLabel {
+                title: qsTr("Longest Gap") + Translator.dummy
+                dataset: CDataParser.sequence.longestGap
+            }
+
+            DataLabel {
+                title: qsTr("Duplicates") + Translator.dummy
+                dataset: CDataParser.sequence.duplicates
+            }
+
+            DataLabel {
+                title: qsTr("Re-ordered") + Translator.dummy
+                dataset: CDataParser.sequence.reordered
+            }
+
+            DataLabel {
+                units: "ms"
+                title: qsTr("Data Age") + Translator.dummy
+                dataset: CLatencyMonitor.dataAge.toFixed(0)
+            }
+
+            Button {
+                Layout.alignment: Qt.AlignHCenter
+                text: qsTr("Latency…") + Translator.dummy
+                onClicked: diagnostics.open()
+
+                Diagnostics {
+                    id: diagnostics
+                }
+            }
+
+            //
+            // Packets delivered first by each receiver
+            //
+            Repeater {
+                model: CSerialManager.receiverStats
+
+                delegate: DataLabel {
+                    visible: modelData.connected
+                    title: modelData.device
+                    dataset: modelData.firstDeliveries + " / " + modelData.frames
+                }
+            }
         }
     }
 }
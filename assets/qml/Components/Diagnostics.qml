@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.0
+import QtQuick.Layouts 1.0
+import QtQuick.Controls 2.3
+
+//
+// Latency of each stage of the pipeline, from the reception of a packet
+// to the moment in which the dashboard shows it
+//
+Dialog {
+    id: diagnostics
+
+    modal: true
+    parent: Overlay.overlay
+    standardButtons: Dialog.Close
+    title: qsTr("Latency Diagnostics") + Translator.dummy
+
+    x: (parent.width - width) / 2
+    y: (parent.height - height) / 2
+    width: Math.max(implicitWidth, 480)
+
+    //
+    // Path of the last exported report
+    //
+    property string report: ""
+
+    ColumnLayout {
+        anchors.fill: parent
+        spacing: app.spacing
+
+        GridLayout {
+            columns: 6
+            rowSpacing: app.spacing
+            columnSpacing: 2 * app.spacing
+            Layout.fillWidth: true
+
+            Repeater {
+                model: [qsTr("Stage"), qsTr("Packets"), qsTr("Mean"),
+                        "p50", "p99", qsTr("Max")]
+
+                delegate: Label {
+                    font.bold: true
+                    color: "#72d5a3"
+                    font.family: app.monoFont
+                    text: modelData + Translator.dummy
+                }
+            }
+
+            Repeater {
+                model: diagnostics.visible ? CLatencyMonitor.stages : []
+
+                delegate: Repeater {
+                    property var stage: modelData
+                    model: [stage.name,
+                            stage.count,
+                            stage.mean.toFixed(2) + " ms",
+                            stage.p50.toFixed(2) + " ms",
+                            stage.p99.toFixed(2) + " ms",
+                            stage.max.toFixed(2) + " ms"]
+
+                    delegate: Label {
+                        font.family: app.monoFont
+                        text: modelData
+                    }
+                }
+            }
+        }
+
+        Label {
+            opacity: 0.6
+            font.family: app.monoFont
+            text: CLatencyMonitor.dataAge < 0 ?
+                      qsTr("No data rendered yet") + Translator.dummy :
+                      qsTr("Age of the displayed data: %1 ms").arg(
+                          CLatencyMonitor.dataAge.toFixed(0)) + Translator.dummy
+        }
+
+        Label {
+            opacity: 0.6
+            visible: report.length > 0
+            text: qsTr("Report saved to %1").arg(report) + Translator.dummy
+        }
+
+        Label {
+            opacity: 0.6
+            visible: CTraceWriter.enabled
+            text: qsTr("Writing trace to %1").arg(CTraceWriter.fileName) +
+                  Translator.dummy
+        }
+
+        RowLayout {
+            spacing: app.spacing
+            Layout.fillWidth: true
+
+            Button {
+                text: qsTr("Export") + Translator.dummy
+                onClicked: report = CLatencyMonitor.exportReport()
+            }
+
+            Button {
+                text: qsTr("Reset") + Translator.dummy
+                onClicked: CLatencyMonitor.reset()
+            }
+
+            Item {
+                Layout.fillWidth: true
+            }
+
+            Switch {
+                text: qsTr("Trace") + Translator.dummy
+                checked: CTraceWriter.enabled
+                onClicked: CTraceWriter.enabled = checked
+            }
+        }
+    }
+}
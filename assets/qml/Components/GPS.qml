@@ -153,7 +153,7 @@ ColumnLayout {
 
                     Connections {
                         target: CSerialManager
-                        onPacketReceived: {
+                        onDataReceived: {
                             timer.restart()
                             dot.opacity = 0.8
                         }
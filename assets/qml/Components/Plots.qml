@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.0
+import QtQuick.Layouts 1.0
+import QtQuick.Controls 2.0
+
+import KaanSat 1.0
+
+GridLayout {
+    id: plots
+
+    columns: 4
+    rowSpacing: app.spacing
+    columnSpacing: app.spacing
+
+    //
+    // Visible mission time (in milliseconds) for all plots
+    //
+    property int timeSpan: 60 * 1000
+
+    //
+    // Plot with title and latest value of each history channel
+    //
+    Repeater {
+        model: [
+            { title: qsTr("Altitude"), units: "m", channel: DataParser.kAltitude },
+            { title: qsTr("Pressure"), units: "Pa", channel: DataParser.kAtmPressure },
+            { title: qsTr("Ext. Temp"), units: "°C", channel: DataParser.kExtTemperature },
+            { title: qsTr("Voltage"), units: "V", channel: DataParser.kBatteryVoltage }
+        ]
+
+        delegate: Item {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            Layout.minimumHeight: 96
+
+            Rectangle {
+                id: background
+                color: "#000"
+                opacity: 0.75
+                border.width: 2
+                anchors.fill: parent
+                border.color: "#646464"
+            }
+
+            TelemetryPlot {
+                clip: true
+                anchors.fill: parent
+                timeSpan: plots.timeSpan
+                history: CDataParser.history
+                channel: modelData.channel
+                anchors.margins: background.border.width
+            }
+
+            Label {
+                color: "#72d5a3"
+                font.pixelSize: 11
+                font.family: app.monoFont
+                anchors {
+                    top: parent.top
+                    left: parent.left
+                    margins: app.spacing
+                }
+
+                text: {
+                    var value = "--.--"
+                    if (CSerialManager.connected && CDataParser.history.count > 0)
+                        value = CDataParser.history.latest(modelData.channel).toFixed(2)
+
+                    return modelData.title + Translator.dummy + ": " + value + " " + modelData.units
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick 2.0
+import QtQuick.Layouts 1.0
+import QtQuick.Dialogs 1.2
+import QtQuick.Controls 2.2
+
+RowLayout {
+    id: replay
+    spacing: app.spacing
+
+    //
+    // Formats the given time (in milliseconds) as mm:ss
+    //
+    function formatTime(ms) {
+        var seconds = Math.floor(ms / 1000)
+        var minutes = Math.floor(seconds / 60)
+        seconds = seconds % 60
+        return minutes + ":" + (seconds < 10 ? "0" : "") + seconds
+    }
+
+    //
+    // Recording selector
+    //
+    FileDialog {
+        id: fileDialog
+        title: qsTr("Open recording") + Translator.dummy
+        nameFilters: [qsTr("Captures (*.kcap)") + Translator.dummy,
+                      qsTr("All files (*)") + Translator.dummy]
+        onAccepted: CReplayEngine.open(fileUrl)
+    }
+
+    Button {
+        text: qsTr("Open") + Translator.dummy
+        onClicked: fileDialog.open()
+    }
+
+    //
+    // Playback controls
+    //
+    Button {
+        enabled: CReplayEngine.loaded
+        text: CReplayEngine.playing ? qsTr("Pause") + Translator.dummy :
+                                      qsTr("Play") + Translator.dummy
+        onClicked: CReplayEngine.playing ? CReplayEngine.pause() :
+                                           CReplayEngine.play()
+    }
+
+    Button {
+        enabled: CReplayEngine.loaded
+        text: qsTr("Stop") + Translator.dummy
+        onClicked: CReplayEngine.stop()
+    }
+
+    Button {
+        enabled: CReplayEngine.loaded
+        text: qsTr("End") + Translator.dummy
+        onClicked: CReplayEngine.jumpToEnd()
+    }
+
+    //
+    // Playback speed (0 means as fast as possible)
+    //
+    ComboBox {
+        id: speed
+        currentIndex: 0
+        Layout.preferredWidth: 96
+        model: ["1×", "2×", "5×", "10×", "50×", "Max"]
+        onCurrentIndexChanged: CReplayEngine.speed = [1, 2, 5, 10, 50, 0][currentIndex]
+    }
+
+    //
+    // Position
+    //
+    Slider {
+        id: position
+        from: 0
+        to: Math.max(1, CReplayEngine.duration)
+        Layout.fillWidth: true
+        enabled: CReplayEngine.loaded
+
+        //
+        // Seeking backwards parses the recording again from the start, so
+        // we only seek when the handle is released (or moved with the keys)
+        //
+        onMoved: if (!pressed) CReplayEngine.seek(value)
+        onPressedChanged: if (!pressed) CReplayEngine.seek(value)
+
+        Binding {
+            target: position
+            property: "value"
+            value: CReplayEngine.position
+            when: !position.pressed
+        }
+    }
+
+    Label {
+        font.family: app.monoFont
+        text: formatTime(CReplayEngine.position) + " / " +
+              formatTime(CReplayEngine.duration)
+    }
+}
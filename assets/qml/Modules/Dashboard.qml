@@ -99,6 +99,17 @@ Rectangle {
                     }
                 }
             }
+
+            Plots {
+                Layout.fillWidth: true
+                Layout.fillHeight: false
+                Layout.preferredHeight: 128
+            }
+
+            Replay {
+                Layout.fillWidth: true
+                Layout.fillHeight: false
+            }
         }
 
         //
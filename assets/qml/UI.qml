@@ -85,6 +85,44 @@ ColumnLayout {
             width: app.spacing
         }
 
+        //
+        // Backup receiver selector (packets received by both devices are
+        // merged and de-duplicated)
+        //
+        ComboBox {
+            id: backupDevices
+            Layout.preferredWidth: 196
+            model: CSerialManager.serialDevices
+            enabled: CSerialManager.serialDevices.length > 2
+            onCurrentIndexChanged: CSerialManager.openDevice(1, currentIndex)
+        }
+
+        //
+        // Spacer
+        //
+        Item {
+            width: app.spacing
+        }
+
+        //
+        // Network/pty/file source (e.g. tcp://relay:5000), read by the third
+        // receiver and merged with the serial devices
+        //
+        TextField {
+            id: source
+            selectByMouse: true
+            Layout.preferredWidth: 196
+            placeholderText: qsTr("Source (tcp://host:port)")
+            onAccepted: CSerialManager.openSource(2, text.trim())
+        }
+
+        //
+        // Spacer
+        //
+        Item {
+            width: app.spacing
+        }
+
         //
         // Baud rate selector
         //
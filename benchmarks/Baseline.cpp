@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDateTime>
+#include <QStringList>
+
+#include "Constants.h"
+#include "DataParser.h"
+
+#include "Baseline.h"
+
+/**
+ * Number of data/readings/status variables sent by the CanSat (without
+ * the CRC-32 code)
+ */
+static const int PACKET_ITEMS = static_cast<int>(DataParser::kChecksumCode);
+
+/**
+ * Number of seconds between the UNIX and GPS epochs
+ */
+static const quint64 GPS_EPOCH_OFFSET = 315964800;
+
+/**
+ * Discards the buffered data
+ */
+void SplitFramer::clear() {
+    m_buffer.clear();
+}
+
+/**
+ * @brief Appends the given @a data (the result of @c readAll()) to the
+ *        buffer and returns the complete packets
+ */
+QList<QByteArray> SplitFramer::onDataReceived(const QByteArray& data) {
+    QList<QByteArray> packets;
+    m_buffer.append(data);
+
+    // Buffer contains EOT byte, which represents a packet
+    if (m_buffer.contains(EOT_PRIMARY.toLatin1())) {
+        // We could have received part of the next packet - or more than one
+        // packet - so we split the data into packets to read each one
+        // separately.
+        packets = m_buffer.split(EOT_PRIMARY.toLatin1());
+
+        // Check if last packet is complete or not
+        if (m_buffer.endsWith(EOT_PRIMARY.toLatin1()))
+            m_buffer.clear();
+        else {
+            m_buffer = packets.last();
+            packets.removeLast();
+        }
+    }
+
+    // Ensure that buffer stays withing size limits
+    if (m_buffer.size() > MAX_BUFFER_SIZE)
+        m_buffer.clear();
+
+    return packets;
+}
+
+/**
+ * Constructor function
+ */
+QStringParser::QStringParser() :
+    m_resetCount(0),
+    m_errorCount(0),
+    m_successCount(0),
+    m_frame(TelemetryFrame()),
+    m_gpsTimeStrValue(0) {}
+
+/**
+ * Resets the counters and the last frame
+ */
+void QStringParser::clear() {
+    m_resetCount = 0;
+    m_errorCount = 0;
+    m_successCount = 0;
+    m_frame = TelemetryFrame();
+    m_gpsTimeStr.clear();
+    m_gpsTimeStrValue = 0;
+}
+
+/**
+ * @returns the number of packet reading errors
+ */
+int QStringParser::errorCount() const {
+    return m_errorCount;
+}
+
+/**
+ * @returns the number of packets that were successfully read
+ */
+int QStringParser::successCount() const {
+    return m_successCount;
+}
+
+/**
+ * @brief Validates and decodes the given data @a packet
+ *
+ * @returns @c true if the packet is valid
+ */
+bool QStringParser::parsePacket(const QByteArray& packet) {
+    typedef DataParser P;
+    QStringList data;
+
+    //--------------------------------------------------------------------------
+    // Raw packet validation (so that we don't crash while reading data)
+    //--------------------------------------------------------------------------
+    if (ENABLE_PACKET_CHECK) {
+        // Packet is empty, abort
+        if (packet.isEmpty()) {
+            ++m_errorCount;
+            return false;
+        }
+
+        // Packet does not begin with header code, abort
+        if (!packet.startsWith(HEADER_CODE)) {
+            ++m_errorCount;
+            return false;
+        }
+
+        // Packet does not end with secondary EOT code (primary EOT code was
+        // used to separate incoming packets
+        if (!packet.endsWith(EOT_SECONDARY.toLatin1())) {
+            ++m_errorCount;
+            return false;
+        }
+
+        // Ok, we can now begin analyzing the packet, start by making a copy
+        // of the packet so that we can manipulate it
+        QString copy = packet;
+
+        // Remove secondary EOT character, we do not need it
+        copy.chop(1);
+
+        // Split packet data and verify that its length is valid
+        data = copy.split(",");
+        if (data.count() != PACKET_ITEMS) {
+            ++m_errorCount;
+            return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Data handling
+    //--------------------------------------------------------------------------
+    TelemetryFrame frame;
+    frame.teamId = data.at(P::kTeamID).toInt();
+    frame.packetCount = data.at(P::kPacketCount).toInt();
+    frame.altitude = data.at(P::kAltitude).toDouble();
+    frame.atmPressure = data.at(P::kAtmPressure).toDouble();
+    frame.batteryVoltage = data.at(P::kBatteryVoltage).toDouble();
+    frame.intTemperature = data.at(P::kIntTemperature).toDouble();
+    frame.extTemperature = data.at(P::kExtTemperature).toDouble();
+    frame.airQuality = data.at(P::kAirQuality).toDouble();
+    frame.carbonMonoxide = data.at(P::kCarbonMonoxide).toDouble();
+    frame.gpsTime = data.at(P::kGpsTime).toULongLong();
+    frame.gpsLongitudeDeg = data.at(P::kGpsLongitudeDeg).toDouble();
+    frame.gpsLongitudeMin = data.at(P::kGpsLongitudeMin).toDouble();
+    frame.gpsLatitudeDeg = data.at(P::kGpsLatitudeDeg).toDouble();
+    frame.gpsLatitudeMin = data.at(P::kGpsLatitudeMin).toDouble();
+    frame.gpsAltitude = data.at(P::kGpsAltitude).toDouble();
+    frame.gpsSatelliteCount = data.at(P::kGpsSatelliteCount).toInt();
+    frame.accelerometer[0] = data.at(P::kAccelerometerX).toDouble();
+    frame.accelerometer[1] = data.at(P::kAccelerometerY).toDouble();
+    frame.accelerometer[2] = data.at(P::kAccelerometerZ).toDouble();
+    frame.magnetometer[0] = data.at(P::kMagnetometerX).toDouble();
+    frame.magnetometer[1] = data.at(P::kMagnetometerY).toDouble();
+    frame.magnetometer[2] = data.at(P::kMagnetometerZ).toDouble();
+    frame.missionTime = data.at(P::kMisionTime).toUInt();
+    frame.parachute = data.at(P::kParachute).toInt() != 0;
+    frame.checksum = 0;
+
+    // Compute derived values only once
+    frame.unixTime = frame.gpsTime + GPS_EPOCH_OFFSET;
+    frame.latitude = frame.gpsLatitudeDeg + frame.gpsLatitudeMin / 60.0;
+    frame.longitude = frame.gpsLongitudeDeg + frame.gpsLongitudeMin / 60.0;
+
+    // If current packet mision time or packet ID is less than in the last
+    // packet, then a satellite reset ocurred
+    if (m_frame.missionTime >= frame.missionTime)
+        ++m_resetCount;
+    else if (m_frame.packetCount >= frame.packetCount)
+        ++m_resetCount;
+
+    // Update current packet
+    m_frame = frame;
+    updateGpsTime();
+    ++m_successCount;
+
+    return true;
+}
+
+/**
+ * Updates the GPS date/time string if the GPS time has changed
+ */
+void QStringParser::updateGpsTime() {
+    if (m_gpsTimeStr.isEmpty() || m_gpsTimeStrValue != m_frame.unixTime) {
+        QDateTime time;
+        time.setTime_t(static_cast<uint>(m_frame.unixTime));
+        m_gpsTimeStr = time.toString("yyyy/MM/dd hh:mm:ss");
+        m_gpsTimeStrValue = m_frame.unixTime;
+    }
+}
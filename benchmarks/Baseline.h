@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <QList>
+#include <QString>
+#include <QByteArray>
+
+#include "TelemetryFrame.h"
+
+/**
+ * @brief Framing code used by @c SerialManager::onDataReceived() before
+ *        the packet framer was introduced
+ *
+ * Every read is appended to a growing buffer, which is split by the
+ * primary EOT byte. The incomplete tail is copied back into the buffer.
+ * It is only kept to measure the packet framer against it, do not use it
+ * in the application.
+ */
+class SplitFramer {
+public:
+    void clear();
+    QList<QByteArray> onDataReceived(const QByteArray& data);
+
+private:
+    QByteArray m_buffer;
+};
+
+/**
+ * @brief Packet decoding used by @c DataParser::parsePacket() before it
+ *        worked directly on the received bytes
+ *
+ * The packet is converted to UTF-16, split into a @c QStringList and each
+ * field is converted with @c QString::toInt() and @c QString::toDouble().
+ * Resets are counted and the GPS time string is updated for every packet,
+ * as the data parser did. The CRC-32 code is not verified (@c ENABLE_CRC32
+ * is disabled). It is only kept to measure the data parser against it, do
+ * not use it in the application.
+ */
+class QStringParser {
+public:
+    QStringParser();
+
+    void clear();
+    int errorCount() const;
+    int successCount() const;
+    bool parsePacket(const QByteArray& packet);
+
+private:
+    void updateGpsTime();
+
+private:
+    int m_resetCount;
+    int m_errorCount;
+    int m_successCount;
+    TelemetryFrame m_frame;
+    QString m_gpsTimeStr;
+    quint64 m_gpsTimeStrValue;
+};
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <algorithm>
+
+#include "Constants.h"
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+
+/**
+ * Creates a runner that repeats each benchmark the given number of times
+ */
+BenchmarkRunner::BenchmarkRunner(const int repetitions) :
+    m_repetitions(qMax(1, repetitions)) {}
+
+/**
+ * @brief Measures the given @a body, which processes the given number of
+ *        @a packets and @a bytes of the given @a corpus
+ */
+void BenchmarkRunner::run(const QString& name,
+                          const QString& corpus,
+                          const qint64 packets,
+                          const qint64 bytes,
+                          const std::function<void()>& setup,
+                          const std::function<void()>& body) {
+    // Warm up
+    if (setup)
+        setup();
+    body();
+
+    // Measure each repetition
+    QVector<qint64> times;
+    QVector<qint64> allocations;
+    for (int i = 0; i < m_repetitions; ++i) {
+        if (setup)
+            setup();
+
+        const qint64 allocs = ThreadAllocations();
+        const qint64 start = MonotonicTime();
+        body();
+        times.append(MonotonicTime() - start);
+        allocations.append(ThreadAllocations() - allocs);
+    }
+
+    // Use the median repetition
+    std::sort(times.begin(), times.end());
+    std::sort(allocations.begin(), allocations.end());
+    const qint64 time = qMax<qint64>(1, times.at(times.count() / 2));
+    const qint64 allocs = allocations.at(allocations.count() / 2);
+
+    BenchmarkResult result;
+    result.name = name;
+    result.corpus = corpus;
+    result.packets = packets;
+    result.bytes = bytes;
+    result.nsPerPacket = static_cast<double>(time) / qMax<qint64>(1, packets);
+    result.allocsPerPacket = static_cast<double>(allocs) /
+            qMax<qint64>(1, packets);
+    result.bytesPerSecond = bytes * 1e9 / time;
+    m_results.append(result);
+
+    fprintf(stderr, "  %-24s %-18s done\n", qPrintable(name),
+            qPrintable(corpus));
+}
+
+/**
+ * @returns the results of every benchmark that has been run
+ */
+const QVector<BenchmarkResult>& BenchmarkRunner::results() const {
+    return m_results;
+}
+
+/**
+ * Prints the results as a human-readable table
+ */
+void BenchmarkRunner::printTable() const {
+    printf("\n%-24s %-18s %12s %14s %12s\n", "Benchmark", "Corpus",
+           "ns/packet", "allocs/packet", "MB/s");
+    printf("%s\n", QByteArray(84, '-').constData());
+
+    foreach (const BenchmarkResult& r, m_results) {
+        printf("%-24s %-18s %12.1f %14.2f %12.1f\n",
+               qPrintable(r.name), qPrintable(r.corpus), r.nsPerPacket,
+               r.allocsPerPacket, r.bytesPerSecond / (1024 * 1024));
+    }
+
+    if (!MallocInterposed())
+        printf("\nNote: only C++ allocations are counted on this platform\n");
+}
+
+/**
+ * Prints the results as CSV, so that they can be compared between releases
+ */
+void BenchmarkRunner::printCsv() const {
+    printf("benchmark,corpus,packets,bytes,ns_per_packet,allocs_per_packet,"
+           "bytes_per_second\n");
+
+    foreach (const BenchmarkResult& r, m_results) {
+        printf("%s,%s,%lld,%lld,%.2f,%.3f,%.0f\n",
+               qPrintable(r.name), qPrintable(r.corpus),
+               static_cast<long long>(r.packets),
+               static_cast<long long>(r.bytes),
+               r.nsPerPacket, r.allocsPerPacket, r.bytesPerSecond);
+    }
+}
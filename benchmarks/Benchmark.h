@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief Result of a single benchmark
+ */
+struct BenchmarkResult {
+    QString name;
+    QString corpus;
+    qint64 packets;
+    qint64 bytes;
+    double nsPerPacket;
+    double allocsPerPacket;
+    double bytesPerSecond;
+};
+
+/**
+ * @brief Runs benchmarks and prints their results
+ *
+ * Every benchmark is run once to warm up caches and allocators, then it is
+ * repeated the given number of times, the median time and the allocations
+ * of the calling thread are reported per packet. The @c setup function is
+ * called before each repetition and is not measured.
+ */
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const int repetitions = 5);
+
+    void run(const QString& name,
+             const QString& corpus,
+             const qint64 packets,
+             const qint64 bytes,
+             const std::function<void()>& setup,
+             const std::function<void()>& body);
+
+    const QVector<BenchmarkResult>& results() const;
+
+    void printTable() const;
+    void printCsv() const;
+
+private:
+    int m_repetitions;
+    QVector<BenchmarkResult> m_results;
+};
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Constants.h"
+#include "PacketFramer.h"
+#include "PacketGenerator.h"
+
+#include "Corpus.h"
+
+/**
+ * Seed used for every corpus (changing it invalidates old results)
+ */
+static const quint32 CORPUS_SEED = 2019;
+
+/**
+ * @brief Generates a corpus with the given @a name and number of
+ *        @a packets, with or without @a faults, split with the given
+ *        @a chunking scheme
+ */
+Corpus Corpus::Create(const QString& name, const int packets,
+                      const bool faults, const Chunking chunking) {
+    Corpus corpus;
+    corpus.name = name;
+
+    // Generate the packets (100 ms between packets)
+    PacketGenerator generator;
+    generator.setSeed(CORPUS_SEED);
+    generator.setMissionStep(100);
+    if (faults) {
+        generator.setFaultProbability(PacketGenerator::kCorrupt, 0.05);
+        generator.setFaultProbability(PacketGenerator::kTruncate, 0.02);
+        generator.setFaultProbability(PacketGenerator::kDuplicate, 0.02);
+        generator.setFaultProbability(PacketGenerator::kDrop, 0.01);
+        generator.setFaultProbability(PacketGenerator::kReset, 0.001);
+    }
+
+    for (int i = 0; i < packets; ++i)
+        generator.generatePacket(corpus.stream);
+
+    // Split the stream in reads
+    quint32 random = CORPUS_SEED;
+    int remaining = corpus.stream.size();
+    while (remaining > 0) {
+        int size = 32;
+        if (chunking == kBursty) {
+            random = random * 1664525 + 1013904223;
+            size = 1 + static_cast<int>((random >> 8) % 4096);
+        }
+
+        size = qMin(size, remaining);
+        corpus.chunks.append(size);
+        remaining -= size;
+    }
+
+    // Extract the packets in the same way as the frame reader
+    QByteArray frame;
+    PacketFramer framer;
+    const char* data = corpus.stream.constData();
+    foreach (const int chunk, corpus.chunks) {
+        int written = 0;
+        while (written < chunk) {
+            written += framer.write(data + written, chunk - written);
+            while (framer.nextFrame(frame))
+                corpus.frames.append(frame.constData(), frame.size(), 0);
+        }
+
+        data += chunk;
+    }
+
+    return corpus;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+
+#include "FrameBatch.h"
+
+/**
+ * @brief Reproducible set of packets used by the benchmarks
+ *
+ * The packets are produced by the telemetry generator with a fixed seed,
+ * so that every build measures exactly the same data:
+ *
+ *     - @c valid: flight packets without faults
+ *     - @c corrupted: 5% corrupted, 2% truncated, 2% duplicated and 1%
+ *       lost packets, with occasional resets
+ *
+ * The byte @c stream is what the radio would deliver, @c frames contains
+ * the packets that the packet framer extracts from it, and @c chunks are
+ * the sizes of the reads used to feed the framer, either fixed 32-byte
+ * reads (a serial port at low baud rates) or random bursts of up to 4 KB
+ * (a network relay or a loaded machine).
+ */
+struct Corpus {
+    enum Chunking {
+        kSerial,
+        kBursty
+    };
+
+    QString name;
+    QByteArray stream;
+    FrameBatch frames;
+    QVector<int> chunks;
+
+    static Corpus Create(const QString& name, const int packets,
+                         const bool faults, const Chunking chunking);
+};
+
+#endif
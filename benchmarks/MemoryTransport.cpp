@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include "MemoryTransport.h"
+
+/**
+ * Constructor function
+ */
+MemoryTransport::MemoryTransport(QObject* parent) : Transport(parent),
+    m_open(false),
+    m_size(0),
+    m_data(Q_NULLPTR) {}
+
+/**
+ * @returns the name of the transport
+ */
+QString MemoryTransport::name() const {
+    return "memory:";
+}
+
+/**
+ * @returns @c true if the transport is open
+ */
+bool MemoryTransport::isOpen() const {
+    return m_open;
+}
+
+/**
+ * @returns an empty string, reading from memory cannot fail
+ */
+QString MemoryTransport::errorString() const {
+    return QString();
+}
+
+/**
+ * Opens the transport
+ */
+bool MemoryTransport::open() {
+    m_open = true;
+    return true;
+}
+
+/**
+ * Closes the transport and forgets the pending data
+ */
+void MemoryTransport::close() {
+    m_open = false;
+    m_size = 0;
+    m_data = Q_NULLPTR;
+}
+
+/**
+ * Copies up to @a maxSize bytes of the data given to @c deliver() into
+ * the given @a data buffer
+ */
+qint64 MemoryTransport::read(char* data, const qint64 maxSize) {
+    const int size = static_cast<int>(qMin<qint64>(maxSize, m_size));
+    if (size <= 0)
+        return 0;
+
+    memcpy(data, m_data, static_cast<size_t>(size));
+    m_data += size;
+    m_size -= size;
+    return size;
+}
+
+/**
+ * Makes the given @a size bytes of @a data available to the reader and
+ * notifies it
+ */
+void MemoryTransport::deliver(const char* data, const int size) {
+    if (!isOpen())
+        return;
+
+    m_data = data;
+    m_size = size;
+    emit readyRead();
+
+    m_data = Q_NULLPTR;
+    m_size = 0;
+}
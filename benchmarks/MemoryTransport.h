@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MEMORY_TRANSPORT_H
+#define MEMORY_TRANSPORT_H
+
+#include "Transport.h"
+
+/**
+ * @brief Transport that delivers data from memory, one read at a time
+ *
+ * Used by the benchmarks to drive a real @c FrameReader without a device:
+ * every call to @c deliver() emits @c readyRead(), and the reader consumes
+ * the given bytes before @c deliver() returns (the reader shall live in the
+ * calling thread). The data is not copied, it must stay valid until the
+ * call returns.
+ */
+class MemoryTransport : public Transport {
+    Q_OBJECT
+
+public:
+    explicit MemoryTransport(QObject* parent = Q_NULLPTR);
+
+    QString name() const override;
+    bool isOpen() const override;
+    QString errorString() const override;
+
+    bool open() override;
+    void close() override;
+    qint64 read(char* data, const qint64 maxSize) override;
+
+    void deliver(const char* data, const int size);
+
+private:
+    bool m_open;
+    int m_size;
+    const char* m_data;
+};
+
+#endif
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdio>
+
+#include <QTimer>
+#include <QEventLoop>
+#include <QUdpSocket>
+#include <QApplication>
+#include <QTemporaryDir>
+#include <QLoggingCategory>
+#include <QCommandLineParser>
+
+#include "crc32.h"
+#include "Corpus.h"
+#include "Baseline.h"
+#include "Benchmark.h"
+#include "Constants.h"
+#include "DataParser.h"
+#include "FrameReader.h"
+#include "SerialManager.h"
+#include "MemoryTransport.h"
+
+/**
+ * Number of packets delivered to the loggers at once
+ */
+static const int LOG_BATCH_SIZE = 64;
+
+/**
+ * Prevents the compiler from removing the benchmarked code
+ */
+static volatile quint64 SINK = 0;
+
+/**
+ * @brief Frames the corpus with @c FrameReader::onDataReceived()
+ *
+ * The corpus is delivered by a memory transport, one read per chunk, and
+ * the frame queue is drained after every read, in the same way as
+ * @c SerialManager::onFramesAvailable() does.
+ */
+static void BenchmarkFramer(BenchmarkRunner& runner, const Corpus& corpus) {
+    FrameQueue queue(FRAME_QUEUE_SIZE);
+    FrameReader reader(&queue);
+    MemoryTransport* transport = Q_NULLPTR;
+
+    runner.run("framer", corpus.name, corpus.frames.count(),
+               corpus.stream.size(),
+               [&]() {
+        transport = new MemoryTransport;
+        reader.open(transport);
+    },
+               [&]() {
+        const char* data = corpus.stream.constData();
+        foreach (const int chunk, corpus.chunks) {
+            transport->deliver(data, chunk);
+            data += chunk;
+
+            reader.acknowledgeFrames();
+            RawFrame* frame = queue.front();
+            while (frame != Q_NULLPTR) {
+                SINK += static_cast<quint64>(frame->size);
+                queue.pop();
+                frame = queue.front();
+            }
+        }
+    });
+}
+
+/**
+ * @brief Frames the corpus with the @c split() based framer that was used
+ *        before the packet framer
+ *
+ * Each chunk is copied into a new byte array, as @c QSerialPort::readAll()
+ * did, and every non-empty packet is handed to the consumer, so that the
+ * result can be compared with the @c framer benchmark.
+ */
+static void BenchmarkSplitFramer(BenchmarkRunner& runner,
+                                 const Corpus& corpus) {
+    SplitFramer framer;
+    runner.run("framer (split)", corpus.name, corpus.frames.count(),
+               corpus.stream.size(),
+               [&]() { framer.clear(); },
+               [&]() {
+        const char* data = corpus.stream.constData();
+        foreach (const int chunk, corpus.chunks) {
+            const QByteArray read(data, chunk);
+            foreach (const QByteArray& packet, framer.onDataReceived(read)) {
+                if (!packet.isEmpty())
+                    SINK += static_cast<quint64>(packet.size());
+            }
+
+            data += chunk;
+        }
+    });
+}
+
+/**
+ * Calculates the CRC-32 code of every packet of the corpus
+ */
+static void BenchmarkCrc(BenchmarkRunner& runner, const Corpus& corpus) {
+    const FrameBatch& frames = corpus.frames;
+    runner.run("crc32", corpus.name, frames.count(), frames.data().size(),
+               Q_NULLPTR,
+               [&]() {
+        quint32 crc = 0;
+        for (int i = 0; i < frames.count(); ++i)
+            crc ^= CRC32(frames.frameData(i),
+                         static_cast<size_t>(frames.frameSize(i)));
+
+        SINK += crc;
+    });
+}
+
+/**
+ * @brief Parses every packet of the corpus with @c DataParser::parseBatch()
+ *
+ * Publishing is suspended, so that only parsing, validation, sequence
+ * tracking, history and statistics are measured (and CSV logging, if
+ * @a csv is set to @c true).
+ */
+static void BenchmarkParser(BenchmarkRunner& runner, const Corpus& corpus,
+                            const bool csv) {
+    DataParser parser;
+    parser.enableCsvLogging(csv);
+    parser.setPublishingSuspended(true);
+
+    const FrameBatch& frames = corpus.frames;
+    runner.run(csv ? "parser+csv" : "parser", corpus.name, frames.count(),
+               frames.data().size(),
+               [&]() { parser.resetData(); },
+               [&]() {
+        parser.parseBatch(frames);
+        SINK += static_cast<quint64>(parser.successCount());
+    });
+}
+
+/**
+ * @brief Parses every packet of the corpus with the @c QString based
+ *        decoding that was used before the data parser worked on the
+ *        received bytes
+ *
+ * Compare it with the @c parser benchmark, which also does sequence
+ * tracking, history and statistics, so the difference understates the
+ * gain of parsing in place.
+ */
+static void BenchmarkQStringParser(BenchmarkRunner& runner,
+                                   const Corpus& corpus) {
+    QStringParser parser;
+
+    const FrameBatch& frames = corpus.frames;
+    runner.run("parser (QString)", corpus.name, frames.count(),
+               frames.data().size(),
+               [&]() { parser.clear(); },
+               [&]() {
+        QByteArray packet;
+        for (int i = 0; i < frames.count(); ++i) {
+            packet.setRawData(frames.frameData(i),
+                              static_cast<uint>(frames.frameSize(i)));
+            parser.parsePacket(packet);
+        }
+
+        SINK += static_cast<quint64>(parser.successCount());
+    });
+}
+
+/**
+ * @brief Connects the primary receiver of the serial manager to a free
+ *        local UDP port (nothing is sent to it), so that file logging
+ *        can be enabled
+ *
+ * @returns @c true if the receiver was connected within one second
+ */
+static bool ConnectLoopback(SerialManager* manager) {
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::LocalHost, 0))
+        return false;
+
+    const quint16 port = socket.localPort();
+    socket.close();
+
+    QEventLoop loop;
+    QTimer::singleShot(1000, &loop, &QEventLoop::quit);
+    QObject::connect(manager, &SerialManager::connectionChanged,
+                     &loop, &QEventLoop::quit);
+
+    manager->openSource(0, QString("udp://127.0.0.1:%1").arg(port));
+    if (!manager->connected())
+        loop.exec();
+
+    return manager->connected();
+}
+
+/**
+ * @brief Logs the corpus in batches with
+ *        @c SerialManager::formatReceivedBatch()
+ *
+ * Each batch is queued to the raw log and to the binary capture (both
+ * written by background threads), its latency is recorded and it is
+ * converted to text for the console.
+ */
+static void BenchmarkLoggers(BenchmarkRunner& runner, const Corpus& corpus) {
+    QVector<FrameBatch> batches;
+    const FrameBatch& frames = corpus.frames;
+    for (int i = 0; i < frames.count(); ++i) {
+        if (i % LOG_BATCH_SIZE == 0)
+            batches.append(FrameBatch());
+
+        batches.last().append(frames.frameData(i), frames.frameSize(i),
+                              MonotonicTime());
+    }
+
+    // File logging is only available while a device is connected
+    SerialManager* manager = SerialManager::getInstance();
+    if (!ConnectLoopback(manager)) {
+        fprintf(stderr, "  %-24s %-18s skipped (cannot bind a UDP port)\n",
+                "loggers", qPrintable(corpus.name));
+        return;
+    }
+
+    manager->enableFileLogging(true);
+    runner.run("loggers", corpus.name, frames.count(), frames.data().size(),
+               Q_NULLPTR,
+               [&]() {
+        foreach (const FrameBatch& batch, batches)
+            manager->formatReceivedBatch(batch);
+    });
+
+    manager->enableFileLogging(false);
+    manager->openSource(0, QString());
+}
+
+/**
+ * @brief Entry-point function of the benchmarks
+ *
+ * Results are printed as a table (or as CSV with @c --csv), so that they
+ * can be compared between releases.
+ */
+int main(int argc, char** argv) {
+    // Run without a display, and keep the files written by the benchmarks
+    // (e.g. CSV logs) away from the home directory of the user
+    QTemporaryDir home;
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    qputenv("HOME", home.path().toLocal8Bit());
+    qputenv("USERPROFILE", home.path().toLocal8Bit());
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("cansat-benchmarks");
+    QLoggingCategory::setFilterRules("default.info=false");
+
+    // Parse command line arguments
+    QCommandLineParser arguments;
+    arguments.addHelpOption();
+    const QCommandLineOption packets("packets", "Packets per corpus",
+                                     "count", "20000");
+    const QCommandLineOption repeat("repeat", "Repetitions per benchmark",
+                                    "count", "5");
+    const QCommandLineOption csv("csv", "Print the results as CSV");
+    arguments.addOptions({packets, repeat, csv});
+    arguments.process(app);
+
+    // Generate corpora
+    const int count = qMax(1, arguments.value(packets).toInt());
+    const Corpus valid = Corpus::Create("valid/serial", count, false,
+                                        Corpus::kSerial);
+    const Corpus bursty = Corpus::Create("valid/bursty", count, false,
+                                         Corpus::kBursty);
+    const Corpus corrupted = Corpus::Create("corrupted/bursty", count, true,
+                                            Corpus::kBursty);
+
+    // Run benchmarks
+    BenchmarkRunner runner(arguments.value(repeat).toInt());
+    BenchmarkFramer(runner, valid);
+    BenchmarkFramer(runner, bursty);
+    BenchmarkFramer(runner, corrupted);
+    BenchmarkSplitFramer(runner, valid);
+    BenchmarkSplitFramer(runner, bursty);
+    BenchmarkSplitFramer(runner, corrupted);
+    BenchmarkCrc(runner, valid);
+    BenchmarkParser(runner, valid, false);
+    BenchmarkParser(runner, corrupted, false);
+    BenchmarkQStringParser(runner, valid);
+    BenchmarkQStringParser(runner, corrupted);
+    BenchmarkParser(runner, valid, true);
+    BenchmarkLoggers(runner, valid);
+
+    // Print results
+    if (arguments.isSet(csv))
+        runner.printCsv();
+    else
+        runner.printTable();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QThread>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+
+#if defined(Q_OS_WIN)
+    #include <io.h>
+#elif defined(Q_OS_UNIX)
+    #include <unistd.h>
+#endif
+
+#include "Constants.h"
+#include "FrameBatch.h"
+#include "TraceWriter.h"
+#include "LatencyMonitor.h"
+#include "AsyncFileWriter.h"
+
+/**
+ * Size of the memory blocks used to accumulate data before writing it
+ */
+static const int BLOCK_SIZE = 64 * 1024;
+
+/**
+ * Commits the data written to the given @a file to the storage device
+ */
+static void SyncFile(QFile& file) {
+#if defined(Q_OS_WIN)
+    _commit(file.handle());
+#elif defined(Q_OS_UNIX)
+    fsync(file.handle());
+#else
+    Q_UNUSED(file);
+#endif
+}
+
+/**
+ * Thread that runs the write loop of an @c AsyncFileWriter
+ */
+class AsyncFileWriterThread : public QThread {
+public:
+    explicit AsyncFileWriterThread(AsyncFileWriter* writer) : m_writer(writer) {}
+
+protected:
+    void run() {
+        m_writer->writeLoop();
+    }
+
+private:
+    AsyncFileWriter* m_writer;
+};
+
+/**
+ * Constructor function, by default, data is written to the file every
+ * second (or as soon as 64 KB are pending) and the file is synchronized
+ * with the storage device when it is closed
+ */
+AsyncFileWriter::AsyncFileWriter(QObject* parent) : QObject(parent),
+    m_thread(Q_NULLPTR),
+    m_stop(false),
+    m_flushRequested(false),
+    m_flushInterval(1000),
+    m_maxBacklog(32 * 1024 * 1024),
+    m_flushThreshold(BLOCK_SIZE),
+    m_syncMode(kSyncOnClose),
+    m_latencyStage(-1),
+    m_backlog(0),
+    m_throughput(0),
+    m_bytesWritten(0),
+    m_droppedBytes(0)
+{
+    m_pending.reserve(BLOCK_SIZE);
+}
+
+/**
+ * Writes any pending data and closes the file
+ */
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+/**
+ * @returns @c true if the file is open
+ */
+bool AsyncFileWriter::isOpen() const {
+    return m_file.isOpen();
+}
+
+/**
+ * @returns the name of the current (or last) file
+ */
+QString AsyncFileWriter::fileName() const {
+    return m_file.fileName();
+}
+
+/**
+ * @returns the number of bytes that have not been written to the file yet
+ */
+qint64 AsyncFileWriter::backlog() const {
+    return m_backlog.load();
+}
+
+/**
+ * @returns the number of bytes written per second, measured over the last
+ *          statistics window (roughly one second)
+ */
+qint64 AsyncFileWriter::throughput() const {
+    return m_throughput.load();
+}
+
+/**
+ * @returns the number of bytes written since the file was opened
+ */
+qint64 AsyncFileWriter::bytesWritten() const {
+    return m_bytesWritten.load();
+}
+
+/**
+ * @returns the number of bytes that were discarded because the writer
+ *          thread could not keep up with the application (e.g. the disk
+ *          stalled and the backlog reached its limit)
+ */
+qint64 AsyncFileWriter::droppedBytes() const {
+    return m_droppedBytes.load();
+}
+
+/**
+ * @returns the maximum time (in milliseconds) that data can stay in memory
+ *          before being written to the file, 0 means no time limit
+ */
+int AsyncFileWriter::flushInterval() const {
+    QMutexLocker locker(&m_mutex);
+    return m_flushInterval;
+}
+
+/**
+ * @returns the amount of pending data that triggers a write
+ */
+qint64 AsyncFileWriter::flushThreshold() const {
+    QMutexLocker locker(&m_mutex);
+    return m_flushThreshold;
+}
+
+/**
+ * @returns the current sync mode
+ */
+AsyncFileWriter::SyncMode AsyncFileWriter::syncMode() const {
+    QMutexLocker locker(&m_mutex);
+    return m_syncMode;
+}
+
+/**
+ * @brief Opens the file with the given @a fileName and @a mode and starts
+ *        the writer thread
+ *
+ * @returns @c true on success
+ */
+bool AsyncFileWriter::open(const QString& fileName,
+                           const QIODevice::OpenMode mode) {
+    // Close current file
+    close();
+
+    // Open the file
+    m_file.setFileName(fileName);
+    if (!m_file.open(mode))
+        return false;
+
+    // Reset statistics
+    m_backlog.store(0);
+    m_throughput.store(0);
+    m_bytesWritten.store(0);
+    m_droppedBytes.store(0);
+
+    // Start the writer thread
+    m_stop = false;
+    m_flushRequested = false;
+    m_thread = new AsyncFileWriterThread(this);
+    m_thread->setObjectName("Writer " + QFileInfo(fileName).fileName());
+    m_thread->start(QThread::LowPriority);
+
+    emit statisticsChanged();
+    return true;
+}
+
+/**
+ * Queues the given @a data to be written to the file
+ */
+void AsyncFileWriter::write(const QByteArray& data) {
+    write(data.constData(), data.size());
+}
+
+/**
+ * Queues the packets of the given @a batch (and their reception
+ * timestamps) to be written to the file
+ */
+void AsyncFileWriter::write(const FrameBatch& batch) {
+    append(batch.data().constData(), batch.data().size(),
+           batch.timestamps().constData(), batch.timestamps().count());
+}
+
+/**
+ * Queues @a length bytes of the given @a data to be written to the file
+ */
+void AsyncFileWriter::write(const char* data, const int length) {
+    append(data, length, Q_NULLPTR, 0);
+}
+
+/**
+ * Queues @a length bytes of the given @a data, which belong to a packet
+ * received at the given @a timestamp, to be written to the file
+ */
+void AsyncFileWriter::write(const char* data, const int length,
+                            const qint64 timestamp) {
+    append(data, length, &timestamp, 1);
+}
+
+/**
+ * Appends @a length bytes of the given @a data to the pending block, the
+ * given @a count @a timestamps are only kept if a latency stage is set
+ */
+void AsyncFileWriter::append(const char* data, const int length,
+                             const qint64* timestamps, const int count) {
+    if (!m_thread || length <= 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    // Do not let the backlog grow without limits
+    if (m_backlog.load() + length > m_maxBacklog) {
+        m_droppedBytes.fetchAndAddRelaxed(length);
+        return;
+    }
+
+    // Append data to the pending block
+    m_pending.append(data, length);
+    m_backlog.fetchAndAddRelaxed(length);
+    if (m_latencyStage >= 0) {
+        for (int i = 0; i < count; ++i)
+            m_pendingTimestamps.append(timestamps[i]);
+    }
+
+    // Wake up the writer thread if we have enough data
+    if (m_pending.size() >= m_flushThreshold)
+        m_condition.wakeOne();
+}
+
+/**
+ * Asks the writer thread to write all pending data as soon as possible
+ */
+void AsyncFileWriter::flush() {
+    QMutexLocker locker(&m_mutex);
+    m_flushRequested = true;
+    m_condition.wakeOne();
+}
+
+/**
+ * Writes all pending data, stops the writer thread and closes the file
+ */
+void AsyncFileWriter::close() {
+    if (m_thread) {
+        m_mutex.lock();
+        m_stop = true;
+        m_condition.wakeOne();
+        m_mutex.unlock();
+
+        m_thread->wait();
+        delete m_thread;
+        m_thread = Q_NULLPTR;
+    }
+
+    if (m_file.isOpen()) {
+        m_file.close();
+        emit statisticsChanged();
+    }
+}
+
+/**
+ * Changes the sync @a mode of the writer
+ */
+void AsyncFileWriter::setSyncMode(const SyncMode mode) {
+    QMutexLocker locker(&m_mutex);
+    m_syncMode = mode;
+}
+
+/**
+ * Changes the maximum time (in milliseconds) that data can stay in memory
+ * before being written, use 0 to disable time-based writes
+ */
+void AsyncFileWriter::setFlushInterval(const int msecs) {
+    QMutexLocker locker(&m_mutex);
+    m_flushInterval = qMax(0, msecs);
+    m_condition.wakeOne();
+}
+
+/**
+ * Changes the amount of pending data (in bytes) that triggers a write
+ */
+void AsyncFileWriter::setFlushThreshold(const qint64 bytes) {
+    QMutexLocker locker(&m_mutex);
+    m_flushThreshold = qMax<qint64>(1, bytes);
+    m_condition.wakeOne();
+}
+
+/**
+ * @brief Records the latency of the written packets in the given
+ *        @c LatencyMonitor::Stage, use -1 to stop recording latencies
+ */
+void AsyncFileWriter::setLatencyStage(const int stage) {
+    // Create the monitor in the calling thread, not in the writer thread
+    if (stage >= 0)
+        LatencyMonitor::getInstance();
+
+    QMutexLocker locker(&m_mutex);
+    m_latencyStage = stage;
+}
+
+/**
+ * @brief Main function of the writer thread
+ *
+ * Waits until any of the flush conditions is met, then swaps the pending
+ * block with an empty block and writes it without holding the mutex, so
+ * that the application can keep queueing data while we write to the disk.
+ */
+void AsyncFileWriter::writeLoop() {
+    QByteArray block;
+    block.reserve(BLOCK_SIZE);
+    QVector<qint64> timestamps;
+
+    bool unsynced = false;
+    qint64 windowBytes = 0;
+    QElapsedTimer window;
+    window.start();
+
+    m_mutex.lock();
+    forever {
+        // Wait until a flush condition is met
+        if (!m_stop && !m_flushRequested &&
+                m_pending.size() < m_flushThreshold) {
+            if (m_flushInterval > 0)
+                m_condition.wait(&m_mutex,
+                                 static_cast<unsigned long>(m_flushInterval));
+            else
+                m_condition.wait(&m_mutex);
+        }
+
+        // Take pending data
+        const bool stop = m_stop;
+        const bool sync = (m_syncMode == kSyncOnFlush) ||
+                          (stop && m_syncMode == kSyncOnClose);
+        const int stage = m_latencyStage;
+        m_flushRequested = false;
+        block.swap(m_pending);
+        timestamps.swap(m_pendingTimestamps);
+        m_mutex.unlock();
+
+        // Write data to the file
+        if (!block.isEmpty()) {
+            TraceSpan span("file.write", block.size());
+            m_file.write(block);
+            m_file.flush();
+
+            windowBytes += block.size();
+            m_bytesWritten.fetchAndAddRelaxed(block.size());
+            m_backlog.fetchAndAddRelaxed(-block.size());
+            block.resize(0);
+            unsynced = true;
+        }
+
+        // Measure how long the packets took to reach the file
+        if (stage >= 0 && !timestamps.isEmpty()) {
+            const qint64 now = MonotonicTime();
+            LatencyMonitor* monitor = LatencyMonitor::getInstance();
+            foreach (const qint64 timestamp, timestamps)
+                monitor->record(static_cast<LatencyMonitor::Stage>(stage),
+                                timestamp, now);
+        }
+
+        timestamps.resize(0);
+
+        // Commit data to the storage device (only if something was written
+        // since the last sync, idle timeouts do not cost an fsync)
+        if (sync && unsynced) {
+            TraceSpan span("file.sync");
+            SyncFile(m_file);
+            unsynced = false;
+        }
+
+        // Update statistics (roughly every second)
+        if (window.elapsed() >= 1000 || stop) {
+            const qint64 elapsed = qMax<qint64>(1, window.restart());
+            m_throughput.store(windowBytes * 1000 / elapsed);
+            windowBytes = 0;
+            emit statisticsChanged();
+        }
+
+        // Exit loop when all data has been written
+        m_mutex.lock();
+        if (stop && m_pending.isEmpty())
+            break;
+    }
+
+    m_mutex.unlock();
+}
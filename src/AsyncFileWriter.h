@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <QFile>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+
+class QThread;
+class FrameBatch;
+
+/**
+ * @brief Writes data to a file from a background thread
+ *
+ * The file is kept open until @c close() is called. Calls to @c write() only
+ * copy the data into a memory block, which is written to the file by the
+ * writer thread when one of the following conditions is met:
+ *     - The flush interval (in milliseconds) has elapsed
+ *     - The amount of pending data reaches the flush threshold (in bytes)
+ *     - The application calls @c flush() or @c close()
+ *
+ * The sync mode controls if the data is also committed to the storage
+ * device (using @c fsync()) after each write or when the file is closed.
+ *
+ * If a latency stage is set, the reception timestamps of the packets given
+ * to @c write() are recorded in the @c LatencyMonitor once their data has
+ * been written to the file.
+ */
+class AsyncFileWriter : public QObject {
+    Q_OBJECT
+
+signals:
+    void statisticsChanged();
+
+public:
+    enum SyncMode {
+        kSyncNever,
+        kSyncOnClose,
+        kSyncOnFlush
+    };
+
+    explicit AsyncFileWriter(QObject* parent = Q_NULLPTR);
+    ~AsyncFileWriter();
+
+    bool isOpen() const;
+    QString fileName() const;
+
+    qint64 backlog() const;
+    qint64 throughput() const;
+    qint64 bytesWritten() const;
+    qint64 droppedBytes() const;
+
+    int flushInterval() const;
+    qint64 flushThreshold() const;
+    SyncMode syncMode() const;
+
+    bool open(const QString& fileName, const QIODevice::OpenMode mode);
+
+    void write(const QByteArray& data);
+    void write(const FrameBatch& batch);
+    void write(const char* data, const int length);
+    void write(const char* data, const int length, const qint64 timestamp);
+
+public slots:
+    void flush();
+    void close();
+    void setSyncMode(const SyncMode mode);
+    void setFlushInterval(const int msecs);
+    void setFlushThreshold(const qint64 bytes);
+    void setLatencyStage(const int stage);
+
+private:
+    void writeLoop();
+    void append(const char* data, const int length,
+                const qint64* timestamps, const int count);
+    friend class AsyncFileWriterThread;
+
+private:
+    QFile m_file;
+    QThread* m_thread;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+
+    bool m_stop;
+    bool m_flushRequested;
+    QByteArray m_pending;
+    QVector<qint64> m_pendingTimestamps;
+
+    int m_flushInterval;
+    qint64 m_maxBacklog;
+    qint64 m_flushThreshold;
+    SyncMode m_syncMode;
+    int m_latencyStage;
+
+    QAtomicInteger<qint64> m_backlog;
+    QAtomicInteger<qint64> m_throughput;
+    QAtomicInteger<qint64> m_bytesWritten;
+    QAtomicInteger<qint64> m_droppedBytes;
+};
+
+#endif
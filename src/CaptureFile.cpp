@@ -0,0 +1,600 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include <QDir>
+#include <QtEndian>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include "Constants.h"
+#include "FrameBatch.h"
+#include "CaptureFile.h"
+
+using namespace Capture;
+
+/**
+ * Magic numbers of the capture & index files
+ */
+static const char CAPTURE_MAGIC[] = "KSATCAP1";
+static const char INDEX_MAGIC[] = "KSATIDX1";
+
+/**
+ * Records longer than this are considered to be corrupted
+ */
+static const qint64 MAX_RECORD_SIZE = 16 * 1024 * 1024;
+
+/**
+ * Appends the given @a value to the @a buffer in little-endian order
+ */
+template <typename T>
+static void Put(QByteArray& buffer, const T value) {
+    uchar bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    buffer.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+/**
+ * Reads a little-endian value from the given @a data
+ */
+template <typename T>
+static T Get(const char* data) {
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(data));
+}
+
+/**
+ * Compares index entries by timestamp (used for binary searches)
+ */
+static bool TimestampLessThan(const qint64 timestamp, const IndexEntry& entry) {
+    return timestamp < entry.timestamp;
+}
+
+//------------------------------------------------------------------------------
+// Capture writer
+//------------------------------------------------------------------------------
+
+/**
+ * Constructor function, an index entry shall be written for every
+ * @a indexInterval packets
+ */
+CaptureWriter::CaptureWriter(const int indexInterval) :
+    m_indexInterval(qMax(1, indexInterval)),
+    m_origin(0),
+    m_offset(0),
+    m_frameCount(0),
+    m_lastTimestamp(0),
+    m_blockFrames(0)
+{
+    m_block.reserve(16 * 1024);
+    m_indexBlock.reserve(1024);
+}
+
+/**
+ * Writes any pending data and closes the capture
+ */
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+/**
+ * @returns @c true if the capture & index files are open
+ */
+bool CaptureWriter::isOpen() const {
+    return m_capture.isOpen() && m_index.isOpen();
+}
+
+/**
+ * @returns the number of packets written to the current capture
+ */
+qint64 CaptureWriter::frameCount() const {
+    return m_frameCount;
+}
+
+/**
+ * @returns the name of the current (or last) capture file
+ */
+QString CaptureWriter::fileName() const {
+    return m_capture.fileName();
+}
+
+/**
+ * @brief Creates a new capture file with the given @a fileName and its
+ *        index file (see @c indexFileName())
+ *
+ * Packet timestamps are stored relative to the moment in which this
+ * function is called.
+ *
+ * @returns @c true on success
+ */
+bool CaptureWriter::open(const QString& fileName) {
+    // Close current capture
+    close();
+
+    // Open the files
+    if (!m_capture.open(fileName, QFile::WriteOnly))
+        return false;
+    if (!m_index.open(indexFileName(fileName), QFile::WriteOnly)) {
+        m_capture.close();
+        return false;
+    }
+
+    // Reset state
+    m_origin = MonotonicTime();
+    m_offset = kHeaderSize;
+    m_frameCount = 0;
+    m_lastTimestamp = 0;
+
+    // Write capture header
+    QByteArray header(CAPTURE_MAGIC, 8);
+    Put<quint32>(header, kVersion);
+    Put<quint32>(header, 0);
+    Put<qint64>(header, QDateTime::currentMSecsSinceEpoch());
+    Put<quint32>(header, kHeaderSize);
+    Put<quint32>(header, 0);
+    m_capture.write(header);
+
+    // Write index header
+    QByteArray indexHeader(INDEX_MAGIC, 8);
+    Put<quint32>(indexHeader, kVersion);
+    Put<quint32>(indexHeader, static_cast<quint32>(m_indexInterval));
+    m_index.write(indexHeader);
+
+    return true;
+}
+
+/**
+ * Writes any pending data and closes the capture & index files
+ */
+void CaptureWriter::close() {
+    m_capture.close();
+    m_index.close();
+}
+
+/**
+ * Queues all the packets of the given @a batch to be written with a single
+ * call to each file writer
+ */
+void CaptureWriter::append(const FrameBatch& batch) {
+    if (!isOpen())
+        return;
+
+    for (int i = 0; i < batch.count(); ++i)
+        encode(batch.frameTimestamp(i), batch.frameData(i), batch.frameSize(i));
+
+    commit();
+}
+
+/**
+ * Queues a packet with the given @a data and @a length, which was received
+ * at the given monotonic @a timestamp (see @c MonotonicTime())
+ */
+void CaptureWriter::append(const qint64 timestamp, const char* data,
+                           const int length) {
+    if (!isOpen())
+        return;
+
+    encode(timestamp, data, length);
+    commit();
+}
+
+/**
+ * @returns the name of the index file of the given capture @a fileName
+ */
+QString CaptureWriter::indexFileName(const QString& fileName) {
+    QFileInfo info(fileName);
+    return info.dir().filePath(info.completeBaseName() + ".kidx");
+}
+
+/**
+ * Adds a packet record (and its index entry, if required) to the pending
+ * blocks
+ */
+void CaptureWriter::encode(const qint64 timestamp, const char* data,
+                           const int length) {
+    // Packets received before the capture was opened are stored at t = 0,
+    // the timestamps written to the file must never go backwards
+    const qint64 time = qMax(m_lastTimestamp, timestamp - m_origin);
+    const quint32 size = static_cast<quint32>(qMax(0, length));
+    const qint64 frame = m_frameCount + m_blockFrames;
+
+    // Register the record in the index every N packets
+    if (frame % m_indexInterval == 0) {
+        Put<qint64>(m_indexBlock, frame);
+        Put<qint64>(m_indexBlock, time);
+        Put<qint64>(m_indexBlock, m_offset + m_block.size());
+    }
+
+    // Add the record
+    Put<qint64>(m_block, time);
+    Put<quint32>(m_block, size);
+    m_block.append(data, static_cast<int>(size));
+
+    m_lastTimestamp = time;
+    ++m_blockFrames;
+}
+
+/**
+ * @brief Sends the pending blocks to the file writers
+ *
+ * If the capture writer drops the block (because the disk cannot keep up),
+ * its index entries are discarded as well, so that the index never points
+ * to records that do not exist.
+ */
+void CaptureWriter::commit() {
+    const qint64 dropped = m_capture.droppedBytes();
+    m_capture.write(m_block);
+
+    if (m_capture.droppedBytes() == dropped) {
+        m_index.write(m_indexBlock);
+        m_offset += m_block.size();
+        m_frameCount += m_blockFrames;
+    }
+
+    m_blockFrames = 0;
+    m_block.resize(0);
+    m_indexBlock.resize(0);
+}
+
+//------------------------------------------------------------------------------
+// Capture reader
+//------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+CaptureReader::CaptureReader() :
+    m_startTime(0),
+    m_frameCount(0),
+    m_currentFrame(0),
+    m_lastTimestamp(0),
+    m_indexInterval(kDefaultIndexInterval) {}
+
+/**
+ * Closes the capture file
+ */
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+/**
+ * @returns @c true if a capture file is open
+ */
+bool CaptureReader::isOpen() const {
+    return m_file.isOpen();
+}
+
+/**
+ * @returns @c true if all the packets of the capture have been read
+ */
+bool CaptureReader::atEnd() const {
+    return m_currentFrame >= m_frameCount;
+}
+
+/**
+ * @returns the local time at which the capture was started (in milliseconds
+ *          since epoch)
+ */
+qint64 CaptureReader::startTime() const {
+    return m_startTime;
+}
+
+/**
+ * @returns the number of complete packets stored in the capture
+ */
+qint64 CaptureReader::frameCount() const {
+    return m_frameCount;
+}
+
+/**
+ * @returns the number of the packet that will be read by @c readFrame()
+ */
+qint64 CaptureReader::currentFrame() const {
+    return m_currentFrame;
+}
+
+/**
+ * @returns the timestamp (in nanoseconds) of the last packet of the
+ *          capture, which is also the duration of the capture
+ */
+qint64 CaptureReader::lastTimestamp() const {
+    return m_lastTimestamp;
+}
+
+/**
+ * @brief Opens the capture file with the given @a fileName
+ *
+ * The index file is loaded if it exists, then, any packets not covered by
+ * the index are scanned, so that captures that were not closed correctly
+ * can also be read.
+ *
+ * @returns @c true on success
+ */
+bool CaptureReader::open(const QString& fileName) {
+    close();
+
+    // Open the capture file
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadOnly))
+        return false;
+
+    // Validate the header
+    const QByteArray header = m_file.read(kHeaderSize);
+    if (header.size() != kHeaderSize ||
+            memcmp(header.constData(), CAPTURE_MAGIC, 8) != 0 ||
+            Get<quint32>(header.constData() + 8) != kVersion) {
+        close();
+        return false;
+    }
+
+    // Get capture start time & header length
+    m_startTime = Get<qint64>(header.constData() + 16);
+    const qint64 headerSize = Get<quint32>(header.constData() + 24);
+    if (headerSize < kHeaderSize || headerSize > m_file.size()) {
+        close();
+        return false;
+    }
+
+    // The first record is always in the index
+    IndexEntry first;
+    first.frame = 0;
+    first.timestamp = 0;
+    first.offset = headerSize;
+
+    // Load the index and scan the rest of the capture
+    if (!readIndex(CaptureWriter::indexFileName(fileName))) {
+        m_index.clear();
+        m_index.append(first);
+    }
+
+    buildIndex();
+    return rewind();
+}
+
+/**
+ * Closes the capture file and releases the index
+ */
+void CaptureReader::close() {
+    m_file.close();
+    m_index.clear();
+    m_startTime = 0;
+    m_frameCount = 0;
+    m_currentFrame = 0;
+    m_lastTimestamp = 0;
+    m_indexInterval = kDefaultIndexInterval;
+}
+
+/**
+ * Moves to the first packet of the capture
+ */
+bool CaptureReader::rewind() {
+    if (!isOpen() || m_index.isEmpty())
+        return false;
+
+    return seekEntry(m_index.first());
+}
+
+/**
+ * Moves to the packet with the given @a frame number, the index is used to
+ * get close to the packet, so at most N records are skipped
+ */
+bool CaptureReader::seekFrame(const qint64 frame) {
+    if (!isOpen() || m_index.isEmpty() || frame < 0 || frame > m_frameCount)
+        return false;
+
+    // Entries are spaced uniformly, so we can compute the entry directly
+    const qint64 entry = qMin<qint64>(frame / m_indexInterval,
+                                      m_index.count() - 1);
+    if (!seekEntry(m_index.at(static_cast<int>(entry))))
+        return false;
+
+    // Skip records until we reach the packet
+    qint64 time, length;
+    while (m_currentFrame < frame) {
+        if (!readRecordHeader(time, length) || !m_file.seek(m_file.pos() + length))
+            return false;
+
+        ++m_currentFrame;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Moves to the first packet received at or after the given
+ *        @a timestamp (in nanoseconds since the start of the capture)
+ *
+ * A binary search over the index finds the last entry that is not newer
+ * than the requested time, then at most N records are scanned from there.
+ */
+bool CaptureReader::seekTimestamp(const qint64 timestamp) {
+    if (!isOpen() || m_index.isEmpty())
+        return false;
+
+    // Find the last entry with (entry.timestamp <= timestamp)
+    auto it = std::upper_bound(m_index.constBegin(), m_index.constEnd(),
+                               timestamp, TimestampLessThan);
+    if (it != m_index.constBegin())
+        --it;
+
+    if (!seekEntry(*it))
+        return false;
+
+    // Scan records until we find the first packet that is not older
+    qint64 time, length;
+    while (m_currentFrame < m_frameCount) {
+        const qint64 position = m_file.pos();
+        if (!readRecordHeader(time, length))
+            return false;
+
+        if (time >= timestamp)
+            return m_file.seek(position);
+
+        if (!m_file.seek(m_file.pos() + length))
+            return false;
+
+        ++m_currentFrame;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads the next packet of the capture
+ *
+ * @param timestamp reception time of the packet (in nanoseconds since the
+ *        start of the capture)
+ * @param data packet data
+ *
+ * @returns @c false if there are no more complete packets
+ */
+bool CaptureReader::readFrame(qint64& timestamp, QByteArray& data) {
+    if (!isOpen() || atEnd())
+        return false;
+
+    qint64 length;
+    if (!readRecordHeader(timestamp, length))
+        return false;
+
+    data.resize(static_cast<int>(length));
+    if (m_file.read(data.data(), length) != length)
+        return false;
+
+    ++m_currentFrame;
+    return true;
+}
+
+/**
+ * @brief Loads the index file with the given @a fileName
+ *
+ * Entries are validated (they must be ordered and point inside of the
+ * capture file), the index is truncated at the first invalid entry.
+ *
+ * @returns @c true if at least one valid entry was loaded
+ */
+bool CaptureReader::readIndex(const QString& fileName) {
+    m_index.clear();
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    // Validate the header
+    const QByteArray header = file.read(kIndexHeaderSize);
+    if (header.size() != kIndexHeaderSize ||
+            memcmp(header.constData(), INDEX_MAGIC, 8) != 0 ||
+            Get<quint32>(header.constData() + 8) != kVersion ||
+            Get<quint32>(header.constData() + 12) == 0)
+        return false;
+
+    m_indexInterval = static_cast<int>(Get<quint32>(header.constData() + 12));
+
+    // Read the entries
+    const QByteArray entries = file.readAll();
+    const int count = entries.size() / kIndexEntrySize;
+    m_index.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const char* data = entries.constData() + i * kIndexEntrySize;
+
+        IndexEntry entry;
+        entry.frame = Get<qint64>(data);
+        entry.timestamp = Get<qint64>(data + 8);
+        entry.offset = Get<qint64>(data + 16);
+
+        // Stop at the first entry that does not make sense
+        const qint64 expected = static_cast<qint64>(i) * m_indexInterval;
+        if (entry.frame != expected || entry.offset >= m_file.size())
+            break;
+        if (!m_index.isEmpty() && (entry.timestamp < m_index.last().timestamp ||
+                                   entry.offset <= m_index.last().offset))
+            break;
+
+        m_index.append(entry);
+    }
+
+    return !m_index.isEmpty();
+}
+
+/**
+ * @brief Scans the records after the last index entry
+ *
+ * This counts the packets of the capture, obtains the timestamp of the
+ * last packet and adds the index entries that were not written to the disk
+ * (e.g. because the application crashed). A truncated record at the end of
+ * the file is ignored.
+ */
+void CaptureReader::buildIndex() {
+    if (!seekEntry(m_index.last()))
+        return;
+
+    qint64 time, length;
+    qint64 frame = m_index.last().frame;
+    m_lastTimestamp = m_index.last().timestamp;
+
+    forever {
+        const qint64 position = m_file.pos();
+        if (!readRecordHeader(time, length))
+            break;
+        if (position + kRecordHeaderSize + length > m_file.size())
+            break;
+
+        // Add missing index entries
+        if (frame % m_indexInterval == 0 && frame > m_index.last().frame) {
+            IndexEntry entry;
+            entry.frame = frame;
+            entry.timestamp = time;
+            entry.offset = position;
+            m_index.append(entry);
+        }
+
+        m_file.seek(position + kRecordHeaderSize + length);
+        m_lastTimestamp = time;
+        ++frame;
+    }
+
+    m_frameCount = frame;
+}
+
+/**
+ * Moves to the record referenced by the given index @a entry
+ */
+bool CaptureReader::seekEntry(const IndexEntry& entry) {
+    if (!m_file.seek(entry.offset))
+        return false;
+
+    m_currentFrame = entry.frame;
+    return true;
+}
+
+/**
+ * Reads the header of the record at the current file position
+ */
+bool CaptureReader::readRecordHeader(qint64& timestamp, qint64& length) {
+    char header[kRecordHeaderSize];
+    if (m_file.read(header, kRecordHeaderSize) != kRecordHeaderSize)
+        return false;
+
+    timestamp = Get<qint64>(header);
+    length = Get<quint32>(header + 8);
+    return length <= MAX_RECORD_SIZE;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CAPTURE_FILE_H
+#define CAPTURE_FILE_H
+
+#include <QFile>
+#include <QVector>
+#include <QByteArray>
+
+#include "AsyncFileWriter.h"
+
+class FrameBatch;
+
+/**
+ * @brief Binary capture of the raw packets received from the CanSat
+ *
+ * A capture consists of two files, both use little-endian integers:
+ *
+ * The capture file (@c .kcap) starts with a 32-byte header:
+ *     - Magic (8 bytes, @c "KSATCAP1")
+ *     - Format version (@c u32) and reserved field (@c u32)
+ *     - Local time at which the capture started (@c i64, ms since epoch)
+ *     - Length of the capture header (@c u32) and reserved field (@c u32)
+ *
+ * The header is followed by one record per packet:
+ *     - Monotonic reception time relative to the start of the capture
+ *       (@c i64, nanoseconds)
+ *     - Length of the packet (@c u32)
+ *     - Packet data (without the EOT bytes)
+ *
+ * The index file (@c .kidx) starts with a 16-byte header (magic
+ * @c "KSATIDX1", format version and index interval) followed by one entry
+ * for every N-th packet: packet number (@c i64), timestamp (@c i64) and
+ * offset of the record in the capture file (@c i64). Since timestamps are
+ * monotonic, readers can find any mission time with a binary search over the
+ * index and read at most N records from there.
+ */
+namespace Capture {
+static const int kVersion = 1;
+static const int kHeaderSize = 32;
+static const int kRecordHeaderSize = 12;
+static const int kIndexHeaderSize = 16;
+static const int kIndexEntrySize = 24;
+static const int kDefaultIndexInterval = 64;
+
+struct IndexEntry {
+    qint64 frame;
+    qint64 timestamp;
+    qint64 offset;
+};
+}
+
+/**
+ * @brief Writes capture files from the background threads of two
+ *        @c AsyncFileWriter instances (capture & index)
+ */
+class CaptureWriter {
+public:
+    explicit CaptureWriter(const int indexInterval =
+                                    Capture::kDefaultIndexInterval);
+    ~CaptureWriter();
+
+    bool isOpen() const;
+    qint64 frameCount() const;
+    QString fileName() const;
+
+    bool open(const QString& fileName);
+    void close();
+
+    void append(const FrameBatch& batch);
+    void append(const qint64 timestamp, const char* data, const int length);
+
+    static QString indexFileName(const QString& fileName);
+
+private:
+    void encode(const qint64 timestamp, const char* data, const int length);
+    void commit();
+
+private:
+    int m_indexInterval;
+    qint64 m_origin;
+    qint64 m_offset;
+    qint64 m_frameCount;
+    qint64 m_lastTimestamp;
+
+    qint64 m_blockFrames;
+    QByteArray m_block;
+    QByteArray m_indexBlock;
+
+    AsyncFileWriter m_capture;
+    AsyncFileWriter m_index;
+};
+
+/**
+ * @brief Reads capture files and seeks to any point of the capture using
+ *        the sidecar index (the index is rebuilt in memory if it is missing
+ *        or incomplete, e.g. after a crash)
+ */
+class CaptureReader {
+public:
+    CaptureReader();
+    ~CaptureReader();
+
+    bool isOpen() const;
+    bool atEnd() const;
+    qint64 startTime() const;
+    qint64 frameCount() const;
+    qint64 currentFrame() const;
+    qint64 lastTimestamp() const;
+
+    bool open(const QString& fileName);
+    void close();
+
+    bool rewind();
+    bool seekFrame(const qint64 frame);
+    bool seekTimestamp(const qint64 timestamp);
+    bool readFrame(qint64& timestamp, QByteArray& data);
+
+private:
+    bool readIndex(const QString& fileName);
+    void buildIndex();
+    bool seekEntry(const Capture::IndexEntry& entry);
+    bool readRecordHeader(qint64& timestamp, qint64& length);
+
+private:
+    QFile m_file;
+    qint64 m_startTime;
+    qint64 m_frameCount;
+    qint64 m_currentFrame;
+    qint64 m_lastTimestamp;
+
+    int m_indexInterval;
+    QVector<Capture::IndexEntry> m_index;
+};
+
+#endif
@@ -28,6 +28,7 @@
 #include <QByteArray>
 
 #include <cmath>
+#include <chrono>
 
 /**
  * Defines what the last character of a packet generated by the
@@ -64,12 +65,35 @@ static const QByteArray HEADER_CODE = "KAANSATQRO";
  */
 static const int MAX_BUFFER_SIZE = 10 * 1024;
 
+/**
+ * Maximum length of a single packet, if more data is buffered without
+ * receiving an EOT byte, then we assume that the EOT byte was lost and
+ * re-synchronize with the stream using the @c HEADER_CODE
+ */
+static const int MAX_FRAME_SIZE = 512;
+
+/**
+ * Number of packets that can be waiting to be processed by the GUI thread
+ * before the serial I/O thread starts discarding them
+ */
+static const int FRAME_QUEUE_SIZE = 1024;
+
 /**
  * Packet validation options
  */
 static const bool ENABLE_CRC32 = false;
 static const bool ENABLE_PACKET_CHECK = true;
 
+/**
+ * Returns the time of a monotonic clock in nanoseconds, used to timestamp
+ * received packets (the clock is not affected by changes to the system time)
+ */
+static inline qint64 MonotonicTime() {
+    using namespace std::chrono;
+    const auto now = steady_clock::now().time_since_epoch();
+    return duration_cast<nanoseconds>(now).count();
+}
+
 /**
  * Rounds the given @a number to two decimal places
  */
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include <QLocale>
+
+#include "CsvWriter.h"
+
+/**
+ * Powers of ten that can be represented exactly by a double
+ */
+static const double EXACT_POWERS[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,
+    1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17
+};
+
+/**
+ * Maximum number of decimals tried by the fast formatting path
+ */
+static const int MAX_DECIMALS = 17;
+
+/**
+ * Largest integer that can be represented exactly by a double (2^53)
+ */
+static const double MAX_EXACT_MANTISSA = 9007199254740992.0;
+
+/**
+ * Size of the buffer needed to format any number
+ */
+static const int NUMBER_SIZE = 32;
+
+/**
+ * Constructor function, fields are separated by the given @a separator
+ */
+CsvWriter::CsvWriter(const char separator) :
+    m_separator(separator),
+    m_firstField(true)
+{
+    m_row.reserve(1024);
+    m_writer.setFlushInterval(1000);
+    m_writer.setFlushThreshold(64 * 1024);
+    m_writer.setSyncMode(AsyncFileWriter::kSyncOnClose);
+}
+
+/**
+ * Writes any pending row and closes the file
+ */
+CsvWriter::~CsvWriter() {
+    close();
+}
+
+/**
+ * @returns @c true if the file is open
+ */
+bool CsvWriter::isOpen() const {
+    return m_writer.isOpen();
+}
+
+/**
+ * @returns the name of the current (or last) file
+ */
+QString CsvWriter::fileName() const {
+    return m_writer.fileName();
+}
+
+/**
+ * @returns the background writer, which can be used to change the flush
+ *          thresholds or to read the I/O statistics
+ */
+AsyncFileWriter* CsvWriter::writer() {
+    return &m_writer;
+}
+
+/**
+ * Creates (or truncates) the file with the given @a fileName
+ *
+ * @returns @c true on success
+ */
+bool CsvWriter::open(const QString& fileName) {
+    m_row.resize(0);
+    m_firstField = true;
+    return m_writer.open(fileName, QFile::WriteOnly | QFile::Truncate);
+}
+
+/**
+ * Writes all pending rows and closes the file, an unfinished row is
+ * discarded
+ */
+void CsvWriter::close() {
+    m_row.resize(0);
+    m_firstField = true;
+    m_writer.close();
+}
+
+/**
+ * Asks the writer thread to write all pending rows as soon as possible
+ */
+void CsvWriter::flush() {
+    m_writer.flush();
+}
+
+/**
+ * Appends a signed integer field to the current row
+ */
+void CsvWriter::appendInt(const qint64 value) {
+    char buffer[NUMBER_SIZE];
+    int length = 0;
+    quint64 magnitude = static_cast<quint64>(value);
+    if (value < 0) {
+        buffer[length++] = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    length += FormatUInt(buffer + length, magnitude);
+    appendText(buffer, length);
+}
+
+/**
+ * Appends an unsigned integer field to the current row
+ */
+void CsvWriter::appendUInt(const quint64 value) {
+    char buffer[NUMBER_SIZE];
+    appendText(buffer, FormatUInt(buffer, value));
+}
+
+/**
+ * Appends a floating point field to the current row
+ */
+void CsvWriter::appendDouble(const double value) {
+    char buffer[NUMBER_SIZE];
+    appendText(buffer, FormatDouble(buffer, value));
+}
+
+/**
+ * Appends @a length characters of the given @a text as a field of the
+ * current row, the text is not quoted
+ */
+void CsvWriter::appendText(const char* text, const int length) {
+    separate();
+    m_row.append(text, length);
+}
+
+/**
+ * Appends the given @a text as a field of the current row
+ */
+void CsvWriter::appendText(const QByteArray& text) {
+    appendText(text.constData(), text.size());
+}
+
+/**
+ * Finishes the current row and queues it to the writer thread, the
+ * @a timestamp is the reception time of the packet of the row (if any)
+ */
+void CsvWriter::endRow(const qint64 timestamp) {
+    m_row.append('\n');
+    m_writer.write(m_row.constData(), m_row.size(), timestamp);
+
+    m_row.resize(0);
+    m_firstField = true;
+}
+
+/**
+ * Writes the decimal digits of the given @a value to the @a buffer, which
+ * must have space for at least 20 characters
+ *
+ * @returns the number of characters written
+ */
+int CsvWriter::FormatUInt(char* buffer, const quint64 value) {
+    char digits[NUMBER_SIZE];
+    int count = 0;
+    quint64 n = value;
+    do {
+        digits[count++] = static_cast<char>('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+
+    for (int i = 0; i < count; ++i)
+        buffer[i] = digits[count - 1 - i];
+
+    return count;
+}
+
+/**
+ * @brief Writes the shortest decimal representation of the given @a value
+ *        that converts back to the same value to the @a buffer, which must
+ *        have space for at least 32 characters
+ *
+ * Sensor readings have a few decimals, so we look for the smallest number
+ * of decimals (d) for which round(value * 10^d) / 10^d is equal to the
+ * value. Both numbers are represented exactly and the division is
+ * correctly rounded, so the result is what any correct parser (including
+ * @c ParseDouble()) returns for the formatted digits. Any other value
+ * (e.g. very large or very small numbers) is formatted by Qt.
+ *
+ * @returns the number of characters written
+ */
+int CsvWriter::FormatDouble(char* buffer, const double value) {
+    const double magnitude = std::fabs(value);
+    if (std::isfinite(value) && magnitude < MAX_EXACT_MANTISSA) {
+        for (int decimals = 0; decimals <= MAX_DECIMALS; ++decimals) {
+            const double power = EXACT_POWERS[decimals];
+            const double scaled = std::round(magnitude * power);
+            if (scaled >= MAX_EXACT_MANTISSA)
+                break;
+
+            if (scaled / power != magnitude)
+                continue;
+
+            // Write sign and digits
+            int length = 0;
+            if (std::signbit(value))
+                buffer[length++] = '-';
+
+            char digits[NUMBER_SIZE];
+            int count = FormatUInt(digits, static_cast<quint64>(scaled));
+
+            // Pad with zeros, so that there is at least one integer digit
+            const int padding = qMax(0, decimals + 1 - count);
+            memmove(digits + padding, digits, static_cast<size_t>(count));
+            memset(digits, '0', static_cast<size_t>(padding));
+            count += padding;
+
+            // Insert the decimal point
+            const int integers = count - decimals;
+            memcpy(buffer + length, digits, static_cast<size_t>(integers));
+            length += integers;
+            if (decimals > 0) {
+                buffer[length++] = '.';
+                memcpy(buffer + length, digits + integers,
+                       static_cast<size_t>(decimals));
+                length += decimals;
+            }
+
+            return length;
+        }
+    }
+
+    // Slow path (allocates memory)
+    const QByteArray text = QByteArray::number(value, 'g',
+                                               QLocale::FloatingPointShortest);
+    const int length = qMin(text.size(), NUMBER_SIZE);
+    memcpy(buffer, text.constData(), static_cast<size_t>(length));
+    return length;
+}
+
+/**
+ * Writes a separator if the current row already has a field
+ */
+void CsvWriter::separate() {
+    if (!m_firstField)
+        m_row.append(m_separator);
+
+    m_firstField = false;
+}
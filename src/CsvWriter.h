@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+#include <QString>
+#include <QByteArray>
+
+#include "AsyncFileWriter.h"
+
+/**
+ * @brief Formats CSV rows and writes them from a background thread
+ *
+ * Each row is formatted into a buffer that is re-used for every row, and
+ * then handed to an @c AsyncFileWriter with a single call, which writes the
+ * accumulated rows when 64 KB are pending or after one second, whichever
+ * happens first. Numbers are formatted without allocating memory and
+ * without depending on the system locale, floating point values are
+ * written with the shortest representation that converts back to the
+ * same value.
+ *
+ * Fields are separated automatically, call @c endRow() after the last
+ * field of each row.
+ */
+class CsvWriter {
+public:
+    explicit CsvWriter(const char separator = ',');
+    ~CsvWriter();
+
+    bool isOpen() const;
+    QString fileName() const;
+    AsyncFileWriter* writer();
+
+    bool open(const QString& fileName);
+    void close();
+    void flush();
+
+    void appendInt(const qint64 value);
+    void appendUInt(const quint64 value);
+    void appendDouble(const double value);
+    void appendText(const char* text, const int length);
+    void appendText(const QByteArray& text);
+    void endRow(const qint64 timestamp = 0);
+
+    static int FormatUInt(char* buffer, const quint64 value);
+    static int FormatDouble(char* buffer, const double value);
+
+private:
+    void separate();
+
+private:
+    char m_separator;
+    bool m_firstField;
+    QByteArray m_row;
+    AsyncFileWriter m_writer;
+};
+
+#endif
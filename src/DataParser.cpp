@@ -23,23 +23,243 @@
 #include "crc32.h"
 #include "Constants.h"
 #include "DataParser.h"
+#include "FrameBatch.h"
+#include "NumberParser.h"
+#include "TraceWriter.h"
 #include "SerialManager.h"
+#include "LatencyMonitor.h"
 
-#include <QMessageBox>
+#include <cstring>
+#include <climits>
+
+#include <QDebug>
+#include <QScreen>
+#include <QGuiApplication>
 #include <QDesktopServices>
 
 /**
- * Generates a vector of 0-value @c QVariant with @c x elements, where @c x
- * is the number of data/readings/status variables sent by the CanSat
+ * Number of data/readings/status variables sent by the CanSat (without
+ * the CRC-32 code)
+ */
+static const int PACKET_ITEMS = static_cast<int>(DataParser::kChecksumCode);
+
+/**
+ * Number of fields of a valid packet (including the CRC-32 code, if enabled)
+ */
+static const int PACKET_FIELDS = ENABLE_CRC32 ? PACKET_ITEMS + 1 : PACKET_ITEMS;
+
+/**
+ * Number of seconds between the UNIX and GPS epochs, we ignore leap seconds
+ * for now, we do not depend on that...
+ */
+static const quint64 GPS_EPOCH_OFFSET = 315964800;
+
+/**
+ * Maximum rate (in Hz) at which the user interface can be notified
+ */
+static const int MAX_PUBLISH_RATE = 240;
+
+/**
+ * @returns @c true if the given values are different once they are rounded
+ *          for the user interface (see @c RoundDbl())
+ */
+static inline bool Changed(const double a, const double b) {
+    return RoundDbl(a) != RoundDbl(b);
+}
+
+/**
+ * @returns @c true if the given vectors are different once they are
+ *          converted to @c QVector3D
+ */
+static inline bool Changed(const double* a, const double* b) {
+    for (int i = 0; i < 3; ++i) {
+        if (static_cast<float>(a[i]) != static_cast<float>(b[i]))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Range of bytes that contains a single field of a packet
+ */
+struct Field {
+    const char* begin;
+    const char* end;
+};
+
+/**
+ * @brief Finds the fields of the packet in [@a begin, @a end) without
+ *        copying any data
+ *
+ * At most @c PACKET_FIELDS fields are written to the @a fields array. If
+ * CRC-32 validation is enabled, the @a crc of the bytes that precede the
+ * checksum field (including the last separator) is calculated in the same
+ * pass, while each field is still in the CPU cache.
+ *
+ * @returns the number of fields in the packet, or @c PACKET_FIELDS + 1 if
+ *          the packet contains more fields than expected
  */
-static QVector<QVariant> EmptyDataPacket() {
-    QVector<QVariant> packet;
-    const int packetItems = static_cast<int>(DataParser::kChecksumCode);
+static int ScanPacket(const char* begin, const char* end, Field* fields,
+                      quint32& crc) {
+    int count = 0;
+    const char sep = DATA_SEPARATOR.toLatin1();
+
+    crc = 0;
+    forever {
+        const void* ptr = memchr(begin, sep, static_cast<size_t>(end - begin));
+        const char* next = ptr ? static_cast<const char*>(ptr) : end;
+
+        if (count == PACKET_FIELDS)
+            return PACKET_FIELDS + 1;
+
+        fields[count].begin = begin;
+        fields[count].end = next;
+        ++count;
+
+        if (next == end)
+            return count;
+
+        // Add field & separator to the CRC-32 code
+        if (ENABLE_CRC32 && count <= PACKET_ITEMS)
+            crc = CRC32_Update(crc, begin, static_cast<size_t>(next + 1 - begin));
+
+        begin = next + 1;
+    }
+}
+
+/**
+ * @returns @c true if the given @a field is equal to the @c HEADER_CODE
+ */
+static inline bool IsHeader(const Field& field) {
+    const int length = static_cast<int>(field.end - field.begin);
+    return length == HEADER_CODE.size() &&
+           memcmp(field.begin, HEADER_CODE.constData(),
+                  static_cast<size_t>(length)) == 0;
+}
+
+/**
+ * Field conversion functions, invalid or out-of-range values are converted
+ * to 0 (same as the @c QString conversion functions)
+ */
+static inline int ToInt(const Field& field) {
+    qint64 value;
+    ParseInt(field.begin, field.end, value);
+    return (value < INT_MIN || value > INT_MAX) ? 0 : static_cast<int>(value);
+}
+static inline quint32 ToUInt(const Field& field) {
+    quint64 value;
+    ParseUInt(field.begin, field.end, value);
+    return (value > UINT_MAX) ? 0 : static_cast<quint32>(value);
+}
+static inline quint64 ToULongLong(const Field& field) {
+    quint64 value;
+    ParseUInt(field.begin, field.end, value);
+    return value;
+}
+static inline double ToDouble(const Field& field) {
+    double value;
+    ParseDouble(field.begin, field.end, value);
+    return value;
+}
+
+/**
+ * @brief Checks the structure of the packet in [@a begin, @a begin +
+ *        @a size): secondary EOT code, number of fields, header code and
+ *        CRC-32 code (if enabled), the packet fields are written to the
+ *        given @a fields array
+ *
+ * @returns @c true if the packet is valid
+ */
+static bool ValidatePacket(const char* begin, const int size, Field* fields) {
+    quint32 crc;
+    int count;
+    const char* end = begin + size;
+    const char eot = EOT_SECONDARY.toLatin1();
+
+    //--------------------------------------------------------------------------
+    // Raw packet validation (so that we don't crash while reading data)
+    //--------------------------------------------------------------------------
+    if (ENABLE_PACKET_CHECK) {
+        // Packet does not end with secondary EOT code (primary EOT code was
+        // used to separate incoming packets
+        if (end == begin || end[-1] != eot)
+            return false;
+    }
+
+    // Remove secondary EOT character, we do not need it
+    if (end > begin && end[-1] == eot)
+        --end;
+
+    // Find packet fields (in place) and calculate the CRC-32 code in a
+    // single pass, then verify that the number of fields is valid
+    {
+        TraceSpan scan("scan+crc");
+        count = ScanPacket(begin, end, fields, crc);
+    }
+    if (count != PACKET_FIELDS)
+        return false;
+
+    // Packet does not begin with header code, abort
+    if (ENABLE_PACKET_CHECK && !IsHeader(fields[DataParser::kHeader]))
+        return false;
+
+    //--------------------------------------------------------------------------
+    // CRC-32 validation
+    //--------------------------------------------------------------------------
+    if (ENABLE_CRC32) {
+        // Compare remote and local CRC-32 codes
+        if (ToUInt(fields[DataParser::kChecksumCode]) != crc)
+            return false;
+    }
 
-    for (int i = 0; i < packetItems; ++i)
-        packet.append(QVariant(0));
+    return true;
+}
 
-    return packet;
+/**
+ * Appends the values of the given @a frame, received at the given
+ * @a timestamp, as a row of the @a csv writer, following the same order as
+ * @c DataParser::DataPosition
+ */
+static void AppendCsvRow(CsvWriter& csv, const TelemetryFrame& frame,
+                         const qint64 timestamp) {
+    const double values[] = {
+        frame.altitude,
+        frame.atmPressure,
+        frame.batteryVoltage,
+        frame.intTemperature,
+        frame.extTemperature,
+        frame.airQuality,
+        frame.carbonMonoxide
+    };
+
+    const double gps[] = {
+        frame.gpsLongitudeDeg,
+        frame.gpsLongitudeMin,
+        frame.gpsLatitudeDeg,
+        frame.gpsLatitudeMin,
+        frame.gpsAltitude
+    };
+
+    csv.appendText(HEADER_CODE);
+    csv.appendInt(frame.teamId);
+    csv.appendInt(frame.packetCount);
+    for (double value : values)
+        csv.appendDouble(value);
+
+    csv.appendUInt(frame.unixTime);
+    for (double value : gps)
+        csv.appendDouble(value);
+
+    csv.appendInt(frame.gpsSatelliteCount);
+    for (double value : frame.accelerometer)
+        csv.appendDouble(value);
+    for (double value : frame.magnetometer)
+        csv.appendDouble(value);
+
+    csv.appendUInt(frame.missionTime);
+    csv.appendInt(frame.parachute ? 1 : 0);
+    csv.endRow(timestamp);
 }
 
 /**
@@ -47,31 +267,52 @@ static QVector<QVariant> EmptyDataPacket() {
  * SIGNALS/SLOTS between the @c SerialManager class and data handling slots.
  */
 DataParser::DataParser() :
+    m_csv(DATA_SEPARATOR.toLatin1()),
     m_crc32(0),
     m_resetCount(0),
     m_errorCount(0),
     m_successCount(0),
-    m_data(EmptyDataPacket()),
-    m_csvLoggingEnabled (false)
+    m_csvLoggingEnabled (false),
+    m_databaseLoggingEnabled(false),
+    m_loggingSuspended(false),
+    m_publishRate(60),
+    m_publishSuspended(false),
+    m_publishedErrors(0),
+    m_publishedResets(0),
+    m_publishedSuccesses(0),
+    m_publishedFrame(TelemetryFrame()),
+    m_lastTimestamp(0),
+    m_frame(TelemetryFrame()),
+    m_gpsTimeStrValue(0)
 {
-    connect (SerialManager::getInstance(), &SerialManager::packetReceived,
-             this, &DataParser::parsePacket);
-    connect (this, &DataParser::dataParsed,
-             this, &DataParser::saveCsvData);
-    connect (this, &DataParser::dataParsed,
-             this, &DataParser::onPacketParsed);
-    connect (this, &DataParser::satelliteReset,
-             this, &DataParser::onSatelliteReset);
-    connect (this, &DataParser::packetError,
-             this, &DataParser::onPacketError);
+    updateGpsTime();
+
+    // Notify the user interface at the refresh rate of the screen
+    QScreen* screen = QGuiApplication::primaryScreen();
+    if (screen && screen->refreshRate() >= 1)
+        m_publishRate = qMin(qRound(screen->refreshRate()), MAX_PUBLISH_RATE);
+
+    // Measure when the packets reach the CSV file
+    m_csv.writer()->setLatencyStage(LatencyMonitor::kCsv);
+
+    m_publishClock.start();
+    m_publishTimer.setSingleShot(true);
+    m_publishTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_publishTimer, &QTimer::timeout,
+            this, &DataParser::publish);
+
+    connect (SerialManager::getInstance(), &SerialManager::packetsReceived,
+             this, &DataParser::parseBatch);
 }
 
 /**
  * Class destructor function, closes the CSV log file before quiting the app
  */
 DataParser::~DataParser() {
-    if (m_csvFile.isOpen())
-        m_csvFile.close();
+    if (m_sequence.received() > 0)
+        qInfo() << "Link quality:" << qPrintable(m_sequence.summary());
+
+    m_csv.close();
 }
 
 /**
@@ -95,11 +336,20 @@ int DataParser::successCount() const {
     return m_successCount;
 }
 
+/**
+ * @returns the maximum number of times per second that the user interface
+ *          is notified about new data, 0 means that the user interface is
+ *          notified after each group of received packets
+ */
+int DataParser::publishRate() const {
+    return m_publishRate;
+}
+
 /**
  * @returns the team ID number
  */
 int DataParser::teamId() const {
-    return m_data.at(kTeamID).toInt();
+    return m_frame.teamId;
 }
 
 /**
@@ -107,56 +357,56 @@ int DataParser::teamId() const {
  *          one or more packets where lost during transmission
  */
 int DataParser::packetCount() const {
-    return m_data.at(kPacketCount).toInt();
+    return m_frame.packetCount;
 }
 
 /**
  * @returns the mission time in milliseconds
  */
 quint64 DataParser::missionTime() const {
-    return m_data.at(kMisionTime).toUInt();
+    return m_frame.missionTime;
 }
 
 /**
  * @returns the altitude of the CanSat in meters
  */
 double DataParser::altitude() const {
-    return RoundDbl(m_data.at(kAltitude).toDouble());
+    return RoundDbl(m_frame.altitude);
 }
 
 /**
  * @returns the battery voltage of the CanSat
  */
 double DataParser::batteryVoltage() const {
-    return RoundDbl(m_data.at(kBatteryVoltage).toDouble());
+    return RoundDbl(m_frame.batteryVoltage);
 }
 
 /**
  * @returns the air quality readings of the CanSat
  */
 double DataParser::airQuality() const {
-    return RoundDbl(m_data.at(kAirQuality).toDouble());
+    return RoundDbl(m_frame.airQuality);
 }
 
 /**
  * @returns the carbon monoxide readings of the CanSat
  */
 double DataParser::carbonMonoxide() const {
-    return RoundDbl(m_data.at(kCarbonMonoxide).toDouble());
+    return RoundDbl(m_frame.carbonMonoxide);
 }
 
 /**
  * @returns the internal temperature of the CanSat in Kelvins
  */
 double DataParser::intTemperature() const {
-    return RoundDbl(m_data.at(kIntTemperature).toDouble());
+    return RoundDbl(m_frame.intTemperature);
 }
 
 /**
  * @returns the external temperature of the CanSat in Kelvins
  */
 double DataParser::extTemperature() const {
-    return RoundDbl(m_data.at(kExtTemperature).toDouble());
+    return RoundDbl(m_frame.extTemperature);
 }
 
 
@@ -164,53 +414,49 @@ double DataParser::extTemperature() const {
  * @returns the atmospheric pressure in millibars
  */
 double DataParser::atmosphericPressure() const {
-    return RoundDbl(m_data.at(kAtmPressure).toDouble());
+    return RoundDbl(m_frame.atmPressure);
 }
 
 /**
  * @returns the parachute deployment status
  */
 bool DataParser::parachuteStatus() const {
-    return m_data.at(kParachute).toInt() != 0;
+    return m_frame.parachute;
 }
 
 /**
  * @returns the date/time received by the GPS module of the CanSat
  */
 QString DataParser::gpsTime() const {
-    QDateTime time;
-    time.setTime_t (m_data.at(kGpsTime).toUInt());
-    return time.toString("yyyy/MM/dd hh:mm:ss");
+    return m_gpsTimeStr;
 }
 
 /**
  * @returns the calculated altitude based on GPS readings
  */
 double DataParser::gpsAltitude() const {
-    return RoundDbl(m_data.at(kGpsAltitude).toDouble());
+    return RoundDbl(m_frame.gpsAltitude);
 }
 
 /**
  * @returns the calculated latitude based on GPS readings
  */
 double DataParser::gpsLatitude() const {
-    return RoundDbl(m_data.at(kGpsLatitudeDeg).toDouble() +
-                    m_data.at(kGpsLatitudeMin).toDouble() / 60.0);
+    return RoundDbl(m_frame.latitude);
 }
 
 /**
  * @returns the calculated longitude based on GPS readings
  */
 double DataParser::gpsLongitude() const {
-    return RoundDbl(m_data.at(kGpsLongitudeDeg).toDouble() +
-                    m_data.at(kGpsLongitudeMin).toDouble() / 60.0);
+    return RoundDbl(m_frame.longitude);
 }
 
 /**
  * @returns the number of satellites detected by the GPS receiver
  */
 int DataParser::gpsSatelliteCount() const {
-    return m_data.at(kGpsSatelliteCount).toInt();
+    return m_frame.gpsSatelliteCount;
 }
 
 /**
@@ -218,22 +464,18 @@ int DataParser::gpsSatelliteCount() const {
  *          sensor
  */
 QVector3D DataParser::magnetomerData() const {
-    QVector3D vector;
-    vector.setX(m_data.at(kMagnetometerX).toFloat());
-    vector.setY(m_data.at(kMagnetometerY).toFloat());
-    vector.setZ(m_data.at(kMagnetometerZ).toFloat());
-    return vector;
+    return QVector3D(static_cast<float>(m_frame.magnetometer[0]),
+                     static_cast<float>(m_frame.magnetometer[1]),
+                     static_cast<float>(m_frame.magnetometer[2]));
 }
 
 /**
  * @returns a vector with the (x,y,z) accelerometer readings
  */
 QVector3D DataParser::accelerometerData() const {
-    QVector3D vector;
-    vector.setX(m_data.at(kAccelerometerX).toFloat());
-    vector.setY(m_data.at(kAccelerometerY).toFloat());
-    vector.setZ(m_data.at(kAccelerometerZ).toFloat());
-    return vector;
+    return QVector3D(static_cast<float>(m_frame.accelerometer[0]),
+                     static_cast<float>(m_frame.accelerometer[1]),
+                     static_cast<float>(m_frame.accelerometer[2]));
 }
 
 /**
@@ -241,7 +483,7 @@ QVector3D DataParser::accelerometerData() const {
  */
 quint32 DataParser::checksum() const {
     if (ENABLE_CRC32)
-        return m_data.at(kChecksumCode).toUInt();
+        return m_frame.checksum;
     else
         return -1;
 }
@@ -254,6 +496,147 @@ bool DataParser::csvLoggingEnabled() const {
     return m_csvLoggingEnabled;
 }
 
+/**
+ * @returns @c true if the class shall store all received data in the
+ *          SQLite database
+ */
+bool DataParser::databaseLoggingEnabled() const {
+    return m_databaseLoggingEnabled;
+}
+
+/**
+ * @returns @c true if CSV and database logging are suspended (see
+ *          @c setLoggingSuspended())
+ */
+bool DataParser::loggingSuspended() const {
+    return m_loggingSuspended;
+}
+
+/**
+ * @returns @c true if the notifications to the user interface are
+ *          suspended (see @c setPublishingSuspended())
+ */
+bool DataParser::publishingSuspended() const {
+    return m_publishSuspended;
+}
+
+/**
+ * @returns the decoded contents of the last valid packet
+ */
+const TelemetryFrame& DataParser::frame() const {
+    return m_frame;
+}
+
+/**
+ * @returns the history of all the valid packets received during the
+ *          current session
+ */
+TelemetryHistory* DataParser::history() {
+    return &m_history;
+}
+
+/**
+ * @returns the running statistics of each channel, computed over the
+ *          current session and over a sliding window
+ */
+TelemetryStatistics* DataParser::statistics() {
+    return &m_statistics;
+}
+
+/**
+ * @returns the packet loss, duplicate and re-order counters of the current
+ *          session
+ */
+SequenceTracker* DataParser::sequence() {
+    return &m_sequence;
+}
+
+/**
+ * @returns the numeric value of the field at the given @a position (see
+ *          @c DataPosition) of the given @a frame, or 0 if the field does
+ *          not have a numeric value
+ */
+double DataParser::frameValue(const TelemetryFrame& frame, const int position) {
+    switch (position) {
+    case kTeamID:
+        return frame.teamId;
+    case kPacketCount:
+        return frame.packetCount;
+    case kAltitude:
+        return frame.altitude;
+    case kAtmPressure:
+        return frame.atmPressure;
+    case kBatteryVoltage:
+        return frame.batteryVoltage;
+    case kIntTemperature:
+        return frame.intTemperature;
+    case kExtTemperature:
+        return frame.extTemperature;
+    case kAirQuality:
+        return frame.airQuality;
+    case kCarbonMonoxide:
+        return frame.carbonMonoxide;
+    case kGpsTime:
+        return static_cast<double>(frame.unixTime);
+    case kGpsLongitudeDeg:
+        return frame.gpsLongitudeDeg;
+    case kGpsLongitudeMin:
+        return frame.gpsLongitudeMin;
+    case kGpsLatitudeDeg:
+        return frame.gpsLatitudeDeg;
+    case kGpsLatitudeMin:
+        return frame.gpsLatitudeMin;
+    case kGpsAltitude:
+        return frame.gpsAltitude;
+    case kGpsSatelliteCount:
+        return frame.gpsSatelliteCount;
+    case kAccelerometerX:
+        return frame.accelerometer[0];
+    case kAccelerometerY:
+        return frame.accelerometer[1];
+    case kAccelerometerZ:
+        return frame.accelerometer[2];
+    case kMagnetometerX:
+        return frame.magnetometer[0];
+    case kMagnetometerY:
+        return frame.magnetometer[1];
+    case kMagnetometerZ:
+        return frame.magnetometer[2];
+    case kMisionTime:
+        return frame.missionTime;
+    case kParachute:
+        return frame.parachute ? 1 : 0;
+    case kChecksumCode:
+        return frame.checksum;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Checks the structure of the given packet (see @c parsePacket())
+ *        without decoding it, and finds its @a packetCount and
+ *        @a missionTime, which identify the packet
+ *
+ * This is used to avoid discarding a valid copy of a packet in favour of
+ * a damaged copy received by another radio.
+ *
+ * @returns @c true if the packet is valid
+ */
+bool DataParser::CheckPacket(const char* data, const int size,
+                             quint64& packetCount, quint64& missionTime) {
+    Field fields[PACKET_FIELDS];
+    packetCount = 0;
+    missionTime = 0;
+    if (!ValidatePacket(data, size, fields))
+        return false;
+
+    return ParseUInt(fields[kPacketCount].begin, fields[kPacketCount].end,
+                     packetCount) &&
+           ParseUInt(fields[kMisionTime].begin, fields[kMisionTime].end,
+                     missionTime);
+}
+
 /**
  * Resets all the internal variables to their initial state
  */
@@ -262,8 +645,23 @@ void DataParser::resetData() {
     m_errorCount = 0;
     m_resetCount = 0;
     m_successCount = 0;
-    m_data = EmptyDataPacket();
+    m_frame = TelemetryFrame();
+    m_history.clear();
+    m_statistics.clear();
+    updateGpsTime();
+
+    if (m_sequence.received() > 0)
+        qInfo() << "Link quality:" << qPrintable(m_sequence.summary());
+
+    m_sequence.clear();
 
+    m_publishTimer.stop();
+    m_publishedErrors = 0;
+    m_publishedResets = 0;
+    m_publishedSuccesses = 0;
+    m_publishClock.restart();
+
+    notifyChanges(true);
     emit dataParsed();
     emit packetError();
     emit satelliteReset();
@@ -274,7 +672,25 @@ void DataParser::resetData() {
  */
 void DataParser::openCsvFile() {
     if (csvLoggingEnabled())
-        QDesktopServices::openUrl(QUrl::fromLocalFile(m_csvFile.fileName()));
+        QDesktopServices::openUrl(QUrl::fromLocalFile(m_csv.fileName()));
+}
+
+/**
+ * Changes the maximum number of times per second that the user interface
+ * is notified about new data, use 0 to disable rate limiting
+ */
+void DataParser::setPublishRate(const int rate) {
+    const int value = qBound(0, rate, MAX_PUBLISH_RATE);
+    if (m_publishRate != value) {
+        m_publishRate = value;
+        emit publishRateChanged();
+
+        // Apply the new rate to any pending notification
+        if (m_publishTimer.isActive()) {
+            m_publishTimer.stop();
+            schedulePublish();
+        }
+    }
 }
 
 /**
@@ -288,198 +704,253 @@ void DataParser::openCsvFile() {
 void DataParser::enableCsvLogging(const bool enabled) {
     m_csvLoggingEnabled = enabled;
 
-    if (!csvLoggingEnabled() && m_csvFile.isOpen())
-        m_csvFile.close();
+    if (!csvLoggingEnabled())
+        m_csv.close();
 
     emit csvLoggingEnabledChanged();
 }
 
 /**
- * @brief validates and decodes the given data @a packet and updates all
- *        internal variables that relate to the sensor readings, mission
- *        data and CanSat status
+ * @brief Enables or disables database logging
+ *
+ * If database logging is enabled, then all the packets that have been
+ * received and interpreted (successfully) will be stored in a new table
+ * of an SQLite database on the home directory of the user, which can be
+ * queried during and after the mission.
  */
-void DataParser::parsePacket(const QByteArray& packet) {
-    // Define 'global' function variables
-    QStringList data;
+void DataParser::enableDatabaseLogging(const bool enabled) {
+    m_databaseLoggingEnabled = enabled;
 
-    //--------------------------------------------------------------------------
-    // Raw packet validation (so that we don't crash while reading data)
-    //--------------------------------------------------------------------------
-    if (ENABLE_PACKET_CHECK) {
-        // Packet is empty, abort
-        if (packet.isEmpty()) {
-            emit packetError();
-            return;
-        }
-
-        // Packet does not begin with header code, abort
-        if (!packet.startsWith(HEADER_CODE)) {
-            emit packetError();
-            return;
-        }
-
-        // Packet does not end with secondary EOT code (primary EOT code was
-        // used to separate incoming packets
-        if (!packet.endsWith(EOT_SECONDARY.toLatin1())) {
-            emit packetError();
-            return;
-        }
+    if (!databaseLoggingEnabled())
+        m_database.close();
 
-        // Ok, we can now begin analyzing the packet, start by making a copy
-        // of the packet so that we can manipulate it
-        QString copy = packet;
+    emit databaseLoggingEnabledChanged();
+}
 
-        // Remove secondary EOT character, we do not need it
-        copy.chop(1);
+/**
+ * @brief Suspends or resumes CSV and database logging
+ *
+ * While logging is suspended, packets are parsed, added to the history and
+ * statistics and published as usual, but they are not written to the CSV
+ * file or to the database. This is used by the replay engine, so that
+ * recorded data is not mixed with the data of the current session.
+ */
+void DataParser::setLoggingSuspended(const bool suspended) {
+    m_loggingSuspended = suspended;
+}
 
-        // Split packet data and verify that its length is valid
-        data = copy.split(",");
-        if (data.count() != EmptyDataPacket().count()) {
-            emit packetError();
-            return;
-        }
-    }
+/**
+ * @brief Suspends or resumes the notifications to the user interface
+ *
+ * While publishing is suspended, packets are parsed, logged and added to
+ * the history and statistics as usual, but no signal is emitted. This is
+ * used to process large amounts of recorded data at once (e.g. to jump
+ * to the end of a capture), the user interface is updated with the final
+ * state as soon as publishing is resumed.
+ */
+void DataParser::setPublishingSuspended(const bool suspended) {
+    if (m_publishSuspended == suspended)
+        return;
 
-    //--------------------------------------------------------------------------
-    // CRC-32 validation
-    //--------------------------------------------------------------------------
-    if (ENABLE_CRC32) {
-        // Re-construct packet without CRC32 code
-        QString rp;
-        for (int i = 0; i < EmptyDataPacket().size(); ++i) {
-            if (i != kChecksumCode) {
-                rp.append(data.at(i));
-                rp.append(DATA_SEPARATOR);
-            }
-        }
+    m_publishSuspended = suspended;
+    if (suspended)
+        m_publishTimer.stop();
+    else
+        publish();
+}
 
-        // Calculate CRC-32 from reconstructed packet
-        const size_t buffer_size = static_cast<size_t>(rp.size());
-        const void* buffer = static_cast<const void*>(rp.toStdString().c_str());
-        quint32 localCrc32 = CRC32(buffer, buffer_size);
+/**
+ * @brief Notifies the user interface about the newest data
+ *
+ * The @c dataParsed(), @c packetError() and @c satelliteReset() signals are
+ * only emitted if the respective counters changed since the last call, and
+ * the change signal of each property is only emitted if its value changed.
+ */
+void DataParser::publish() {
+    m_publishClock.restart();
 
-        // Compare remote and local CRC-32 codes
-        quint32 remoteCrc32 = data.at(kChecksumCode).toUInt();
-        if (localCrc32 != remoteCrc32) {
-            emit packetError();
-            return;
-        }
+    if (errorCount() != m_publishedErrors) {
+        m_publishedErrors = errorCount();
+        emit packetError();
     }
 
-    //--------------------------------------------------------------------------
-    // Data handling
-    //--------------------------------------------------------------------------
-    {
-        // Init. packet information vector
-        QVector<QVariant> info = EmptyDataPacket();
-
-        // Add UNIX/GPS offset in seconds, ignore leap seconds for now,
-        // We do not depend on that...
-        quint64 unixTime = data.at(kGpsTime).toULongLong() + 315964800;
-
-        // Extract information to packet vector
-        info.insert(kHeader,
-                    QVariant(data.at(kHeader)));
-        info.insert(kTeamID,
-                    QVariant(data.at(kTeamID).toInt()));
-        info.insert(kPacketCount,
-                    QVariant(data.at(kPacketCount).toInt()));
-        info.insert(kMisionTime,
-                    QVariant(data.at(kMisionTime).toUInt()));
-        info.insert(kAltitude,
-                    QVariant(data.at(kAltitude).toDouble()));
-        info.insert(kBatteryVoltage,
-                    QVariant(data.at(kBatteryVoltage).toDouble()));
-        info.insert(kIntTemperature,
-                    QVariant(data.at(kIntTemperature).toDouble()));
-        info.insert(kExtTemperature,
-                    QVariant(data.at(kExtTemperature).toDouble()));
-        info.insert(kAirQuality,
-                    QVariant(data.at(kAirQuality).toDouble()));
-        info.insert(kCarbonMonoxide,
-                    QVariant(data.at(kCarbonMonoxide).toDouble()));
-        info.insert(kAtmPressure,
-                    QVariant(data.at(kAtmPressure).toDouble()));
-        info.insert(kGpsTime, QVariant(unixTime));
-        info.insert(kGpsAltitude,
-                    QVariant(data.at(kGpsAltitude).toDouble()));
-        info.insert(kGpsLatitudeMin,
-                    QVariant(data.at(kGpsLatitudeMin).toDouble()));
-        info.insert(kGpsLongitudeMin,
-                    QVariant(data.at(kGpsLongitudeMin).toDouble()));
-        info.insert(kGpsLatitudeDeg,
-                    QVariant(data.at(kGpsLatitudeDeg).toDouble()));
-        info.insert(kGpsLongitudeDeg,
-                    QVariant(data.at(kGpsLongitudeDeg).toDouble()));
-        info.insert(kGpsSatelliteCount,
-                    QVariant(data.at(kGpsSatelliteCount)));
-        info.insert(kAccelerometerX,
-                    QVariant(data.at(kAccelerometerX).toDouble()));
-        info.insert(kAccelerometerY,
-                    QVariant(data.at(kAccelerometerY).toDouble()));
-        info.insert(kAccelerometerZ,
-                    QVariant(data.at(kAccelerometerZ).toDouble()));
-        info.insert(kMagnetometerX,
-                    QVariant(data.at(kMagnetometerX).toDouble()));
-        info.insert(kMagnetometerY,
-                    QVariant(data.at(kMagnetometerY).toDouble()));
-        info.insert(kMagnetometerZ,
-                    QVariant(data.at(kMagnetometerZ).toDouble()));
-        info.insert(kParachute,
-                    QVariant(data.at(kParachute)).toInt());
-        if (ENABLE_CRC32)
-            info.insert(kChecksumCode,
-                        QVariant(data.at(kChecksumCode).toUInt()));
-
-        // If current packet mision time is less than last packet, then a
-        // a satellite reset ocurred
-        if (missionTime() >= info.at(kMisionTime).toUInt())
-            emit satelliteReset();
-
-        // If received packet ID is smaller than the last packet ID, then a
-        // satellite reset has ocurred.
-        else if (packetCount() >= info.at(kPacketCount).toInt())
-            emit satelliteReset();
+    if (resetCount() != m_publishedResets) {
+        m_publishedResets = resetCount();
+        emit satelliteReset();
+    }
 
-        // Update current packet
-        m_data = info;
+    if (successCount() != m_publishedSuccesses) {
+        m_publishedSuccesses = successCount();
+        LatencyMonitor::getInstance()->markPublished(m_lastTimestamp);
+        notifyChanges(false);
+        m_history.notify();
+        m_statistics.notify();
+        m_sequence.notify();
         emit dataParsed();
     }
 }
 
 /**
- * Increments the number of packet reading errors
+ * @brief Notifies the user interface as soon as the publish rate allows it
+ *
+ * If the last notification is older than the publish interval, the user
+ * interface is notified immediately (so that isolated packets are shown
+ * without delay), otherwise, a single notification is scheduled for the end
+ * of the interval, and all packets received in the meantime are coalesced.
  */
-void DataParser::onPacketError() {
-    ++m_errorCount;
+void DataParser::schedulePublish() {
+    // Notification already scheduled (or suspended)
+    if (m_publishSuspended || m_publishTimer.isActive())
+        return;
+
+    // Rate limiting disabled
+    if (publishRate() <= 0) {
+        publish();
+        return;
+    }
+
+    // Notify now or at the end of the current interval
+    const qint64 interval = 1000 / publishRate();
+    const qint64 elapsed = m_publishClock.elapsed();
+    if (elapsed >= interval)
+        publish();
+    else
+        m_publishTimer.start(static_cast<int>(interval - elapsed));
 }
 
 /**
- * Increments the number of packet reading successes
+ * @brief Parses every packet of the given @a batch
+ *
+ * Every packet is validated, counted and written to the CSV file as soon
+ * as it is received, but the user interface is notified at most
+ * @c publishRate() times per second, so that bursts of packets only cause
+ * a single update of the QML bindings with the newest data.
  */
-void DataParser::onPacketParsed() {
-    ++m_successCount;
+void DataParser::parseBatch(const FrameBatch& batch) {
+    // Parse each packet separately, re-use the same byte array to avoid
+    // allocating memory for each packet
+    QByteArray packet;
+    LatencyMonitor* monitor = LatencyMonitor::getInstance();
+    for (int i = 0; i < batch.count(); ++i) {
+        packet.setRawData(batch.frameData(i),
+                          static_cast<uint>(batch.frameSize(i)));
+        if (!parsePacket(packet, batch.frameTimestamp(i)))
+            continue;
+
+        // Measure the latency of live data (not while seeking)
+        m_lastTimestamp = batch.frameTimestamp(i);
+        if (!m_publishSuspended)
+            monitor->record(LatencyMonitor::kParse, m_lastTimestamp,
+                            MonotonicTime());
+    }
+
+    // Notify the rest of the application
+    schedulePublish();
 }
 
 /**
- * Increments the number of resets
+ * @brief validates and decodes the given data @a packet and updates all
+ *        internal variables that relate to the sensor readings, mission
+ *        data and CanSat status
+ *
+ * The @a timestamp is the reception time of the packet.
+ *
+ * @returns @c true if the packet is valid
  */
-void DataParser::onSatelliteReset() {
-    ++m_resetCount;
+bool DataParser::parsePacket(const QByteArray& packet,
+                             const qint64 timestamp) {
+    TraceSpan span("parse");
+    Field data[PACKET_FIELDS];
+    if (!ValidatePacket(packet.constData(), packet.size(), data)) {
+        ++m_errorCount;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Data handling
+    //--------------------------------------------------------------------------
+    {
+        // Decode the packet into a new frame
+        TelemetryFrame frame;
+        frame.teamId = ToInt(data[kTeamID]);
+        frame.packetCount = ToInt(data[kPacketCount]);
+        frame.altitude = ToDouble(data[kAltitude]);
+        frame.atmPressure = ToDouble(data[kAtmPressure]);
+        frame.batteryVoltage = ToDouble(data[kBatteryVoltage]);
+        frame.intTemperature = ToDouble(data[kIntTemperature]);
+        frame.extTemperature = ToDouble(data[kExtTemperature]);
+        frame.airQuality = ToDouble(data[kAirQuality]);
+        frame.carbonMonoxide = ToDouble(data[kCarbonMonoxide]);
+        frame.gpsTime = ToULongLong(data[kGpsTime]);
+        frame.gpsLongitudeDeg = ToDouble(data[kGpsLongitudeDeg]);
+        frame.gpsLongitudeMin = ToDouble(data[kGpsLongitudeMin]);
+        frame.gpsLatitudeDeg = ToDouble(data[kGpsLatitudeDeg]);
+        frame.gpsLatitudeMin = ToDouble(data[kGpsLatitudeMin]);
+        frame.gpsAltitude = ToDouble(data[kGpsAltitude]);
+        frame.gpsSatelliteCount = ToInt(data[kGpsSatelliteCount]);
+        frame.accelerometer[0] = ToDouble(data[kAccelerometerX]);
+        frame.accelerometer[1] = ToDouble(data[kAccelerometerY]);
+        frame.accelerometer[2] = ToDouble(data[kAccelerometerZ]);
+        frame.magnetometer[0] = ToDouble(data[kMagnetometerX]);
+        frame.magnetometer[1] = ToDouble(data[kMagnetometerY]);
+        frame.magnetometer[2] = ToDouble(data[kMagnetometerZ]);
+        frame.missionTime = ToUInt(data[kMisionTime]);
+        frame.parachute = ToInt(data[kParachute]) != 0;
+        frame.checksum = ENABLE_CRC32 ? ToUInt(data[kChecksumCode]) : 0;
+
+        // Compute derived values only once
+        frame.unixTime = frame.gpsTime + GPS_EPOCH_OFFSET;
+        frame.latitude = frame.gpsLatitudeDeg + frame.gpsLatitudeMin / 60.0;
+        frame.longitude = frame.gpsLongitudeDeg + frame.gpsLongitudeMin / 60.0;
+
+        // Classify the packet by its packet count and mission time
+        ++m_successCount;
+        const SequenceTracker::Result result =
+                m_sequence.track(frame.packetCount, frame.missionTime);
+
+        // Discard duplicated packets
+        if (result == SequenceTracker::kDuplicate)
+            return true;
+
+        // Save packet to CSV file and database
+        saveCsvData(frame, timestamp);
+        saveDatabaseData(frame);
+
+        // Late packets are logged, but do not replace newer data
+        if (result == SequenceTracker::kLate)
+            return true;
+
+        // Packet count or mission time restarted
+        if (result == SequenceTracker::kReset) {
+            ++m_resetCount;
+            qInfo() << "Satellite reset at packet" << frame.packetCount
+                    << "-" << qPrintable(m_sequence.summary());
+        }
+
+        // Update current packet
+        m_frame = frame;
+        m_history.append(frame);
+        m_statistics.append(frame, m_history.lastTime());
+        updateGpsTime();
+    }
+
+    return true;
 }
 
 /**
  * @brief If the CSV logging feature is enabled, then this function
- *        shall save all the data extracted from the current packet
- *        to the CSV table.
+ *        shall save all the data extracted from the given @a frame
+ *        (received at the given @a timestamp) to the CSV table.
  * @note If the CSV table file does not exist or is empty, then this
  *       function shall also write the header titles to the CSV file
  */
-void DataParser::saveCsvData() {
-    if (csvLoggingEnabled()) {
+void DataParser::saveCsvData(const TelemetryFrame& frame,
+                             const qint64 timestamp) {
+    if (csvLoggingEnabled() && !loggingSuspended()) {
+        TraceSpan span("csv.write");
+
         // Open CSV file
-        if (!m_csvFile.isOpen()) {
+        if (!m_csv.isOpen()) {
             // Get file name and path
             QString format = QDateTime::currentDateTime().toString("yyyy/MMM/dd/");
             QString fileName = QDateTime::currentDateTime().toString("HH-mm-ss") + ".csv";
@@ -495,44 +966,122 @@ void DataParser::saveCsvData() {
                 dir.mkpath(".");
 
             // Open file
-            m_csvFile.setFileName(dir.filePath(fileName));
-            if (!m_csvFile.open(QFile::WriteOnly)) {
-                QMessageBox::critical(NULL,
-                                      tr("CSV File Error"),
-                                      tr("Cannot open CSV file for writing!"),
-                                      QMessageBox::Ok);
+            // Do not block the packet path with a dialog if the file cannot
+            // be opened, disable CSV logging instead
+            if (!m_csv.open(dir.filePath(fileName))) {
+                qWarning() << "Cannot open" << dir.filePath(fileName)
+                           << "for writing, CSV logging disabled";
+                enableCsvLogging(false);
                 return;
             }
 
             // Add CSV data headers
-            for (int i = 0; i < EmptyDataPacket().length(); ++i) {
-                // Convert enum value to QString and write it to current cell
-                m_csvFile.write(QMetaEnum::fromType<DataPosition>().valueToKey(i));
-
-                // Go to the next column
-                if (i < EmptyDataPacket().length() - 1)
-                    m_csvFile.write(",");
-
-                // Create a new row
-                else
-                    m_csvFile.write("\n");
-            }
+            const QMetaEnum positions = QMetaEnum::fromType<DataPosition>();
+            for (int i = 0; i < PACKET_ITEMS; ++i)
+                m_csv.appendText(positions.valueToKey(i));
 
+            m_csv.endRow();
         }
 
-        // Write current data to CSV file
-        for (int i = 0; i < EmptyDataPacket().length(); ++i) {
-            // Write UTF8 data to current cell
-            m_csvFile.write(m_data.at(i).toByteArray());
+        // Queue current data to the CSV writer thread
+        AppendCsvRow(m_csv, frame, timestamp);
+    }
+}
 
-            // Go to next column
-            if (i < EmptyDataPacket().length() - 1)
-                m_csvFile.write(",");
+/**
+ * @brief If the database logging feature is enabled, then this function
+ *        queues the given @a frame to be stored in the session table
+ * @note The database (and the session table) is created when the first
+ *       frame is stored, if it cannot be opened, database logging is
+ *       disabled
+ */
+void DataParser::saveDatabaseData(const TelemetryFrame& frame) {
+    if (databaseLoggingEnabled() && !loggingSuspended()) {
+        // Open database
+        if (!m_database.isOpen()) {
+            QDir dir(QString("%1/%2").arg(QDir::homePath(),
+                                          qApp->applicationName()));
+            if (!dir.exists())
+                dir.mkpath(".");
 
-            // Create a new row
-            else
-                m_csvFile.write("\n");
+            const QString device = SerialManager::getInstance()->deviceName();
+            if (!m_database.open(dir.filePath("Telemetry.sqlite"), device)) {
+                qWarning() << "Telemetry database disabled";
+                enableDatabaseLogging(false);
+                return;
+            }
         }
+
+        // Queue frame to the database writer thread
+        m_database.append(frame);
     }
 }
 
+/**
+ * Updates the GPS date/time string, the string is only generated again when
+ * the GPS time changes (once per second at most) instead of every time that
+ * the user interface reads it
+ */
+void DataParser::updateGpsTime() {
+    if (m_gpsTimeStr.isEmpty() || m_gpsTimeStrValue != m_frame.unixTime) {
+        QDateTime time;
+        time.setTime_t(static_cast<uint>(m_frame.unixTime));
+        m_gpsTimeStr = time.toString("yyyy/MM/dd hh:mm:ss");
+        m_gpsTimeStrValue = m_frame.unixTime;
+    }
+}
+
+/**
+ * @brief Compares the current frame with the last frame that was shown to
+ *        the user interface and emits the change signals of the properties
+ *        whose values are different (or of all properties if @a force is
+ *        set to @c true)
+ *
+ * Values are compared as they are shown to the user, so that QML bindings
+ * are not evaluated again if the value that they display did not change.
+ */
+void DataParser::notifyChanges(const bool force) {
+    TraceSpan span("notify");
+    const TelemetryFrame& o = m_publishedFrame;
+    const TelemetryFrame& n = m_frame;
+
+    if (force || o.teamId != n.teamId)
+        emit teamIdChanged();
+    if (force || o.packetCount != n.packetCount)
+        emit packetCountChanged();
+    if (force || o.missionTime != n.missionTime)
+        emit missionTimeChanged();
+    if (force || Changed(o.altitude, n.altitude))
+        emit altitudeChanged();
+    if (force || Changed(o.batteryVoltage, n.batteryVoltage))
+        emit voltageChanged();
+    if (force || Changed(o.intTemperature, n.intTemperature))
+        emit intTemperatureChanged();
+    if (force || Changed(o.extTemperature, n.extTemperature))
+        emit extTemperatureChanged();
+    if (force || Changed(o.atmPressure, n.atmPressure))
+        emit atmosphericPressureChanged();
+    if (force || Changed(o.airQuality, n.airQuality))
+        emit airQualityChanged();
+    if (force || Changed(o.carbonMonoxide, n.carbonMonoxide))
+        emit carbonMonoxideChanged();
+    if (force || o.unixTime != n.unixTime)
+        emit gpsTimeChanged();
+    if (force || Changed(o.gpsAltitude, n.gpsAltitude))
+        emit gpsAltitudeChanged();
+    if (force || Changed(o.latitude, n.latitude))
+        emit gpsLatitudeChanged();
+    if (force || Changed(o.longitude, n.longitude))
+        emit gpsLongitudeChanged();
+    if (force || o.gpsSatelliteCount != n.gpsSatelliteCount)
+        emit gpsSatelliteCountChanged();
+    if (force || o.parachute != n.parachute)
+        emit parachuteStatusChanged();
+    if (force || o.checksum != n.checksum)
+        emit checksumChanged();
+    if (force || Changed(o.accelerometer, n.accelerometer) ||
+            Changed(o.magnetometer, n.magnetometer))
+        emit vectorsChanged();
+
+    m_publishedFrame = m_frame;
+}
@@ -23,79 +23,92 @@
 #ifndef DATA_PARSER_H
 #define DATA_PARSER_H
 
-#include <QList>
-#include <QFile>
-#include <QVector>
+#include <QTimer>
 #include <QObject>
-#include <QVariant>
+#include <QElapsedTimer>
 #include <QVector3D>
 #include <QDateTime>
 
+#ifdef QT_QML_LIB
+#include <QtQml>
+#endif
+
 #include "Constants.h"
+#include "CsvWriter.h"
+#include "TelemetryFrame.h"
+#include "SequenceTracker.h"
+#include "TelemetryDatabase.h"
+#include "TelemetryHistory.h"
+#include "TelemetryStatistics.h"
 
+class FrameBatch;
 class DataParser : public QObject {
     Q_OBJECT
     Q_PROPERTY(int teamId
                READ teamId
-               NOTIFY dataParsed)
+               NOTIFY teamIdChanged)
     Q_PROPERTY(int packetCount
                READ packetCount
-               NOTIFY dataParsed)
+               NOTIFY packetCountChanged)
     Q_PROPERTY(quint64 missionTime
                READ missionTime
-               NOTIFY dataParsed)
+               NOTIFY missionTimeChanged)
     Q_PROPERTY(double altitude
                READ altitude
-               NOTIFY dataParsed)
+               NOTIFY altitudeChanged)
     Q_PROPERTY(double voltage
                READ batteryVoltage
-               NOTIFY dataParsed)
+               NOTIFY voltageChanged)
     Q_PROPERTY(double intTemperature
                READ intTemperature
-               NOTIFY dataParsed)
+               NOTIFY intTemperatureChanged)
     Q_PROPERTY(double extTemperature
                READ extTemperature
-               NOTIFY dataParsed)
+               NOTIFY extTemperatureChanged)
     Q_PROPERTY(double atmosphericPressure
                READ atmosphericPressure
-               NOTIFY dataParsed)
+               NOTIFY atmosphericPressureChanged)
     Q_PROPERTY(QString gpsTime
                READ gpsTime
-               NOTIFY dataParsed)
+               NOTIFY gpsTimeChanged)
     Q_PROPERTY(double gpsAltitude
                READ gpsAltitude
-               NOTIFY dataParsed)
+               NOTIFY gpsAltitudeChanged)
     Q_PROPERTY(double gpsLongitude
                READ gpsLongitude
-               NOTIFY dataParsed)
+               NOTIFY gpsLongitudeChanged)
     Q_PROPERTY(double gpsLatitude
                READ gpsLatitude
-               NOTIFY dataParsed)
+               NOTIFY gpsLatitudeChanged)
     Q_PROPERTY(int gpsSatelliteCount
                READ gpsSatelliteCount
-               NOTIFY dataParsed)
+               NOTIFY gpsSatelliteCountChanged)
     Q_PROPERTY(QVector3D magnetometer
                READ magnetomerData
-               NOTIFY dataParsed)
+               NOTIFY vectorsChanged)
     Q_PROPERTY(QVector3D accelerometer
                READ accelerometerData
-               NOTIFY dataParsed)
+               NOTIFY vectorsChanged)
     Q_PROPERTY(bool parachuteStatus
                READ parachuteStatus
-               NOTIFY dataParsed)
+               NOTIFY parachuteStatusChanged)
     Q_PROPERTY(double airQuality
                READ airQuality
-               NOTIFY dataParsed)
+               NOTIFY airQualityChanged)
     Q_PROPERTY(double carbonMonoxide
                READ carbonMonoxide
-               NOTIFY dataParsed)
+               NOTIFY carbonMonoxideChanged)
     Q_PROPERTY(quint32 checksum
                READ checksum
-               NOTIFY dataParsed)
+               NOTIFY checksumChanged)
     Q_PROPERTY(bool csvLoggingEnabled
                READ csvLoggingEnabled
                WRITE enableCsvLogging
                NOTIFY csvLoggingEnabledChanged)
+    Q_PROPERTY(bool databaseLoggingEnabled
+               READ databaseLoggingEnabled
+               WRITE enableDatabaseLogging
+               NOTIFY databaseLoggingEnabledChanged)
     Q_PROPERTY(int errorCount
                READ errorCount
                NOTIFY packetError)
@@ -105,6 +118,19 @@ class DataParser : public QObject {
     Q_PROPERTY(int successCount
                READ successCount
                NOTIFY dataParsed)
+    Q_PROPERTY(TelemetryHistory* history
+               READ history
+               CONSTANT)
+    Q_PROPERTY(TelemetryStatistics* statistics
+               READ statistics
+               CONSTANT)
+    Q_PROPERTY(SequenceTracker* sequence
+               READ sequence
+               CONSTANT)
+    Q_PROPERTY(int publishRate
+               READ publishRate
+               WRITE setPublishRate
+               NOTIFY publishRateChanged)
 
 public:
     enum DataPosition {
@@ -141,15 +167,55 @@ signals:
     void dataParsed();
     void packetError();
     void satelliteReset();
+
+    void teamIdChanged();
+    void packetCountChanged();
+    void missionTimeChanged();
+    void altitudeChanged();
+    void voltageChanged();
+    void intTemperatureChanged();
+    void extTemperatureChanged();
+    void atmosphericPressureChanged();
+    void airQualityChanged();
+    void carbonMonoxideChanged();
+    void gpsTimeChanged();
+    void gpsAltitudeChanged();
+    void gpsLatitudeChanged();
+    void gpsLongitudeChanged();
+    void gpsSatelliteCountChanged();
+    void parachuteStatusChanged();
+    void checksumChanged();
+    void vectorsChanged();
+
+    void publishRateChanged();
     void csvLoggingEnabledChanged();
+    void databaseLoggingEnabledChanged();
 
 public:
     DataParser();
     ~DataParser();
 
+    static void DeclareQML()
+    {
+#ifdef QT_QML_LIB
+        qmlRegisterUncreatableType<DataParser>("KaanSat", 1, 0, "DataParser",
+                                               "Use CDataParser instead");
+        qmlRegisterUncreatableType<TelemetryHistory>("KaanSat", 1, 0,
+                                                     "TelemetryHistory",
+                                                     "Use CDataParser.history");
+        qmlRegisterUncreatableType<TelemetryStatistics>("KaanSat", 1, 0,
+                                                        "TelemetryStatistics",
+                                                        "Use CDataParser.statistics");
+        qmlRegisterUncreatableType<SequenceTracker>("KaanSat", 1, 0,
+                                                    "SequenceTracker",
+                                                    "Use CDataParser.sequence");
+#endif
+    }
+
     int resetCount() const;
     int errorCount() const;
     int successCount() const;
+    int publishRate() const;
 
     int teamId() const;
     int packetCount() const;
@@ -176,27 +242,67 @@ public:
 
     quint32 checksum() const;
     bool csvLoggingEnabled() const;
+    bool databaseLoggingEnabled() const;
+    bool loggingSuspended() const;
+    bool publishingSuspended() const;
+
+    const TelemetryFrame& frame() const;
+    TelemetryHistory* history();
+    TelemetryStatistics* statistics();
+    SequenceTracker* sequence();
+
+    static double frameValue(const TelemetryFrame& frame, const int position);
+    static bool CheckPacket(const char* data, const int size,
+                            quint64& packetCount, quint64& missionTime);
 
 public slots:
     void resetData();
     void openCsvFile();
+    void setPublishRate(const int rate);
     void enableCsvLogging(const bool enabled);
+    void enableDatabaseLogging(const bool enabled);
+    void parseBatch(const FrameBatch& batch);
+    void setLoggingSuspended(const bool suspended);
+    void setPublishingSuspended(const bool suspended);
 
 private slots:
-    void saveCsvData();
-    void onPacketError();
-    void onPacketParsed();
-    void onSatelliteReset();
-    void parsePacket(const QByteArray &data);
+    void publish();
+    void schedulePublish();
 
 private:
-    QFile m_csvFile;
+    void saveCsvData(const TelemetryFrame& frame, const qint64 timestamp);
+    void saveDatabaseData(const TelemetryFrame& frame);
+    void updateGpsTime();
+    void notifyChanges(const bool force);
+    bool parsePacket(const QByteArray& packet, const qint64 timestamp);
+
+private:
+    CsvWriter m_csv;
     quint32 m_crc32;
     int m_resetCount;
     int m_errorCount;
     int m_successCount;
-    QVector<QVariant> m_data;
     bool m_csvLoggingEnabled;
+    bool m_databaseLoggingEnabled;
+    bool m_loggingSuspended;
+    TelemetryDatabase m_database;
+
+    int m_publishRate;
+    bool m_publishSuspended;
+    int m_publishedErrors;
+    int m_publishedResets;
+    int m_publishedSuccesses;
+    TelemetryFrame m_publishedFrame;
+    qint64 m_lastTimestamp;
+    QTimer m_publishTimer;
+    QElapsedTimer m_publishClock;
+
+    TelemetryFrame m_frame;
+    TelemetryHistory m_history;
+    TelemetryStatistics m_statistics;
+    SequenceTracker m_sequence;
+    QString m_gpsTimeStr;
+    quint64 m_gpsTimeStrValue;
 };
 
 #endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "DescriptorTransport.h"
+
+#ifdef Q_OS_UNIX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+
+/**
+ * Creates a (closed) transport for the pseudo-terminal at the given
+ * @a path, or for the standard input if @a path is empty
+ */
+DescriptorTransport::DescriptorTransport(const QString& path,
+                                         QObject* parent) :
+    Transport(parent),
+    m_fd(-1),
+    m_path(path),
+    m_notifier(Q_NULLPTR) {}
+
+/**
+ * Closes the descriptor
+ */
+DescriptorTransport::~DescriptorTransport() {
+    close();
+}
+
+/**
+ * @returns the name of the terminal or "stdin"
+ */
+QString DescriptorTransport::name() const {
+    if (m_path.isEmpty())
+        return "stdin";
+
+    return QFileInfo(m_path).fileName();
+}
+
+/**
+ * @returns @c true if the descriptor is open
+ */
+bool DescriptorTransport::isOpen() const {
+    return m_fd >= 0;
+}
+
+/**
+ * @returns the description of the last error
+ */
+QString DescriptorTransport::errorString() const {
+    return m_error;
+}
+
+/**
+ * Opens the terminal in raw, non-blocking mode (or configures the standard
+ * input as non-blocking) and starts watching it for incoming data
+ */
+bool DescriptorTransport::open() {
+    if (isOpen())
+        return true;
+
+    if (m_path.isEmpty())
+        m_fd = STDIN_FILENO;
+    else
+        m_fd = ::open(QFile::encodeName(m_path).constData(),
+                      O_RDONLY | O_NONBLOCK | O_NOCTTY);
+
+    if (m_fd < 0) {
+        m_error = QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+
+    // Disable echo and line processing of terminals
+    struct termios options;
+    if (!m_path.isEmpty() && tcgetattr(m_fd, &options) == 0) {
+        cfmakeraw(&options);
+        tcsetattr(m_fd, TCSANOW, &options);
+    }
+
+    // Make sure that reads never block the I/O thread
+    const int flags = fcntl(m_fd, F_GETFL);
+    if (flags >= 0)
+        fcntl(m_fd, F_SETFL, flags | O_NONBLOCK);
+
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated,
+            this, &DescriptorTransport::readyRead);
+
+    return true;
+}
+
+/**
+ * Stops watching the descriptor and closes it (the standard input is
+ * left open)
+ */
+void DescriptorTransport::close() {
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+        m_notifier->deleteLater();
+        m_notifier = Q_NULLPTR;
+    }
+
+    if (m_fd > STDIN_FILENO)
+        ::close(m_fd);
+
+    m_fd = -1;
+}
+
+/**
+ * Reads up to @a maxSize bytes into the given @a data buffer, returns 0
+ * if there is no data available and -1 if the descriptor has been closed
+ * by the writer or failed
+ */
+qint64 DescriptorTransport::read(char* data, const qint64 maxSize) {
+    if (!isOpen())
+        return -1;
+
+    const ssize_t bytes = ::read(m_fd, data, static_cast<size_t>(maxSize));
+    if (bytes > 0)
+        return bytes;
+
+    if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK
+                      || errno == EINTR))
+        return 0;
+
+    // End of file or I/O error (e.g. the other side of the pty closed)
+    m_error = (bytes == 0) ? QString("End of file") :
+                             QString::fromLocal8Bit(strerror(errno));
+    m_notifier->setEnabled(false);
+    emit errorOccurred(m_error);
+    return -1;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DESCRIPTOR_TRANSPORT_H
+#define DESCRIPTOR_TRANSPORT_H
+
+#include <QtGlobal>
+
+#ifdef Q_OS_UNIX
+
+#include "Transport.h"
+
+class QSocketNotifier;
+
+/**
+ * @brief Reads data from a pseudo-terminal or from the standard input
+ *
+ * Used to feed the ground station with the output of the packet generator
+ * or of any other program (e.g. @c socat or a shell pipeline) without real
+ * hardware. The descriptor is read in non-blocking mode when the
+ * @c QSocketNotifier reports that it is readable.
+ */
+class DescriptorTransport : public Transport {
+    Q_OBJECT
+
+public:
+    explicit DescriptorTransport(const QString& path,
+                                 QObject* parent = Q_NULLPTR);
+    ~DescriptorTransport();
+
+    QString name() const override;
+    bool isOpen() const override;
+    QString errorString() const override;
+
+    bool open() override;
+    void close() override;
+    qint64 read(char* data, const qint64 maxSize) override;
+
+private:
+    int m_fd;
+    QString m_path;
+    QString m_error;
+    QSocketNotifier* m_notifier;
+};
+
+#endif
+
+#endif
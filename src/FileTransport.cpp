@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QFileInfo>
+
+#include "Constants.h"
+#include "FileTransport.h"
+
+/**
+ * Creates a (closed) transport for the file with the given @a fileName
+ */
+FileTransport::FileTransport(const QString& fileName, QObject* parent) :
+    Transport(parent),
+    m_file(fileName),
+    m_isCapture(false),
+    m_budget(0),
+    m_frameOffset(0)
+{
+    m_timer.setInterval(0);
+    connect(&m_timer, &QTimer::timeout, this, &FileTransport::onTimeout);
+}
+
+/**
+ * Closes the file
+ */
+FileTransport::~FileTransport() {
+    close();
+}
+
+/**
+ * @returns the name of the file (without its path)
+ */
+QString FileTransport::name() const {
+    return QFileInfo(m_file.fileName()).fileName();
+}
+
+/**
+ * @returns @c true if the file is open
+ */
+bool FileTransport::isOpen() const {
+    return m_isCapture ? m_capture.isOpen() : m_file.isOpen();
+}
+
+/**
+ * @returns the description of the last error
+ */
+QString FileTransport::errorString() const {
+    return m_error;
+}
+
+/**
+ * Opens the file and starts delivering its contents
+ */
+bool FileTransport::open() {
+    close();
+
+    m_isCapture = m_file.fileName().endsWith(".kcap", Qt::CaseInsensitive);
+    if (m_isCapture && !m_capture.open(m_file.fileName())) {
+        m_error = tr("Invalid capture file");
+        return false;
+    }
+
+    else if (!m_isCapture && !m_file.open(QFile::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    m_error.clear();
+    m_timer.start();
+    return true;
+}
+
+/**
+ * Stops the delivery of data and closes the file
+ */
+void FileTransport::close() {
+    m_timer.stop();
+    m_file.close();
+    m_capture.close();
+
+    m_budget = 0;
+    m_frame.clear();
+    m_frameOffset = 0;
+}
+
+/**
+ * Reads up to @a maxSize bytes into the given @a data buffer, returns 0
+ * once the chunk of the current event loop iteration has been delivered
+ * and -1 at the end of the file
+ */
+qint64 FileTransport::read(char* data, const qint64 maxSize) {
+    if (!isOpen())
+        return -1;
+
+    const qint64 size = qMin(maxSize, m_budget);
+    if (size <= 0)
+        return 0;
+
+    qint64 bytes;
+    if (m_isCapture)
+        bytes = readCapture(data, size);
+    else
+        bytes = m_file.read(data, size);
+
+    if (bytes > 0) {
+        m_budget -= bytes;
+        return bytes;
+    }
+
+    // End of the file (or read error), stop delivering data
+    m_timer.stop();
+    m_budget = 0;
+    m_error = tr("End of file");
+    emit errorOccurred(m_error);
+    return -1;
+}
+
+/**
+ * Stops or resumes the delivery of data, the unread part of the current
+ * chunk stays in the file and is delivered after resuming
+ */
+bool FileTransport::setPaused(const bool paused) {
+    if (paused) {
+        m_timer.stop();
+        m_budget = 0;
+    }
+
+    else if (isOpen() && m_error.isEmpty())
+        m_timer.start();
+
+    return true;
+}
+
+/**
+ * Grants the next chunk of data to the reader
+ */
+void FileTransport::onTimeout() {
+    m_budget = CHUNK_SIZE;
+    emit readyRead();
+}
+
+/**
+ * Copies the contents of the capture into @a data, each captured packet
+ * is followed by the EOT byte that the capture format does not store
+ */
+qint64 FileTransport::readCapture(char* data, const qint64 maxSize) {
+    qint64 bytes = 0;
+    while (bytes < maxSize) {
+        // Load the next packet
+        if (m_frameOffset >= m_frame.size()) {
+            qint64 timestamp;
+            if (!m_capture.readFrame(timestamp, m_frame))
+                break;
+
+            m_frame.append(EOT_PRIMARY.toLatin1());
+            m_frameOffset = 0;
+        }
+
+        // Copy as much as possible
+        const int length = static_cast<int>(
+                    qMin<qint64>(maxSize - bytes,
+                                 m_frame.size() - m_frameOffset));
+        memcpy(data + bytes, m_frame.constData() + m_frameOffset,
+               static_cast<size_t>(length));
+        m_frameOffset += length;
+        bytes += length;
+    }
+
+    return bytes;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FILE_TRANSPORT_H
+#define FILE_TRANSPORT_H
+
+#include <QFile>
+#include <QTimer>
+#include <QByteArray>
+
+#include "Transport.h"
+#include "CaptureFile.h"
+
+/**
+ * @brief Reads a raw telemetry log or a binary capture as a byte stream
+ *
+ * The contents of the file are delivered as fast as the frame reader can
+ * consume them (in chunks of @c CHUNK_SIZE bytes, one chunk per event loop
+ * iteration), which makes it possible to load-test the whole reception
+ * path with real data. Binary captures (@c .kcap) are converted back into
+ * EOT-terminated packets, any other file is read as-is. Use the replay
+ * engine to play captures back in real time. The frame reader pauses the
+ * transport while its queue is busy, so that no packet is dropped.
+ *
+ * The @c errorOccurred() signal is emitted when the end of the file is
+ * reached.
+ */
+class FileTransport : public Transport {
+    Q_OBJECT
+
+public:
+    explicit FileTransport(const QString& fileName,
+                           QObject* parent = Q_NULLPTR);
+    ~FileTransport();
+
+    QString name() const override;
+    bool isOpen() const override;
+    QString errorString() const override;
+
+    bool open() override;
+    void close() override;
+    qint64 read(char* data, const qint64 maxSize) override;
+    bool setPaused(const bool paused) override;
+
+    static const int CHUNK_SIZE = 64 * 1024;
+
+private slots:
+    void onTimeout();
+
+private:
+    qint64 readCapture(char* data, const qint64 maxSize);
+
+private:
+    QFile m_file;
+    QTimer m_timer;
+    QString m_error;
+    bool m_isCapture;
+    qint64 m_budget;
+
+    int m_frameOffset;
+    QByteArray m_frame;
+    CaptureReader m_capture;
+};
+
+#endif
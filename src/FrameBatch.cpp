@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Constants.h"
+#include "FrameBatch.h"
+
+/**
+ * Reserves enough memory for a typical burst of packets, reserving memory
+ * also ensures that @c clear() does not release it
+ */
+FrameBatch::FrameBatch() {
+    m_data.reserve(16 * 1024);
+    m_offsets.reserve(64);
+    m_timestamps.reserve(64);
+}
+
+/**
+ * @returns the number of packets in the batch
+ */
+int FrameBatch::count() const {
+    return m_offsets.count();
+}
+
+/**
+ * @returns @c true if the batch does not contain any packet
+ */
+bool FrameBatch::isEmpty() const {
+    return m_offsets.isEmpty();
+}
+
+/**
+ * @returns the length of the packet at the given @a index (without the
+ *          trailing EOT byte)
+ */
+int FrameBatch::frameSize(const int index) const {
+    const int end = (index + 1 < count()) ? m_offsets.at(index + 1) :
+                                            m_data.size();
+    return end - m_offsets.at(index) - 1;
+}
+
+/**
+ * @returns a pointer to the first byte of the packet at the given @a index
+ */
+const char* FrameBatch::frameData(const int index) const {
+    return m_data.constData() + m_offsets.at(index);
+}
+
+/**
+ * @returns the monotonic time (in nanoseconds) at which the packet at the
+ *          given @a index was received
+ */
+qint64 FrameBatch::frameTimestamp(const int index) const {
+    return m_timestamps.at(index);
+}
+
+/**
+ * @returns the contiguous block that contains all the packets, each packet
+ *          is followed by the @c EOT_PRIMARY byte
+ */
+const QByteArray& FrameBatch::data() const {
+    return m_data;
+}
+
+/**
+ * @returns the reception timestamps of all the packets
+ */
+const QVector<qint64>& FrameBatch::timestamps() const {
+    return m_timestamps;
+}
+
+/**
+ * Removes all packets from the batch without releasing memory
+ */
+void FrameBatch::clear() {
+    m_data.resize(0);
+    m_offsets.resize(0);
+    m_timestamps.resize(0);
+}
+
+/**
+ * Appends a copy of the packet with the given @a data and @a size, which
+ * was received at the given monotonic @a timestamp
+ */
+void FrameBatch::append(const char* data, const int size,
+                        const qint64 timestamp) {
+    m_offsets.append(m_data.size());
+    m_timestamps.append(timestamp);
+    m_data.append(data, size);
+    m_data.append(EOT_PRIMARY.toLatin1());
+}
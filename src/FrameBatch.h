@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FRAME_BATCH_H
+#define FRAME_BATCH_H
+
+#include <QVector>
+#include <QByteArray>
+
+/**
+ * @brief Group of packets stored in one contiguous block of memory
+ *
+ * Each packet is followed by the @c EOT_PRIMARY byte, so that the block
+ * contains the same data that was received from the CanSat and can be
+ * written to a log file in a single call. The monotonic reception time of
+ * each packet (see @c MonotonicTime()) is also stored. The memory used by
+ * the batch is re-used after calling @c clear().
+ */
+class FrameBatch {
+public:
+    FrameBatch();
+
+    int count() const;
+    bool isEmpty() const;
+
+    int frameSize(const int index) const;
+    const char* frameData(const int index) const;
+    qint64 frameTimestamp(const int index) const;
+
+    const QByteArray& data() const;
+    const QVector<qint64>& timestamps() const;
+
+    void clear();
+    void append(const char* data, const int size, const qint64 timestamp);
+
+private:
+    QByteArray m_data;
+    QVector<int> m_offsets;
+    QVector<qint64> m_timestamps;
+};
+
+#endif
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "DataParser.h"
+#include "FrameMerger.h"
+
+/**
+ * Number of recent packets that are remembered to detect duplicates
+ */
+static const int RECENT_KEYS = 256;
+
+/**
+ * Maximum distance between packet counts for two packets to be considered
+ * part of the same sequence when sorting the reorder buffer
+ */
+static const quint64 MAX_REORDER_DISTANCE = 64;
+
+/**
+ * Initializes a merger for a single source
+ */
+FrameMerger::FrameMerger() :
+    m_depth(8),
+    m_holdTime(50 * 1000 * 1000),
+    m_sourceCount(0),
+    m_recentHead(0)
+{
+    m_recentKeys.reserve(RECENT_KEYS);
+    setSourceCount(1);
+}
+
+/**
+ * Returns the number of packets held by the merger
+ */
+int FrameMerger::pending() const {
+    return m_incoming.count() + m_buffer.count();
+}
+
+/**
+ * Returns the number of active sources
+ */
+int FrameMerger::sourceCount() const {
+    return m_sourceCount;
+}
+
+/**
+ * Returns the maximum number of packets held in the reorder buffer
+ */
+int FrameMerger::reorderDepth() const {
+    return m_depth;
+}
+
+/**
+ * Returns the maximum time (in nanoseconds) that a packet is held in the
+ * reorder buffer
+ */
+qint64 FrameMerger::holdTime() const {
+    return m_holdTime;
+}
+
+/**
+ * Returns the monotonic time at which the oldest held packet must be
+ * released, or -1 if there are no held packets
+ */
+qint64 FrameMerger::nextDeadline() const {
+    if (m_buffer.isEmpty())
+        return -1;
+
+    qint64 oldest = m_buffer.first().timestamp;
+    foreach (const Entry& entry, m_buffer)
+        oldest = qMin(oldest, entry.timestamp);
+
+    return oldest + m_holdTime;
+}
+
+/**
+ * Returns the counters of the given @a source
+ */
+const FrameMerger::SourceStats& FrameMerger::stats(const int source) const {
+    return m_stats.at(source);
+}
+
+/**
+ * Discards all held packets and forgets the recent packets
+ */
+void FrameMerger::clear() {
+    foreach (const Entry& entry, m_incoming)
+        freeEntry(entry);
+    foreach (const Entry& entry, m_buffer)
+        freeEntry(entry);
+
+    m_incoming.clear();
+    m_buffer.clear();
+    m_recent.clear();
+    m_recentKeys.clear();
+    m_recentHead = 0;
+}
+
+/**
+ * Resets the counters of the given @a source (e.g. when a new device is
+ * opened by the receiver)
+ */
+void FrameMerger::resetStats(const int source) {
+    if (source >= m_stats.count())
+        m_stats.resize(source + 1);
+
+    memset(&m_stats[source], 0, sizeof(SourceStats));
+}
+
+/**
+ * Changes the number of active sources, packets are only held and
+ * de-duplicated if there is more than one active source
+ */
+void FrameMerger::setSourceCount(const int count) {
+    m_sourceCount = qMax(0, count);
+    if (m_stats.count() < m_sourceCount) {
+        const int previous = m_stats.count();
+        m_stats.resize(m_sourceCount);
+        for (int i = previous; i < m_sourceCount; ++i)
+            resetStats(i);
+    }
+}
+
+/**
+ * Changes the maximum number of packets held in the reorder buffer
+ */
+void FrameMerger::setReorderDepth(const int depth) {
+    m_depth = qMax(0, depth);
+}
+
+/**
+ * Changes the maximum time that a packet is held in the reorder buffer
+ */
+void FrameMerger::setHoldTime(const qint64 nanoseconds) {
+    m_holdTime = qMax<qint64>(0, nanoseconds);
+}
+
+/**
+ * @brief Returns @c true if a packet received by the given @a source can be
+ *        delivered directly, without pushing it to the merger
+ *
+ * This is the case when there is only one active source and no packet is
+ * held, the packet is counted as a first delivery of the source.
+ */
+bool FrameMerger::bypass(const int source) {
+    if (m_sourceCount > 1 || pending() > 0)
+        return false;
+
+    if (source >= m_stats.count())
+        resetStats(source);
+
+    ++m_stats[source].frames;
+    ++m_stats[source].firstDeliveries;
+    return true;
+}
+
+/**
+ * Copies the given packet, received by @a source at the given monotonic
+ * @a timestamp, packets are processed when @c release() is called
+ */
+void FrameMerger::push(const int source, const char* data, const int size,
+                       const qint64 timestamp) {
+    // Get a free frame from the pool
+    int slot;
+    if (m_freeSlots.isEmpty()) {
+        slot = m_pool.count();
+        m_pool.resize(slot + 1);
+    } else {
+        slot = m_freeSlots.last();
+        m_freeSlots.removeLast();
+    }
+
+    RawFrame& frame = m_pool[slot];
+    frame.size = qMin(size, MAX_FRAME_SIZE);
+    frame.timestamp = timestamp;
+    memcpy(frame.data, data, static_cast<size_t>(frame.size));
+
+    // Find the packet count and mission time of the packet, damaged packets
+    // are not used to detect duplicates, so that they cannot replace a
+    // valid copy received by another source. Keys are only used when there
+    // is more than one source, so do not validate the packet twice otherwise
+    quint64 count = 0;
+    quint64 time = 0;
+
+    Entry entry;
+    entry.slot = slot;
+    entry.source = source;
+    entry.timestamp = timestamp;
+    entry.keyed = m_sourceCount > 1 &&
+            DataParser::CheckPacket(frame.data, frame.size, count, time);
+    entry.key = (count << 32) ^ time;
+    entry.sequence = count;
+    m_incoming.append(entry);
+
+    if (source >= m_stats.count())
+        resetStats(source);
+
+    ++m_stats[source].frames;
+}
+
+/**
+ * Processes the pushed packets and appends the packets that are ready to
+ * the given @a batch, all packets are released if @a flush is @c true or
+ * if there is only one active source
+ *
+ * @returns the number of packets that are still held
+ */
+int FrameMerger::release(FrameBatch& batch, const qint64 now,
+                         const bool flush) {
+    process();
+
+    // Release packets (in order) while the buffer is full, or while any
+    // of the held packets is too old
+    const int depth = (m_sourceCount > 1) ? m_depth : 0;
+    while (!m_buffer.isEmpty()) {
+        if (!flush && m_buffer.count() <= depth && nextDeadline() > now)
+            break;
+
+        const Entry& entry = m_buffer.first();
+        const RawFrame& frame = m_pool.at(entry.slot);
+        batch.append(frame.data, frame.size, frame.timestamp);
+        freeEntry(entry);
+        m_buffer.removeFirst();
+    }
+
+    return m_buffer.count();
+}
+
+/**
+ * Moves the pushed packets to the reorder buffer, in order of arrival,
+ * discarding the packets that were already received by another source
+ */
+void FrameMerger::process() {
+    if (m_incoming.isEmpty())
+        return;
+
+    // Process packets in the order in which they were received
+    std::stable_sort(m_incoming.begin(), m_incoming.end(),
+                     [](const Entry& a, const Entry& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    const bool merge = m_sourceCount > 1;
+    foreach (const Entry& entry, m_incoming) {
+        // Discard copies of packets that were delivered by other sources
+        if (merge && entry.keyed && isDuplicate(entry.key)) {
+            ++m_stats[entry.source].duplicates;
+            freeEntry(entry);
+            continue;
+        }
+
+        ++m_stats[entry.source].firstDeliveries;
+
+        // Insert the packet in order of packet count
+        int position = m_buffer.count();
+        if (merge && entry.keyed) {
+            while (position > 0) {
+                const Entry& previous = m_buffer.at(position - 1);
+                if (!previous.keyed || previous.sequence <= entry.sequence
+                        || previous.sequence - entry.sequence
+                        > MAX_REORDER_DISTANCE)
+                    break;
+
+                --position;
+            }
+        }
+
+        m_buffer.insert(position, entry);
+    }
+
+    m_incoming.clear();
+}
+
+/**
+ * Returns @c true if a packet with the given @a key was received recently,
+ * otherwise, the key is remembered and @c false is returned
+ */
+bool FrameMerger::isDuplicate(const quint64 key) {
+    if (m_recent.contains(key))
+        return true;
+
+    // Forget the oldest key
+    if (m_recentKeys.count() == RECENT_KEYS) {
+        const quint64 oldest = m_recentKeys.at(m_recentHead);
+        QHash<quint64, int>::iterator it = m_recent.find(oldest);
+        if (it != m_recent.end() && --it.value() <= 0)
+            m_recent.erase(it);
+
+        m_recentKeys[m_recentHead] = key;
+        m_recentHead = (m_recentHead + 1) % RECENT_KEYS;
+    } else {
+        m_recentKeys.append(key);
+    }
+
+    m_recent[key] += 1;
+    return false;
+}
+
+/**
+ * Returns the frame used by the given @a entry to the pool
+ */
+void FrameMerger::freeEntry(const Entry& entry) {
+    m_freeSlots.append(entry.slot);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FRAME_MERGER_H
+#define FRAME_MERGER_H
+
+#include <QHash>
+#include <QVector>
+
+#include "FrameBatch.h"
+#include "FrameReader.h"
+
+/**
+ * @brief Merges the packets received by several radios into one stream
+ *
+ * Every receiver (source) delivers a copy of the same packets, with
+ * different latencies and losses. The merger:
+ *
+ *     - Orders the packets of each drain cycle by reception time, so that
+ *       the first copy of a packet is always the one that arrived first
+ *     - Discards later copies, identified by their packet count and mission
+ *       time. Only packets that pass the structural checks of the parser
+ *       (header, number of fields, EOT code and CRC-32) are identified, so
+ *       a damaged copy never causes a valid copy to be discarded
+ *     - Holds the packets in a small reorder buffer (up to @c reorderDepth
+ *       packets or @c holdTime nanoseconds), sorted by packet count, so that
+ *       a packet that was lost by one radio and recovered by another one is
+ *       not delivered out of order
+ *
+ * Per-source counters tell which receiver delivered each packet first.
+ * When only one source is active the merger is a pass-through: packets are
+ * neither held, validated nor de-duplicated (so that duplicates generated
+ * by the link itself are still reported by the @c SequenceTracker), and
+ * @c bypass() lets the caller deliver them without copying them into the
+ * merger.
+ */
+class FrameMerger {
+public:
+    struct SourceStats {
+        qint64 frames;
+        qint64 firstDeliveries;
+        qint64 duplicates;
+    };
+
+    FrameMerger();
+
+    int pending() const;
+    int sourceCount() const;
+    int reorderDepth() const;
+    qint64 holdTime() const;
+    qint64 nextDeadline() const;
+    const SourceStats& stats(const int source) const;
+
+    void clear();
+    void resetStats(const int source);
+    void setSourceCount(const int count);
+    void setReorderDepth(const int depth);
+    void setHoldTime(const qint64 nanoseconds);
+
+    bool bypass(const int source);
+    void push(const int source, const char* data, const int size,
+              const qint64 timestamp);
+    int release(FrameBatch& batch, const qint64 now, const bool flush);
+
+private:
+    struct Entry {
+        int slot;
+        int source;
+        bool keyed;
+        quint64 key;
+        quint64 sequence;
+        qint64 timestamp;
+    };
+
+    void process();
+    bool isDuplicate(const quint64 key);
+    void freeEntry(const Entry& entry);
+
+private:
+    int m_depth;
+    qint64 m_holdTime;
+    int m_sourceCount;
+
+    QVector<RawFrame> m_pool;
+    QVector<int> m_freeSlots;
+    QVector<Entry> m_incoming;
+    QVector<Entry> m_buffer;
+    QVector<SourceStats> m_stats;
+
+    int m_recentHead;
+    QVector<quint64> m_recentKeys;
+    QHash<quint64, int> m_recent;
+};
+
+#endif
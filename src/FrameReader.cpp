@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QDebug>
+
+#include "Transport.h"
+#include "FrameReader.h"
+#include "TraceWriter.h"
+
+/**
+ * Constructor function, packets shall be written to the given @a queue
+ */
+FrameReader::FrameReader(FrameQueue* queue) :
+    m_transport(Q_NULLPTR),
+    m_queue(queue),
+    m_paused(0),
+    m_notifyPending(0),
+    m_droppedBytes(0),
+    m_receivedBytes(0),
+    m_droppedFrames(0)
+{
+    Q_ASSERT(queue);
+}
+
+/**
+ * Closes the transport (if open)
+ */
+FrameReader::~FrameReader() {
+    closeTransport(false);
+}
+
+/**
+ * @returns the number of garbage bytes discarded by the packet framer
+ */
+qint64 FrameReader::droppedBytes() const {
+    return m_droppedBytes.load();
+}
+
+/**
+ * @returns the number of bytes received from the current transport
+ */
+qint64 FrameReader::receivedBytes() const {
+    return m_receivedBytes.load();
+}
+
+/**
+ * @returns the number of packets that were discarded because the frame
+ *          queue was full (e.g. the GUI thread was blocked for too long)
+ */
+qint64 FrameReader::droppedFrames() const {
+    return m_droppedFrames.load();
+}
+
+/**
+ * @brief Called by the consumer before it drains the frame queue
+ *
+ * The reader only emits @c framesAvailable() when the consumer has
+ * acknowledged the previous notification, so that bursts of packets do
+ * not flood the event queue of the GUI thread. A paused transport is
+ * resumed once the consumer acknowledges the notification.
+ */
+void FrameReader::acknowledgeFrames() {
+    m_notifyPending.storeRelease(0);
+    if (m_paused.loadAcquire())
+        QMetaObject::invokeMethod(this, "resume", Qt::QueuedConnection);
+}
+
+/**
+ * Closes the current transport without notifying the application
+ */
+void FrameReader::close() {
+    closeTransport(false);
+}
+
+/**
+ * Changes the baud @a rate of the current transport (serial ports only)
+ */
+void FrameReader::setBaudRate(const int rate) {
+    if (m_transport)
+        m_transport->setBaudRate(rate);
+}
+
+/**
+ * @brief Opens the transport described by the given @a source string
+ *        (e.g. a serial port, see @c Transport::Create()), the
+ *        @a baudRate is only used by serial ports
+ *
+ * The @c opened() signal is emitted on success, otherwise, the @c closed()
+ * signal is emitted.
+ */
+void FrameReader::open(const QString& source, const int baudRate) {
+    // Create the transport
+    Transport* transport = Transport::Create(source);
+    if (!transport) {
+        closeTransport(false);
+        qWarning() << "Invalid telemetry source" << source;
+        emit closed(source);
+        return;
+    }
+
+    // Configure the transport
+    transport->setBaudRate(baudRate);
+
+    // Open it
+    open(transport);
+}
+
+/**
+ * @brief Takes ownership of the given (closed) @a transport and opens it
+ *
+ * This is used by @c open() and by the benchmarks, which feed the reader
+ * from memory, it must be called from the thread of the reader. The
+ * @c opened() signal is emitted on success, otherwise, the @c closed()
+ * signal is emitted.
+ */
+void FrameReader::open(Transport* transport) {
+    Q_ASSERT(transport);
+
+    // Close current transport
+    closeTransport(false);
+
+    // Reset framer & counters
+    m_framer.clear();
+    m_paused.store(0);
+    m_droppedBytes.store(0);
+    m_receivedBytes.store(0);
+    m_droppedFrames.store(0);
+    emit droppedBytesChanged();
+
+    // Take ownership of the transport
+    m_transport = transport;
+    m_transport->setParent(this);
+
+    // Connect signals/slots
+    connect(m_transport, &Transport::readyRead,
+            this, &FrameReader::onDataReceived);
+    connect(m_transport, &Transport::errorOccurred,
+            this, &FrameReader::onTransportError, Qt::QueuedConnection);
+
+    // Try to open the transport
+    if (m_transport->open())
+        emit opened(m_transport->name());
+
+    // There was an error opening the transport
+    else {
+        qWarning() << "Cannot open" << m_transport->name()
+                   << m_transport->errorString();
+        closeTransport(true);
+    }
+}
+
+/**
+ * @brief Reads incoming data directly into the packet framer and copies
+ *        every complete packet into the frame queue
+ */
+void FrameReader::onDataReceived() {
+    QByteArray packet;
+    qint64 received = 0;
+    bool paused = false;
+    bool enqueued = false;
+    const qint64 dropped = m_framer.droppedBytes();
+    TraceSpan span("serial.read");
+
+    while (m_transport != Q_NULLPTR) {
+        // Let the consumer catch up with transports that can wait (e.g.
+        // files) instead of dropping packets when the queue is full
+        if (m_queue->size() >= m_queue->capacity() / 2 &&
+                m_transport->setPaused(true)) {
+            m_paused.storeRelease(1);
+            paused = true;
+            break;
+        }
+
+        // Read incoming data
+        int space = 0;
+        char* buffer = m_framer.reserve(space);
+        const qint64 bytes = m_transport->read(buffer, space);
+        if (bytes <= 0)
+            break;
+
+        // Update framer & byte counter
+        const qint64 timestamp = MonotonicTime();
+        received += bytes;
+        m_receivedBytes.fetchAndAddRelaxed(bytes);
+        m_framer.commit(static_cast<int>(bytes));
+
+        // Queue each packet separately, the framer re-synchronizes with
+        // the stream by itself if it detects corrupted data
+        int frames = 0;
+        TraceSpan framing("framing");
+        while (m_framer.nextFrame(packet)) {
+            enqueue(packet, timestamp);
+            enqueued = true;
+            ++frames;
+        }
+
+        framing.setValue(frames);
+    }
+
+    span.setValue(received);
+
+    // Notify consumer (if it has not been notified yet), the notification
+    // is also needed to resume a paused transport
+    if ((enqueued || paused) && m_notifyPending.fetchAndStoreOrdered(1) == 0)
+        emit framesAvailable();
+
+    // Notify application if garbage data was discarded
+    if (m_framer.droppedBytes() != dropped) {
+        m_droppedBytes.store(m_framer.droppedBytes());
+        emit droppedBytesChanged();
+    }
+}
+
+/**
+ * Resumes the transport after the consumer has drained the queue (the
+ * transport is paused again if the queue is still busy)
+ */
+void FrameReader::resume() {
+    if (m_paused.fetchAndStoreOrdered(0) && m_transport != Q_NULLPTR)
+        m_transport->setPaused(false);
+}
+
+/**
+ * Closes the transport and notifies the application if the device was
+ * disconnected, the end of the file was reached or if any other fatal
+ * error occurred
+ */
+void FrameReader::onTransportError() {
+    closeTransport(true);
+}
+
+/**
+ * Closes and deletes the current transport, the @c closed() signal is
+ * emitted if @a notify is set to @c true
+ */
+void FrameReader::closeTransport(const bool notify) {
+    if (m_transport != Q_NULLPTR) {
+        // Get transport name
+        QString name = m_transport->name();
+
+        // Disconnect signals/slots of transport
+        m_transport->disconnect(this);
+
+        // Close and delete the transport
+        m_transport->close();
+        m_transport->deleteLater();
+
+        // Reset pointer
+        m_transport = Q_NULLPTR;
+
+        // Notify application
+        if (notify)
+            emit closed(name);
+    }
+}
+
+/**
+ * Copies the given @a packet and its reception @a timestamp into the next
+ * free slot of the frame queue, packets are discarded (and counted) if the
+ * queue is full.
+ *
+ * @note Packets longer than a queue slot are truncated, they would be
+ *       rejected by the data parser anyway, but we still hand them over so
+ *       that they are accounted for as packet errors.
+ */
+void FrameReader::enqueue(const QByteArray& packet, const qint64 timestamp) {
+    RawFrame* frame = m_queue->back();
+    if (!frame) {
+        m_droppedFrames.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    frame->timestamp = timestamp;
+    frame->size = qMin(packet.size(), MAX_FRAME_SIZE);
+    memcpy(frame->data, packet.constData(), static_cast<size_t>(frame->size));
+    m_queue->push();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FRAME_READER_H
+#define FRAME_READER_H
+
+#include <QObject>
+#include <QAtomicInteger>
+
+#include "Constants.h"
+#include "SpscQueue.h"
+#include "PacketFramer.h"
+
+/**
+ * Fixed-size queue slot used to hand packets from the serial I/O thread to
+ * the GUI thread without allocating memory
+ */
+struct RawFrame {
+    int size;
+    qint64 timestamp;
+    char data[MAX_FRAME_SIZE];
+};
+
+typedef SpscQueue<RawFrame> FrameQueue;
+
+class Transport;
+
+/**
+ * @brief Reads and frames telemetry data in a dedicated thread
+ *
+ * The reader owns the transport (serial port, socket, pseudo-terminal or
+ * file, see @c Transport::Create()) and the packet framer, both objects live
+ * in the thread of the reader, so that the reception of data does not
+ * depend on how busy the GUI thread is. Complete packets are copied into
+ * the given single-producer/single-consumer @c FrameQueue and the consumer
+ * is notified with the @c framesAvailable() signal.
+ *
+ * All slots must be invoked through queued connections, the counters can
+ * be read from any thread.
+ */
+class FrameReader : public QObject {
+    Q_OBJECT
+
+signals:
+    void framesAvailable();
+    void droppedBytesChanged();
+    void opened(const QString& deviceName);
+    void closed(const QString& deviceName);
+
+public:
+    explicit FrameReader(FrameQueue* queue);
+    ~FrameReader();
+
+    qint64 droppedBytes() const;
+    qint64 receivedBytes() const;
+    qint64 droppedFrames() const;
+
+    void acknowledgeFrames();
+    void open(Transport* transport);
+
+public slots:
+    void close();
+    void setBaudRate(const int rate);
+    void open(const QString& source, const int baudRate);
+
+private slots:
+    void resume();
+    void onDataReceived();
+    void onTransportError();
+
+private:
+    void closeTransport(const bool notify);
+    void enqueue(const QByteArray& packet, const qint64 timestamp);
+
+private:
+    Transport* m_transport;
+    FrameQueue* m_queue;
+    PacketFramer m_framer;
+
+    QAtomicInt m_paused;
+    QAtomicInt m_notifyPending;
+    QAtomicInteger<qint64> m_droppedBytes;
+    QAtomicInteger<qint64> m_receivedBytes;
+    QAtomicInteger<qint64> m_droppedFrames;
+};
+
+#endif
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QtMath>
+#include <QDateTime>
+#include <QtAlgorithms>
+#include <QVariantMap>
+#include <QCoreApplication>
+
+#include "Constants.h"
+#include "FrameBatch.h"
+#include "LatencyMonitor.h"
+
+/**
+ * Pointer to the only instance of the monitor
+ */
+static LatencyMonitor* instance = Q_NULLPTR;
+
+/**
+ * Interval between updates of the statistics shown by the user interface
+ */
+static const int UPDATE_INTERVAL = 500;
+
+/**
+ * Creates an empty histogram
+ */
+LatencyHistogram::LatencyHistogram() {
+    clear();
+}
+
+/**
+ * @returns the number of recorded values
+ */
+qint64 LatencyHistogram::count() const {
+    return m_count.load();
+}
+
+/**
+ * @returns the highest recorded value
+ */
+qint64 LatencyHistogram::maximum() const {
+    return m_maximum.load();
+}
+
+/**
+ * @returns the mean of the recorded values
+ */
+double LatencyHistogram::mean() const {
+    const qint64 count = m_count.load();
+    if (count <= 0)
+        return 0;
+
+    return static_cast<double>(m_sum.load()) / count;
+}
+
+/**
+ * @returns the value below which the given @a quantile (between 0 and 1)
+ *          of the recorded values fall, the upper bound of the bucket is
+ *          reported (limited to the maximum)
+ */
+qint64 LatencyHistogram::percentile(const double quantile) const {
+    qint64 total = 0;
+    for (int i = 0; i < BUCKETS; ++i)
+        total += m_buckets[i].load();
+
+    if (total <= 0)
+        return 0;
+
+    const qint64 rank = qMax<qint64>(1, qCeil(quantile * total));
+    qint64 cumulative = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        cumulative += m_buckets[i].load();
+        if (cumulative >= rank)
+            return qMin(BucketUpperBound(i), maximum());
+    }
+
+    return maximum();
+}
+
+/**
+ * @returns the number of buckets of the histogram
+ */
+int LatencyHistogram::bucketCount() const {
+    return BUCKETS;
+}
+
+/**
+ * @returns the number of values recorded in the given @a bucket
+ */
+qint64 LatencyHistogram::bucketCount(const int bucket) const {
+    if (bucket < 0 || bucket >= BUCKETS)
+        return 0;
+
+    return m_buckets[bucket].load();
+}
+
+/**
+ * @returns the lowest value counted by the given @a bucket
+ */
+qint64 LatencyHistogram::BucketLowerBound(const int bucket) {
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+
+    const int shift = bucket / SUB_BUCKETS - 1;
+    return static_cast<qint64>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+}
+
+/**
+ * @returns the highest value counted by the given @a bucket
+ */
+qint64 LatencyHistogram::BucketUpperBound(const int bucket) {
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+
+    const int shift = bucket / SUB_BUCKETS - 1;
+    return BucketLowerBound(bucket) + (Q_INT64_C(1) << shift) - 1;
+}
+
+/**
+ * Removes all recorded values
+ */
+void LatencyHistogram::clear() {
+    m_count.store(0);
+    m_sum.store(0);
+    m_maximum.store(0);
+    for (int i = 0; i < BUCKETS; ++i)
+        m_buckets[i].store(0);
+}
+
+/**
+ * Adds the given @a latency (in nanoseconds) to the histogram, negative
+ * values are counted as 0
+ */
+void LatencyHistogram::record(const qint64 latency) {
+    const qint64 value = qMax<qint64>(0, latency);
+
+    m_count.fetchAndAddRelaxed(1);
+    m_sum.fetchAndAddRelaxed(value);
+    m_buckets[BucketIndex(value)].fetchAndAddRelaxed(1);
+
+    qint64 maximum = m_maximum.load();
+    while (value > maximum && !m_maximum.testAndSetRelaxed(maximum, value))
+        maximum = m_maximum.load();
+}
+
+/**
+ * @returns the bucket that counts the given @a latency
+ */
+int LatencyHistogram::BucketIndex(const qint64 latency) {
+    const quint64 value = static_cast<quint64>(latency);
+    if (value < SUB_BUCKETS)
+        return static_cast<int>(value);
+
+    // Position of the highest bit (at least 4), the next 4 bits select
+    // the sub-bucket
+    const int msb = 63 - qCountLeadingZeroBits(value);
+    const int index = (msb - 3) * SUB_BUCKETS +
+            static_cast<int>((value >> (msb - 4)) & (SUB_BUCKETS - 1));
+
+    return qMin(index, BUCKETS - 1);
+}
+
+/**
+ * Starts the periodic update of the statistics
+ */
+LatencyMonitor::LatencyMonitor() :
+    m_pendingRender(0),
+    m_displayedTimestamp(0)
+{
+    m_timer.setInterval(UPDATE_INTERVAL);
+    connect(&m_timer, &QTimer::timeout,
+            this, &LatencyMonitor::statisticsChanged);
+    m_timer.start();
+}
+
+/**
+ * @returns the only instance of the monitor
+ */
+LatencyMonitor* LatencyMonitor::getInstance() {
+    if (instance == Q_NULLPTR)
+        instance = new LatencyMonitor();
+
+    return instance;
+}
+
+/**
+ * @returns the age (in milliseconds) of the data currently shown by the
+ *          user interface, or -1 if no data has been shown yet
+ */
+double LatencyMonitor::dataAge() const {
+    const qint64 timestamp = m_displayedTimestamp.load();
+    if (timestamp <= 0)
+        return -1;
+
+    return (MonotonicTime() - timestamp) / 1e6;
+}
+
+/**
+ * @returns a list with the name, number of samples, mean, p50, p99 and
+ *          maximum latency (in milliseconds) of each stage
+ */
+QVariantList LatencyMonitor::stages() const {
+    QVariantList list;
+    for (int i = 0; i < kStageCount; ++i) {
+        const LatencyHistogram& h = m_histograms[i];
+
+        QVariantMap map;
+        map.insert("name", StageName(i));
+        map.insert("count", h.count());
+        map.insert("mean", h.mean() / 1e6);
+        map.insert("p50", h.percentile(0.50) / 1e6);
+        map.insert("p99", h.percentile(0.99) / 1e6);
+        map.insert("max", h.maximum() / 1e6);
+        list.append(map);
+    }
+
+    return list;
+}
+
+/**
+ * @returns the histogram of the given @a stage
+ */
+const LatencyHistogram& LatencyMonitor::histogram(const Stage stage) const {
+    return m_histograms[stage];
+}
+
+/**
+ * Records the latency of a packet received at the given @a timestamp that
+ * completed the given @a stage at the given time (@a now)
+ */
+void LatencyMonitor::record(const Stage stage, const qint64 timestamp,
+                            const qint64 now) {
+    if (timestamp > 0)
+        m_histograms[stage].record(now - timestamp);
+}
+
+/**
+ * Records the latency of every packet of the given @a batch, which
+ * completed the given @a stage at the given time (@a now)
+ */
+void LatencyMonitor::record(const Stage stage, const FrameBatch& batch,
+                            const qint64 now) {
+    for (int i = 0; i < batch.count(); ++i)
+        record(stage, batch.frameTimestamp(i), now);
+}
+
+/**
+ * @brief Called when the parser publishes new data to the user interface
+ *
+ * The @a timestamp of the newest published packet is recorded in the
+ * render stage when the next frame is swapped.
+ */
+void LatencyMonitor::markPublished(const qint64 timestamp) {
+    if (timestamp > 0)
+        m_pendingRender.storeRelease(timestamp);
+}
+
+/**
+ * Removes all recorded latencies
+ */
+void LatencyMonitor::reset() {
+    for (int i = 0; i < kStageCount; ++i)
+        m_histograms[i].clear();
+
+    emit statisticsChanged();
+}
+
+/**
+ * @brief Called (from the render thread) when the scene graph swaps a
+ *        frame, records the latency of the published data (if any)
+ */
+void LatencyMonitor::onFrameSwapped() {
+    const qint64 timestamp = m_pendingRender.fetchAndStoreAcquire(0);
+    if (timestamp > 0) {
+        record(kRender, timestamp, MonotonicTime());
+        m_displayedTimestamp.storeRelease(timestamp);
+    }
+}
+
+/**
+ * @brief Writes the statistics and the histogram of each stage to a CSV
+ *        file in the application folder
+ *
+ * @returns the path of the file, or an empty string on failure
+ */
+QString LatencyMonitor::exportReport() {
+    const QString path = QString("%1/%2/Latency").arg(
+                QDir::homePath(), qApp->applicationName());
+    QDir dir(path);
+    if (!dir.exists())
+        dir.mkpath(".");
+
+    const QString name = QDateTime::currentDateTime().toString(
+                "yyyy-MM-dd_HH-mm-ss") + ".csv";
+    QFile file(dir.filePath(name));
+    if (!file.open(QFile::WriteOnly)) {
+        qWarning() << "Cannot open" << file.fileName() << "for writting";
+        return QString();
+    }
+
+    // Summary (in microseconds)
+    file.write("stage,count,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n");
+    for (int i = 0; i < kStageCount; ++i) {
+        const LatencyHistogram& h = m_histograms[i];
+        file.write(QString("%1,%2,%3,%4,%5,%6,%7,%8\n").arg(
+                       StageName(i),
+                       QString::number(h.count()),
+                       QString::number(h.mean() / 1e3, 'f', 1),
+                       QString::number(h.percentile(0.5) / 1e3, 'f', 1),
+                       QString::number(h.percentile(0.9) / 1e3, 'f', 1),
+                       QString::number(h.percentile(0.99) / 1e3, 'f', 1),
+                       QString::number(h.percentile(0.999) / 1e3, 'f', 1),
+                       QString::number(h.maximum() / 1e3, 'f', 1))
+                   .toUtf8());
+    }
+
+    // Non-empty buckets (in nanoseconds)
+    file.write("\nstage,lower_ns,upper_ns,count\n");
+    for (int i = 0; i < kStageCount; ++i) {
+        const LatencyHistogram& h = m_histograms[i];
+        for (int b = 0; b < h.bucketCount(); ++b) {
+            if (h.bucketCount(b) <= 0)
+                continue;
+
+            file.write(QString("%1,%2,%3,%4\n").arg(
+                           StageName(i),
+                           QString::number(LatencyHistogram::BucketLowerBound(b)),
+                           QString::number(LatencyHistogram::BucketUpperBound(b)),
+                           QString::number(h.bucketCount(b))).toUtf8());
+        }
+    }
+
+    return file.fileName();
+}
+
+/**
+ * @returns the name of the given @a stage
+ */
+QString LatencyMonitor::StageName(const int stage) {
+    switch (stage) {
+    case kDispatch:
+        return "dispatch";
+    case kParse:
+        return "parse";
+    case kCsv:
+        return "csv";
+    case kLog:
+        return "log";
+    case kRender:
+        return "render";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LATENCY_MONITOR_H
+#define LATENCY_MONITOR_H
+
+#include <QTimer>
+#include <QObject>
+#include <QVariantList>
+#include <QAtomicInteger>
+
+class FrameBatch;
+
+/**
+ * @brief Histogram of latencies that can be updated from any thread
+ *
+ * Values (in nanoseconds) are counted in log-linear buckets, each power of
+ * two is divided in 16 buckets, so that percentiles are reported with an
+ * error below 6.25% between 16 ns and ~18 minutes. Recording a value is
+ * a handful of relaxed atomic operations, no locks or allocations.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    qint64 count() const;
+    qint64 maximum() const;
+    double mean() const;
+    qint64 percentile(const double quantile) const;
+
+    int bucketCount() const;
+    qint64 bucketCount(const int bucket) const;
+    static qint64 BucketLowerBound(const int bucket);
+    static qint64 BucketUpperBound(const int bucket);
+
+    void clear();
+    void record(const qint64 latency);
+
+    static const int SUB_BUCKETS = 16;
+    static const int BUCKETS = 38 * SUB_BUCKETS;
+
+private:
+    static int BucketIndex(const qint64 latency);
+
+private:
+    QAtomicInteger<qint64> m_count;
+    QAtomicInteger<qint64> m_sum;
+    QAtomicInteger<qint64> m_maximum;
+    QAtomicInteger<quint32> m_buckets[BUCKETS];
+};
+
+/**
+ * @brief Measures how old the data is at each stage of the pipeline
+ *
+ * Every packet is timestamped by the frame reader when it is read from
+ * the transport (see @c MonotonicTime()), the latency of each stage is the
+ * time elapsed between that moment and the end of the stage:
+ *
+ *     - @c kDispatch: the packet was merged and handed to the GUI thread
+ *     - @c kParse: the packet was parsed
+ *     - @c kCsv: the CSV writer thread wrote the row of the packet to disk
+ *     - @c kLog: the log writer thread wrote the packet to the raw log
+ *     - @c kRender: the scene graph rendered a frame with the packet
+ *
+ * The logging stages include the time that the packets wait in memory
+ * before the writer threads write them (see @c AsyncFileWriter).
+ *
+ * The render stage only measures the newest packet of each published
+ * update, since that is the one that is shown on the dashboard. The
+ * @c dataAge property is the age of the data that is currently shown.
+ */
+class LatencyMonitor : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QVariantList stages
+               READ stages
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(double dataAge
+               READ dataAge
+               NOTIFY statisticsChanged)
+
+signals:
+    void statisticsChanged();
+
+public:
+    enum Stage {
+        kDispatch,
+        kParse,
+        kCsv,
+        kLog,
+        kRender,
+        kStageCount
+    };
+
+    static LatencyMonitor* getInstance();
+
+    double dataAge() const;
+    QVariantList stages() const;
+    const LatencyHistogram& histogram(const Stage stage) const;
+
+    void record(const Stage stage, const qint64 timestamp, const qint64 now);
+    void record(const Stage stage, const FrameBatch& batch, const qint64 now);
+    void markPublished(const qint64 timestamp);
+
+public slots:
+    void reset();
+    void onFrameSwapped();
+    QString exportReport();
+
+private:
+    LatencyMonitor();
+
+    static QString StageName(const int stage);
+
+private:
+    QTimer m_timer;
+    QAtomicInteger<qint64> m_pendingRender;
+    QAtomicInteger<qint64> m_displayedTimestamp;
+    LatencyHistogram m_histograms[kStageCount];
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QHostAddress>
+
+#include "NetworkTransport.h"
+
+/**
+ * Creates a (closed) transport for the given @a protocol, @a host and
+ * @a port
+ */
+NetworkTransport::NetworkTransport(const Protocol protocol,
+                                   const QString& host,
+                                   const quint16 port,
+                                   QObject* parent) : Transport(parent),
+    m_host(host),
+    m_port(port),
+    m_protocol(protocol),
+    m_tcp(Q_NULLPTR),
+    m_udp(Q_NULLPTR),
+    m_datagramOffset(0)
+{
+    QAbstractSocket* s;
+    if (m_protocol == kTcp)
+        s = m_tcp = new QTcpSocket(this);
+    else
+        s = m_udp = new QUdpSocket(this);
+
+    connect(s, &QAbstractSocket::readyRead,
+            this, &NetworkTransport::readyRead);
+    connect(s, static_cast<void (QAbstractSocket::*)(QAbstractSocket::SocketError)>(
+                &QAbstractSocket::error),
+            this, &NetworkTransport::onError);
+}
+
+/**
+ * Closes the socket
+ */
+NetworkTransport::~NetworkTransport() {
+    close();
+}
+
+/**
+ * @returns a name that identifies the protocol, host and port
+ */
+QString NetworkTransport::name() const {
+    const QString scheme = (m_protocol == kTcp) ? "tcp" : "udp";
+    return QString("%1-%2-%3").arg(scheme,
+                                   m_host.isEmpty() ? "any" : m_host,
+                                   QString::number(m_port));
+}
+
+/**
+ * @returns @c true if the socket is connected (TCP) or bound (UDP)
+ */
+bool NetworkTransport::isOpen() const {
+    return socket()->state() != QAbstractSocket::UnconnectedState;
+}
+
+/**
+ * @returns the description of the last error of the socket
+ */
+QString NetworkTransport::errorString() const {
+    return socket()->errorString();
+}
+
+/**
+ * Starts connecting to the host (TCP) or binds to the port (UDP)
+ */
+bool NetworkTransport::open() {
+    if (m_protocol == kTcp) {
+        m_tcp->connectToHost(m_host, m_port, QIODevice::ReadOnly);
+        return true;
+    }
+
+    const QHostAddress address = m_host.isEmpty() ?
+                QHostAddress(QHostAddress::Any) : QHostAddress(m_host);
+    return m_udp->bind(address, m_port, QUdpSocket::ShareAddress);
+}
+
+/**
+ * Closes the socket
+ */
+void NetworkTransport::close() {
+    socket()->abort();
+    m_datagram.clear();
+    m_datagramOffset = 0;
+}
+
+/**
+ * Reads up to @a maxSize bytes into the given @a data buffer, for UDP,
+ * the data of datagrams that do not fit is returned in the next calls
+ */
+qint64 NetworkTransport::read(char* data, const qint64 maxSize) {
+    if (m_protocol == kTcp)
+        return m_tcp->read(data, maxSize);
+
+    // Get the next datagram
+    if (m_datagramOffset >= m_datagram.size()) {
+        if (!m_udp->hasPendingDatagrams())
+            return 0;
+
+        m_datagramOffset = 0;
+        m_datagram.resize(static_cast<int>(
+                              qMax<qint64>(0, m_udp->pendingDatagramSize())));
+        const qint64 size = m_udp->readDatagram(m_datagram.data(),
+                                                m_datagram.size());
+        m_datagram.resize(static_cast<int>(qMax<qint64>(0, size)));
+    }
+
+    // Copy the pending data of the datagram
+    const int bytes = static_cast<int>(
+                qMin<qint64>(maxSize, m_datagram.size() - m_datagramOffset));
+    memcpy(data, m_datagram.constData() + m_datagramOffset,
+           static_cast<size_t>(bytes));
+    m_datagramOffset += bytes;
+    return bytes;
+}
+
+/**
+ * Reports errors that close the connection (datagram errors are ignored)
+ */
+void NetworkTransport::onError(QAbstractSocket::SocketError error) {
+    if (m_protocol == kUdp && error == QAbstractSocket::DatagramTooLargeError)
+        return;
+
+    emit errorOccurred(socket()->errorString());
+}
+
+/**
+ * @returns the socket used by the transport
+ */
+QAbstractSocket* NetworkTransport::socket() const {
+    if (m_protocol == kTcp)
+        return m_tcp;
+
+    return m_udp;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_TRANSPORT_H
+#define NETWORK_TRANSPORT_H
+
+#include <QByteArray>
+#include <QAbstractSocket>
+
+#include "Transport.h"
+
+class QTcpSocket;
+class QUdpSocket;
+
+/**
+ * @brief Reads data from a TCP connection or from UDP datagrams
+ *
+ * In TCP mode the transport connects to the given host (e.g. a relay of a
+ * remote antenna), the connection is established asynchronously and a
+ * failure is reported with @c errorOccurred().
+ *
+ * In UDP mode the transport binds to the given port (on the given address,
+ * or on every interface if the host is empty), the contents of each
+ * datagram are appended to the stream.
+ */
+class NetworkTransport : public Transport {
+    Q_OBJECT
+
+public:
+    enum Protocol {
+        kTcp,
+        kUdp
+    };
+
+    NetworkTransport(const Protocol protocol, const QString& host,
+                     const quint16 port, QObject* parent = Q_NULLPTR);
+    ~NetworkTransport();
+
+    QString name() const override;
+    bool isOpen() const override;
+    QString errorString() const override;
+
+    bool open() override;
+    void close() override;
+    qint64 read(char* data, const qint64 maxSize) override;
+
+private slots:
+    void onError(QAbstractSocket::SocketError error);
+
+private:
+    QAbstractSocket* socket() const;
+
+private:
+    QString m_host;
+    quint16 m_port;
+    Protocol m_protocol;
+
+    QTcpSocket* m_tcp;
+    QUdpSocket* m_udp;
+
+    int m_datagramOffset;
+    QByteArray m_datagram;
+};
+
+#endif
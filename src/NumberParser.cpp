@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QByteArray>
+
+#include "NumberParser.h"
+
+/**
+ * Powers of ten that can be represented exactly by a double
+ */
+static const double EXACT_POWERS[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Largest integer that can be represented exactly by a double (2^53)
+ */
+static const quint64 MAX_EXACT_MANTISSA = Q_UINT64_C(1) << 53;
+
+/**
+ * Maximum number of significant digits that fit in the 64-bit mantissa
+ */
+static const int MAX_DIGITS = 19;
+
+/**
+ * @returns @c true if the given character is a decimal digit
+ */
+static inline bool IsDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Removes leading and trailing spaces from the range [@a begin, @a end)
+ */
+static inline void Trim(const char*& begin, const char*& end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+        ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+        --end;
+}
+
+/**
+ * Converts the unsigned digits in [@a begin, @a end) to @a value
+ *
+ * @returns @c false if the range is empty, contains any other character or
+ *          if the number does not fit in 64 bits
+ */
+static bool ParseDigits(const char* begin, const char* end, quint64& value) {
+    value = 0;
+    if (begin == end)
+        return false;
+
+    for (const char* p = begin; p < end; ++p) {
+        if (!IsDigit(*p))
+            return false;
+
+        const quint64 digit = static_cast<quint64>(*p - '0');
+        if (value > (Q_UINT64_C(0xFFFFFFFFFFFFFFFF) - digit) / 10)
+            return false;
+
+        value = value * 10 + digit;
+    }
+
+    return true;
+}
+
+/**
+ * Converts the signed integer in [@a begin, @a end) to @a value
+ */
+bool ParseInt(const char* begin, const char* end, qint64& value) {
+    Trim(begin, end);
+
+    // Get sign
+    bool negative = false;
+    if (begin < end && (*begin == '+' || *begin == '-')) {
+        negative = (*begin == '-');
+        ++begin;
+    }
+
+    // Get magnitude & check range
+    quint64 magnitude;
+    const quint64 limit = negative ? Q_UINT64_C(0x8000000000000000) :
+                                     Q_UINT64_C(0x7FFFFFFFFFFFFFFF);
+    if (!ParseDigits(begin, end, magnitude) || magnitude > limit) {
+        value = 0;
+        return false;
+    }
+
+    value = negative ? static_cast<qint64>(0 - magnitude) :
+                       static_cast<qint64>(magnitude);
+    return true;
+}
+
+/**
+ * Converts the unsigned integer in [@a begin, @a end) to @a value
+ */
+bool ParseUInt(const char* begin, const char* end, quint64& value) {
+    Trim(begin, end);
+
+    if (begin < end && *begin == '+')
+        ++begin;
+
+    if (!ParseDigits(begin, end, value)) {
+        value = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Converts the decimal number in [@a begin, @a end) to @a value
+ *
+ * Most numbers sent by the CanSat have less than 16 significant digits and
+ * a small exponent, these are converted with a single (correctly rounded)
+ * multiplication or division, because both the mantissa and the power of
+ * ten are represented exactly by a double (Clinger's fast path).
+ *
+ * Any other input (e.g. "nan", "inf" or more digits than we can handle
+ * exactly) is passed to @c QByteArray::toDouble(), which is also
+ * locale-independent, but requires a copy of the data.
+ */
+bool ParseDouble(const char* begin, const char* end, double& value) {
+    Trim(begin, end);
+
+    const char* p = begin;
+    bool exact = true;
+    bool negative = false;
+    bool hasDigits = false;
+    int digits = 0;
+    int exponent = 0;
+    quint64 mantissa = 0;
+
+    // Get sign
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // Get integer part
+    for (; p < end && IsDigit(*p); ++p) {
+        hasDigits = true;
+        if (digits < MAX_DIGITS) {
+            mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+            if (mantissa > 0)
+                ++digits;
+        }
+
+        else {
+            ++exponent;
+            exact &= (*p == '0');
+        }
+    }
+
+    // Get fractional part
+    if (p < end && *p == '.') {
+        for (++p; p < end && IsDigit(*p); ++p) {
+            hasDigits = true;
+            if (digits < MAX_DIGITS) {
+                mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+                if (mantissa > 0)
+                    ++digits;
+
+                --exponent;
+            }
+
+            else
+                exact &= (*p == '0');
+        }
+    }
+
+    // Get exponent
+    if (hasDigits && p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExp = false;
+        if (p < end && (*p == '+' || *p == '-')) {
+            negativeExp = (*p == '-');
+            ++p;
+        }
+
+        int exp = 0;
+        const char* expBegin = p;
+        for (; p < end && IsDigit(*p); ++p)
+            exp = qMin(exp * 10 + (*p - '0'), 100000);
+
+        if (p == expBegin)
+            hasDigits = false;
+
+        exponent += negativeExp ? -exp : exp;
+    }
+
+    // Fast path
+    if (hasDigits && p == end && exact) {
+        if (mantissa == 0) {
+            value = negative ? -0.0 : 0.0;
+            return true;
+        }
+
+        if (mantissa <= MAX_EXACT_MANTISSA && exponent >= -22 && exponent <= 22) {
+            value = static_cast<double>(mantissa);
+            if (exponent < 0)
+                value /= EXACT_POWERS[-exponent];
+            else
+                value *= EXACT_POWERS[exponent];
+
+            if (negative)
+                value = -value;
+
+            return true;
+        }
+    }
+
+    // Slow path
+    bool ok = false;
+    value = QByteArray(begin, static_cast<int>(end - begin)).toDouble(&ok);
+    if (!ok)
+        value = 0;
+
+    return ok;
+}
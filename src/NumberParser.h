@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NUMBER_PARSER_H
+#define NUMBER_PARSER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Locale-independent number conversion functions
+ *
+ * These functions convert the characters in the range [@a begin, @a end)
+ * directly, without copying them into a @c QString or a null-terminated
+ * buffer. The decimal separator is always '.', regardless of the system
+ * locale. Leading and trailing spaces are ignored, any other character
+ * that is not part of the number makes the conversion fail.
+ *
+ * On failure, the functions return @c false and set @a value to 0, which is
+ * the same behavior of the @c QString conversion functions.
+ */
+bool ParseInt(const char* begin, const char* end, qint64& value);
+bool ParseUInt(const char* begin, const char* end, quint64& value);
+bool ParseDouble(const char* begin, const char* end, double& value);
+
+#endif
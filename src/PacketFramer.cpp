@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include "PacketFramer.h"
+
+/**
+ * Returns a pointer to the first occurrence of @c HEADER_CODE in the
+ * [@a begin, @a end) range, or @c Q_NULLPTR if the header is not found.
+ *
+ * Candidates are located with @c memchr(), which is vectorized by the C
+ * libraries of all the platforms that we support, so that only the bytes
+ * that match the first character of the header are compared as a string.
+ */
+static const char* FindHeader(const char* begin, const char* end) {
+    const int length = HEADER_CODE.size();
+    const char first = HEADER_CODE.at(0);
+
+    const char* candidate = begin;
+    while (end - candidate >= length) {
+        const size_t range = static_cast<size_t>(end - candidate - length + 1);
+        candidate = static_cast<const char*>(memchr(candidate, first, range));
+        if (!candidate)
+            break;
+
+        if (memcmp(candidate, HEADER_CODE.constData(), length) == 0)
+            return candidate;
+
+        ++candidate;
+    }
+
+    return Q_NULLPTR;
+}
+
+/**
+ * Initializes the ring buffer, the given @a capacity is rounded up to the
+ * next power of two so that ring positions can be obtained with a mask.
+ *
+ * If more than @a maxFrameSize bytes are buffered without receiving an EOT
+ * byte, the framer shall re-synchronize with the stream.
+ */
+PacketFramer::PacketFramer(const int capacity, const int maxFrameSize) :
+    m_capacity(1),
+    m_maxFrameSize(maxFrameSize),
+    m_droppedBytes(0),
+    m_head(0),
+    m_scan(0),
+    m_tail(0)
+{
+    while (m_capacity < capacity)
+        m_capacity <<= 1;
+
+    m_mask = static_cast<quint64>(m_capacity - 1);
+    m_ring.resize(2 * m_capacity);
+}
+
+/**
+ * @returns the number of bytes that are stored in the ring and that have
+ *          not been handed out as a packet yet
+ */
+int PacketFramer::size() const {
+    return static_cast<int>(m_tail - m_head);
+}
+
+/**
+ * @returns the maximum number of bytes that can be buffered
+ */
+int PacketFramer::capacity() const {
+    return m_capacity;
+}
+
+/**
+ * @returns the number of garbage bytes that were discarded while
+ *          re-synchronizing with the stream
+ */
+qint64 PacketFramer::droppedBytes() const {
+    return m_droppedBytes;
+}
+
+/**
+ * Discards all buffered data and resets the dropped bytes counter
+ */
+void PacketFramer::clear() {
+    m_head = 0;
+    m_scan = 0;
+    m_tail = 0;
+    m_droppedBytes = 0;
+}
+
+/**
+ * @brief Drops buffered data up to the next @c HEADER_CODE
+ *
+ * The search starts after the first buffered byte, so that a packet whose
+ * EOT byte was lost is discarded. If no header is found, only the last
+ * bytes (which could be the beginning of a header) are kept.
+ */
+void PacketFramer::resync() {
+    if (size() <= 0)
+        return;
+
+    const char* begin = contiguous(m_head, size());
+    const char* header = FindHeader(begin + 1, begin + size());
+
+    if (header)
+        drop(m_head + static_cast<quint64>(header - begin));
+    else
+        drop(m_tail - qMin(size() - 1, HEADER_CODE.size() - 1));
+}
+
+/**
+ * @brief Returns a pointer to the largest contiguous free region of the ring
+ *
+ * The size of the region is written to @a length, callers are expected to
+ * write up to @a length bytes into the region and then call @c commit() with
+ * the number of bytes that were actually written. @a length shall be 0 if
+ * the ring is full.
+ */
+char* PacketFramer::reserve(int& length) {
+    const int offset = static_cast<int>(m_tail & m_mask);
+    const int available = m_capacity - size();
+
+    length = qMin(available, m_capacity - offset);
+    return m_ring.data() + offset;
+}
+
+/**
+ * Marks @a length bytes of the region returned by @c reserve() as written
+ */
+void PacketFramer::commit(const int length) {
+    Q_ASSERT(length >= 0 && length <= m_capacity - size());
+    m_tail += static_cast<quint64>(length);
+}
+
+/**
+ * Copies up to @a length bytes from @a data into the ring buffer
+ *
+ * @returns the number of bytes that were copied, which can be less than
+ *          @a length if the ring is full
+ */
+int PacketFramer::write(const char* data, const int length) {
+    int written = 0;
+    while (written < length) {
+        int space = 0;
+        char* buffer = reserve(space);
+        if (space <= 0)
+            break;
+
+        const int bytes = qMin(space, length - written);
+        memcpy(buffer, data + written, static_cast<size_t>(bytes));
+        commit(bytes);
+        written += bytes;
+    }
+
+    return written;
+}
+
+/**
+ * @brief Obtains the next complete packet from the ring buffer
+ *
+ * Only the bytes that arrived since the last call are scanned for the
+ * @c EOT_PRIMARY byte. The packet is written to @a frame (without the EOT
+ * byte) as a view into the ring, empty packets are skipped.
+ *
+ * If the packet is preceded by garbage, or if it contains more than one
+ * @c HEADER_CODE (because the EOT byte of a previous packet was lost), only
+ * the data that follows the last header is handed out.
+ *
+ * @warning The returned view is only valid until the next call to any
+ *          non-const function of the framer. Receivers that need to keep
+ *          the packet must make a deep copy of it.
+ *
+ * @returns @c true if a packet was found
+ */
+bool PacketFramer::nextFrame(QByteArray& frame) {
+    const char eot = EOT_PRIMARY.toLatin1();
+
+    while (m_scan < m_tail) {
+        // Scan the contiguous segment that follows the last scan position
+        const int offset = static_cast<int>(m_scan & m_mask);
+        const int length = static_cast<int>(qMin<quint64>(m_tail - m_scan,
+                                                          m_capacity - offset));
+        const char* segment = m_ring.constData() + offset;
+        const char* match = static_cast<const char*>(
+                    memchr(segment, eot, static_cast<size_t>(length)));
+
+        // No EOT byte in this segment, continue with the next one (if any)
+        if (!match) {
+            m_scan += static_cast<quint64>(length);
+            continue;
+        }
+
+        // Obtain packet boundaries & consume the packet
+        const quint64 begin = m_head;
+        const quint64 end = m_scan + static_cast<quint64>(match - segment);
+        m_head = end + 1;
+        m_scan = end + 1;
+
+        // Ignore empty packets
+        if (end <= begin)
+            continue;
+
+        // Skip garbage that precedes the last header of the packet
+        int bytes = static_cast<int>(end - begin);
+        const char* data = contiguous(begin, bytes);
+        const char* last = Q_NULLPTR;
+        const char* header = FindHeader(data + 1, data + bytes);
+        while (header) {
+            last = header;
+            header = FindHeader(header + 1, data + bytes);
+        }
+
+        if (last) {
+            const int garbage = static_cast<int>(last - data);
+            m_droppedBytes += garbage;
+            bytes -= garbage;
+            data = last;
+        }
+
+        // Re-use the given byte array to avoid allocating a new header
+        frame.setRawData(data, static_cast<uint>(bytes));
+        return true;
+    }
+
+    // The EOT byte of the current packet was probably lost, re-synchronize
+    while (size() > m_maxFrameSize)
+        resync();
+
+    return false;
+}
+
+/**
+ * Discards all buffered data that precedes the absolute ring @a position
+ */
+void PacketFramer::drop(const quint64 position) {
+    m_droppedBytes += static_cast<qint64>(position - m_head);
+    m_head = position;
+    m_scan = qMax(m_scan, m_head);
+}
+
+/**
+ * Returns a pointer to @a length contiguous bytes that start at the absolute
+ * ring position @a begin, copying the wrapped part into the mirror area
+ * if required
+ */
+const char* PacketFramer::contiguous(const quint64 begin, const int length) {
+    char* ring = m_ring.data();
+    const int offset = static_cast<int>(begin & m_mask);
+
+    const int wrapped = offset + length - m_capacity;
+    if (wrapped > 0)
+        memcpy(ring + m_capacity, ring, static_cast<size_t>(wrapped));
+
+    return ring + offset;
+}
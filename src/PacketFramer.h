@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PACKET_FRAMER_H
+#define PACKET_FRAMER_H
+
+#include <QByteArray>
+
+#include "Constants.h"
+
+/**
+ * @brief Splits a raw byte stream into @c EOT_PRIMARY terminated packets
+ *
+ * Incoming data is written directly into a fixed-capacity ring buffer, the
+ * framer remembers where the last EOT scan stopped so that every byte is
+ * only looked at once, and complete packets are handed out as views into
+ * the ring (no allocations or copies are done in the hot path).
+ *
+ * The ring is followed by a mirror area of the same size, when a packet
+ * wraps around the end of the ring, its wrapped part is copied into the
+ * mirror so that the packet can still be handed out as a contiguous view.
+ *
+ * If noise corrupts a packet, the framer re-synchronizes with the stream by
+ * searching for the next @c HEADER_CODE and dropping only the garbage that
+ * precedes it, the number of dropped bytes is reported by @c droppedBytes().
+ */
+class PacketFramer {
+public:
+    explicit PacketFramer(const int capacity = MAX_BUFFER_SIZE,
+                          const int maxFrameSize = MAX_FRAME_SIZE);
+
+    int size() const;
+    int capacity() const;
+    qint64 droppedBytes() const;
+
+    void clear();
+    void resync();
+
+    char* reserve(int& length);
+    void commit(const int length);
+    int write(const char* data, const int length);
+
+    bool nextFrame(QByteArray& frame);
+
+private:
+    void drop(const quint64 position);
+    const char* contiguous(const quint64 begin, const int length);
+
+private:
+    int m_capacity;
+    int m_maxFrameSize;
+    qint64 m_droppedBytes;
+    quint64 m_mask;
+    quint64 m_head;
+    quint64 m_scan;
+    quint64 m_tail;
+    QByteArray m_ring;
+};
+
+#endif
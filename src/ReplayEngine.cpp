@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QUrl>
+#include <QFile>
+#include <QDebug>
+
+#include "Constants.h"
+#include "DataParser.h"
+#include "NumberParser.h"
+#include "PacketFramer.h"
+#include "ReplayEngine.h"
+#include "SerialManager.h"
+
+/**
+ * Interval between playback steps (in milliseconds)
+ */
+static const int PLAYBACK_INTERVAL = 15;
+
+/**
+ * Maximum time spent in a single step when playing as fast as possible
+ * (in nanoseconds)
+ */
+static const qint64 MAX_STEP_TIME = 8 * 1000 * 1000;
+
+/**
+ * Number of packets handed to the parser at once while seeking
+ */
+static const int SEEK_BATCH_SIZE = 1024;
+
+/**
+ * Gets the mission time (in milliseconds) of the given raw packet
+ */
+static bool ExtractMissionTime(const char* data, const int size,
+                               quint64& missionTime) {
+    const char* end = data + size;
+    const char* field = data;
+
+    int index = 0;
+    for (const char* c = data; c <= end; ++c) {
+        if (c < end && *c != ',')
+            continue;
+
+        if (index == DataParser::kMisionTime)
+            return ParseUInt(field, c, missionTime);
+
+        field = c + 1;
+        ++index;
+    }
+
+    return false;
+}
+
+/**
+ * Constructor function, parsed data is sent to the given @a parser when
+ * seeking through the recording
+ */
+ReplayEngine::ReplayEngine(DataParser* parser, QObject* parent) :
+    QObject(parent),
+    m_parser(parser),
+    m_speed(1),
+    m_wallOrigin(0),
+    m_replayOrigin(0),
+    m_isCapture(false),
+    m_logFrame(0),
+    m_framePending(false),
+    m_frameTime(0),
+    m_firstTime(0),
+    m_lastTime(0),
+    m_position(0),
+    m_currentFrame(0)
+{
+    Q_ASSERT(parser);
+
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(PLAYBACK_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &ReplayEngine::onTimeout);
+}
+
+/**
+ * Stops the playback and closes the recording
+ */
+ReplayEngine::~ReplayEngine() {
+    m_timer.stop();
+    m_capture.close();
+}
+
+/**
+ * @returns @c true if a recording is loaded
+ */
+bool ReplayEngine::isOpen() const {
+    return m_isCapture ? m_capture.isOpen() : m_log.count() > 0;
+}
+
+/**
+ * @returns @c true if the recording is being played back
+ */
+bool ReplayEngine::isPlaying() const {
+    return m_timer.isActive();
+}
+
+/**
+ * @returns the name of the loaded recording
+ */
+QString ReplayEngine::fileName() const {
+    return m_fileName;
+}
+
+/**
+ * @returns the playback speed multiplier, 0 means as fast as possible
+ */
+double ReplayEngine::speed() const {
+    return m_speed;
+}
+
+/**
+ * @returns the length of the recording (in milliseconds)
+ */
+qint64 ReplayEngine::duration() const {
+    return (m_lastTime - m_firstTime) / 1000000;
+}
+
+/**
+ * @returns the playback position (in milliseconds since the beginning of
+ *          the recording)
+ */
+qint64 ReplayEngine::position() const {
+    return m_position / 1000000;
+}
+
+/**
+ * @returns the number of packets in the recording
+ */
+qint64 ReplayEngine::frameCount() const {
+    return m_isCapture ? m_capture.frameCount() : m_log.count();
+}
+
+/**
+ * @returns the number of packets that have been delivered
+ */
+qint64 ReplayEngine::currentFrame() const {
+    return m_currentFrame;
+}
+
+/**
+ * @brief Loads the capture or raw log with the given @a fileName (which
+ *        can also be a local URL)
+ *
+ * The parser is reset, so that the playback starts with a clean state.
+ *
+ * @returns @c true on success
+ */
+bool ReplayEngine::open(const QString& fileName) {
+    close();
+
+    QString path = fileName;
+    const QUrl url(fileName);
+    if (url.isLocalFile())
+        path = url.toLocalFile();
+
+    // Load the recording
+    m_isCapture = path.endsWith(".kcap", Qt::CaseInsensitive);
+    const bool ok = m_isCapture ? m_capture.open(path) : loadLog(path);
+    if (!ok || frameCount() <= 0) {
+        qWarning() << "Cannot replay" << path;
+        close();
+        return false;
+    }
+
+    // Get the time span of the recording
+    peekFrame();
+    m_firstTime = m_frameTime;
+    m_lastTime = m_isCapture ? m_capture.lastTimestamp() :
+                               m_log.frameTimestamp(m_log.count() - 1);
+    m_lastTime = qMax(m_lastTime, m_firstTime);
+
+    // Start with a clean state
+    m_fileName = path;
+    m_parser->resetData();
+
+    emit fileChanged();
+    emit positionChanged();
+    return true;
+}
+
+/**
+ * Stops the playback and unloads the recording
+ */
+void ReplayEngine::close() {
+    setPlaying(false);
+
+    m_capture.close();
+    m_log.clear();
+    m_batch.clear();
+    m_fileName.clear();
+
+    m_logFrame = 0;
+    m_framePending = false;
+    m_firstTime = 0;
+    m_lastTime = 0;
+    m_position = 0;
+    m_currentFrame = 0;
+
+    emit fileChanged();
+    emit positionChanged();
+}
+
+/**
+ * Starts (or resumes) the playback, the recording is played back from its
+ * beginning if its end was already reached
+ */
+void ReplayEngine::play() {
+    if (!isOpen())
+        return;
+
+    if (!peekFrame())
+        stop();
+
+    restartClock();
+    setPlaying(true);
+}
+
+/**
+ * Pauses the playback at the current position
+ */
+void ReplayEngine::pause() {
+    setPlaying(false);
+}
+
+/**
+ * Stops the playback and goes back to the beginning of the recording
+ */
+void ReplayEngine::stop() {
+    setPlaying(false);
+
+    if (isOpen() && rewind()) {
+        m_parser->resetData();
+        emit positionChanged();
+    }
+}
+
+/**
+ * Processes the rest of the recording at once, only the final state of
+ * the parser is published
+ */
+void ReplayEngine::jumpToEnd() {
+    seek(duration() + 1);
+}
+
+/**
+ * @brief Moves the playback to the given @a position (in milliseconds
+ *        since the beginning of the recording)
+ *
+ * Every packet up to the given position is parsed with publishing and
+ * logging suspended, the playback continues from the new position if it
+ * was playing.
+ */
+void ReplayEngine::seek(const qint64 position) {
+    if (!isOpen())
+        return;
+
+    const bool playing = isPlaying();
+    const qint64 target = m_firstTime + qMax<qint64>(0, position) * 1000000;
+
+    m_timer.stop();
+    m_parser->setLoggingSuspended(true);
+    m_parser->setPublishingSuspended(true);
+
+    // Go back to the beginning of the recording
+    if (target < m_firstTime + m_position) {
+        m_parser->resetData();
+        rewind();
+    }
+
+    // Parse every packet up to the target position
+    m_batch.clear();
+    const qint64 now = MonotonicTime();
+    while (peekFrame() && m_frameTime <= target) {
+        takeFrame(m_batch, now);
+        if (m_batch.count() >= SEEK_BATCH_SIZE) {
+            m_parser->parseBatch(m_batch);
+            m_batch.clear();
+        }
+    }
+
+    m_parser->parseBatch(m_batch);
+    m_batch.clear();
+    m_parser->setPublishingSuspended(false);
+    m_parser->setLoggingSuspended(false);
+
+    // Update the position
+    m_position = qBound<qint64>(0, target, m_lastTime) - m_firstTime;
+    emit positionChanged();
+
+    // Resume the playback
+    if (playing && peekFrame()) {
+        restartClock();
+        m_timer.start();
+    }
+
+    else if (playing) {
+        emit playingChanged();
+        emit finished();
+    }
+}
+
+/**
+ * Changes the playback @a speed multiplier, use 0 to play the recording
+ * as fast as possible
+ */
+void ReplayEngine::setSpeed(const double speed) {
+    const double value = qMax(0.0, speed);
+    if (qFuzzyCompare(m_speed + 1, value + 1))
+        return;
+
+    m_speed = value;
+    m_timer.setInterval(m_speed > 0 ? PLAYBACK_INTERVAL : 0);
+    restartClock();
+
+    emit speedChanged();
+}
+
+/**
+ * @brief Delivers the packets whose (scaled) recorded time has elapsed
+ *
+ * When playing as fast as possible, packets are delivered until the step
+ * takes more than @c MAX_STEP_TIME.
+ */
+void ReplayEngine::onTimeout() {
+    const qint64 now = MonotonicTime();
+    const bool unlimited = m_speed <= 0;
+
+    qint64 target = m_lastTime;
+    if (!unlimited) {
+        const double elapsed = static_cast<double>(now - m_wallOrigin);
+        target = m_replayOrigin + static_cast<qint64>(elapsed * m_speed);
+    }
+
+    // Collect due packets
+    m_batch.clear();
+    while (peekFrame() && m_frameTime <= target) {
+        takeFrame(m_batch, now);
+
+        if (unlimited && (m_batch.count() % 64) == 0 &&
+                MonotonicTime() - now > MAX_STEP_TIME)
+            break;
+    }
+
+    // Deliver them through the normal reception path, recorded data is not
+    // written to the CSV file or to the database of the current session
+    m_parser->setLoggingSuspended(true);
+    SerialManager::getInstance()->replayPackets(m_batch);
+    m_parser->setLoggingSuspended(false);
+
+    // Advance the position smoothly between packets
+    if (!unlimited)
+        m_position = qBound(m_firstTime, target, m_lastTime) - m_firstTime;
+
+    emit positionChanged();
+
+    // End of the recording
+    if (!peekFrame()) {
+        setPlaying(false);
+        emit finished();
+    }
+}
+
+/**
+ * Goes back to the first packet of the recording
+ */
+bool ReplayEngine::rewind() {
+    m_logFrame = 0;
+    m_position = 0;
+    m_currentFrame = 0;
+    m_framePending = false;
+
+    if (m_isCapture)
+        return m_capture.rewind();
+
+    return true;
+}
+
+/**
+ * @brief Loads the raw log with the given @a fileName in memory
+ *
+ * The log is split into packets by a packet framer and each packet is
+ * timed with its mission time. If the mission time goes backwards (the
+ * CanSat was reset), the timing of the following packets continues from
+ * the last valid mission time.
+ */
+bool ReplayEngine::loadLog(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    const QByteArray data = file.readAll();
+
+    QByteArray packet;
+    PacketFramer framer;
+    quint64 lastMission = 0;
+    bool lastMissionValid = false;
+    qint64 timestamp = 0;
+
+    int offset = 0;
+    while (offset < data.size()) {
+        offset += framer.write(data.constData() + offset,
+                               data.size() - offset);
+
+        while (framer.nextFrame(packet)) {
+            quint64 mission;
+            if (ExtractMissionTime(packet.constData(), packet.size(),
+                                   mission)) {
+                if (lastMissionValid && mission >= lastMission)
+                    timestamp += static_cast<qint64>(mission - lastMission)
+                            * 1000000;
+
+                lastMission = mission;
+                lastMissionValid = true;
+            }
+
+            m_log.append(packet.constData(), packet.size(), timestamp);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Loads the next packet of the recording (if it is not loaded yet)
+ *
+ * @returns @c false at the end of the recording
+ */
+bool ReplayEngine::peekFrame() {
+    if (m_framePending)
+        return true;
+
+    if (m_isCapture)
+        m_framePending = m_capture.readFrame(m_frameTime, m_frame);
+
+    else if (m_logFrame < m_log.count()) {
+        m_frameTime = m_log.frameTimestamp(m_logFrame);
+        m_frame.setRawData(m_log.frameData(m_logFrame),
+                           static_cast<uint>(m_log.frameSize(m_logFrame)));
+        m_framePending = true;
+        ++m_logFrame;
+    }
+
+    return m_framePending;
+}
+
+/**
+ * Moves the loaded packet to the given @a batch, the packet is stamped
+ * with the given (monotonic) delivery @a timestamp, as if it had just been
+ * received
+ */
+void ReplayEngine::takeFrame(FrameBatch& batch, const qint64 timestamp) {
+    Q_ASSERT(m_framePending);
+
+    batch.append(m_frame.constData(), m_frame.size(), timestamp);
+    m_position = m_frameTime - m_firstTime;
+    m_framePending = false;
+    ++m_currentFrame;
+}
+
+/**
+ * Starts or stops the playback timer
+ */
+void ReplayEngine::setPlaying(const bool playing) {
+    if (playing == isPlaying())
+        return;
+
+    if (playing)
+        m_timer.start();
+    else
+        m_timer.stop();
+
+    emit playingChanged();
+}
+
+/**
+ * Maps the current wall-clock time to the current playback position
+ */
+void ReplayEngine::restartClock() {
+    m_wallOrigin = MonotonicTime();
+    m_replayOrigin = m_firstTime + m_position;
+}
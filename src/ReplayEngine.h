@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef REPLAY_ENGINE_H
+#define REPLAY_ENGINE_H
+
+#include <QTimer>
+#include <QObject>
+#include <QByteArray>
+
+#include "FrameBatch.h"
+#include "CaptureFile.h"
+
+class DataParser;
+
+/**
+ * @brief Plays back recorded telemetry through the normal reception path
+ *
+ * Binary captures (@c .kcap) are played back using the recorded reception
+ * timestamps. Raw logs do not store timestamps, so they are loaded in
+ * memory and timed with the mission time of each packet (packets with an
+ * invalid mission time are delivered together with the previous packet).
+ *
+ * During playback, packets are delivered with
+ * @c SerialManager::replayPackets(), so they are shown in the console and
+ * parsed exactly like received packets. The playback @c speed is a
+ * multiplier of the recorded time, use 0 to deliver packets as fast as
+ * possible (in slices of ~8 ms, so that the user interface stays
+ * responsive).
+ *
+ * Seeking (and @c jumpToEnd()) feeds the parser directly with publishing
+ * suspended, so that the final state of the parser, history and statistics
+ * is computed without emitting any per-packet signal. Seeking backwards
+ * resets the parser and processes the recording from its beginning.
+ *
+ * Replayed packets are never written to the CSV file or to the database,
+ * so that they are not mixed with (or repeated in) the session logs.
+ */
+class ReplayEngine : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY fileChanged)
+    Q_PROPERTY(bool loaded
+               READ isOpen
+               NOTIFY fileChanged)
+    Q_PROPERTY(bool playing
+               READ isPlaying
+               NOTIFY playingChanged)
+    Q_PROPERTY(double speed
+               READ speed
+               WRITE setSpeed
+               NOTIFY speedChanged)
+    Q_PROPERTY(qint64 duration
+               READ duration
+               NOTIFY fileChanged)
+    Q_PROPERTY(qint64 frameCount
+               READ frameCount
+               NOTIFY fileChanged)
+    Q_PROPERTY(qint64 position
+               READ position
+               NOTIFY positionChanged)
+    Q_PROPERTY(qint64 currentFrame
+               READ currentFrame
+               NOTIFY positionChanged)
+
+signals:
+    void finished();
+    void fileChanged();
+    void speedChanged();
+    void playingChanged();
+    void positionChanged();
+
+public:
+    explicit ReplayEngine(DataParser* parser, QObject* parent = Q_NULLPTR);
+    ~ReplayEngine();
+
+    bool isOpen() const;
+    bool isPlaying() const;
+    QString fileName() const;
+
+    double speed() const;
+    qint64 duration() const;
+    qint64 position() const;
+    qint64 frameCount() const;
+    qint64 currentFrame() const;
+
+public slots:
+    bool open(const QString& fileName);
+    void close();
+
+    void play();
+    void pause();
+    void stop();
+    void jumpToEnd();
+    void seek(const qint64 position);
+    void setSpeed(const double speed);
+
+private slots:
+    void onTimeout();
+
+private:
+    bool rewind();
+    bool loadLog(const QString& fileName);
+
+    bool peekFrame();
+    void takeFrame(FrameBatch& batch, const qint64 timestamp);
+    void setPlaying(const bool playing);
+    void restartClock();
+
+private:
+    DataParser* m_parser;
+
+    QTimer m_timer;
+    double m_speed;
+    qint64 m_wallOrigin;
+    qint64 m_replayOrigin;
+
+    QString m_fileName;
+    bool m_isCapture;
+    CaptureReader m_capture;
+    FrameBatch m_log;
+    int m_logFrame;
+
+    bool m_framePending;
+    qint64 m_frameTime;
+    QByteArray m_frame;
+
+    qint64 m_firstTime;
+    qint64 m_lastTime;
+    qint64 m_position;
+    qint64 m_currentFrame;
+
+    FrameBatch m_batch;
+};
+
+#endif
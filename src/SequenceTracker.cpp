@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include "SequenceTracker.h"
+
+/**
+ * Initializes the tracker, the first packet received defines the start of
+ * the sequence
+ */
+SequenceTracker::SequenceTracker(QObject* parent) : QObject(parent),
+    m_updateCount(0),
+    m_notifiedCount(0)
+{
+    clear();
+}
+
+/**
+ * Returns the number of unique packets received
+ */
+quint64 SequenceTracker::received() const {
+    return m_received;
+}
+
+/**
+ * Returns the number of missing packets, including the ones that are still
+ * inside the window (and may arrive late)
+ */
+quint64 SequenceTracker::lost() const {
+    return m_lost + m_pending;
+}
+
+/**
+ * Returns the number of missing packets that are still inside the window
+ */
+quint64 SequenceTracker::pending() const {
+    return m_pending;
+}
+
+/**
+ * Returns the number of packets that were received more than once
+ */
+quint64 SequenceTracker::duplicates() const {
+    return m_duplicates;
+}
+
+/**
+ * Returns the number of packets that arrived after a newer packet
+ */
+quint64 SequenceTracker::reordered() const {
+    return m_reordered;
+}
+
+/**
+ * Returns the number of times that the packet count was restarted
+ */
+quint64 SequenceTracker::resets() const {
+    return m_resets;
+}
+
+/**
+ * Returns the number of times that one or more packets were skipped
+ */
+quint64 SequenceTracker::gaps() const {
+    return m_gaps;
+}
+
+/**
+ * Returns the number of packets skipped by the last gap
+ */
+quint64 SequenceTracker::lastGap() const {
+    return m_lastGap;
+}
+
+/**
+ * Returns the number of packets skipped by the longest gap
+ */
+quint64 SequenceTracker::longestGap() const {
+    return m_longestGap;
+}
+
+/**
+ * Returns the ratio of missing packets during the whole session
+ */
+double SequenceTracker::lossRate() const {
+    const quint64 expected = m_received + lost();
+    if (expected == 0)
+        return 0;
+
+    return static_cast<double>(lost()) / expected;
+}
+
+/**
+ * Returns the ratio of missing packets inside the window
+ */
+double SequenceTracker::windowLossRate() const {
+    if (!m_started)
+        return 0;
+
+    const quint64 span = qMin<quint64>(m_newest - m_first + 1, kWindowSize);
+    return static_cast<double>(m_pending) / span;
+}
+
+/**
+ * Returns a single-line description of the counters, used for logging
+ */
+QString SequenceTracker::summary() const {
+    return QString("received %1, lost %2 (%3%), duplicates %4, reordered %5, "
+                   "resets %6, gaps %7 (longest %8)")
+            .arg(received())
+            .arg(lost())
+            .arg(lossRate() * 100, 0, 'f', 2)
+            .arg(duplicates())
+            .arg(reordered())
+            .arg(resets())
+            .arg(gaps())
+            .arg(longestGap());
+}
+
+/**
+ * Updates the counters with the given packet @a sequence number and
+ * @a missionTime, and returns how the packet was classified
+ */
+SequenceTracker::Result SequenceTracker::track(const quint64 sequence,
+                                               const quint32 missionTime) {
+    ++m_updateCount;
+
+    // First packet of the session
+    if (!m_started) {
+        restart(sequence, missionTime);
+        return kFirst;
+    }
+
+    // Newer packet, its mission time cannot go back
+    if (sequence > m_newest) {
+        if (missionTime < m_times[m_newest % kWindowSize]) {
+            ++m_resets;
+            restart(sequence, missionTime);
+            return kReset;
+        }
+
+        // Slide the window, packets that leave it are lost
+        const quint64 delta = sequence - m_newest;
+        if (delta >= kWindowSize) {
+            m_lost += m_pending;
+            m_pending = 0;
+            memset(m_bitmap, 0, sizeof(m_bitmap));
+        } else {
+            for (quint64 s = m_newest + 1; s <= sequence; ++s) {
+                if (s >= kWindowSize) {
+                    const quint64 old = s - kWindowSize;
+                    if (old >= m_first && !isReceived(old)) {
+                        --m_pending;
+                        ++m_lost;
+                    }
+                }
+
+                m_bitmap[(s % kWindowSize) / 64] &=
+                        ~(Q_UINT64_C(1) << (s % 64));
+            }
+        }
+
+        // Register the skipped packets
+        const quint64 missing = delta - 1;
+        if (missing > 0) {
+            const quint64 inWindow = qMin<quint64>(missing, kWindowSize - 1);
+            m_pending += inWindow;
+            m_lost += missing - inWindow;
+
+            ++m_gaps;
+            m_lastGap = missing;
+            m_longestGap = qMax(m_longestGap, missing);
+        }
+
+        ++m_received;
+        m_newest = sequence;
+        setReceived(sequence, missionTime);
+        return (missing > 0) ? kGap : kNext;
+    }
+
+    // Packet is too old to be a re-ordered packet
+    if (m_newest - sequence >= kWindowSize) {
+        ++m_resets;
+        restart(sequence, missionTime);
+        return kReset;
+    }
+
+    // Packet was already received, the mission time must be the same
+    if (isReceived(sequence)) {
+        if (m_times[sequence % kWindowSize] == missionTime) {
+            ++m_duplicates;
+            return kDuplicate;
+        }
+
+        ++m_resets;
+        restart(sequence, missionTime);
+        return kReset;
+    }
+
+    // Late packet, its mission time must be between the mission times of
+    // the previous and next packets that were received
+    bool consistent = true;
+    for (quint64 s = sequence; s > 0 && m_newest - (s - 1) < kWindowSize; --s) {
+        if (isReceived(s - 1)) {
+            consistent = missionTime >= m_times[(s - 1) % kWindowSize];
+            break;
+        }
+    }
+
+    for (quint64 s = sequence + 1; consistent && s <= m_newest; ++s) {
+        if (isReceived(s)) {
+            consistent = missionTime <= m_times[s % kWindowSize];
+            break;
+        }
+    }
+
+    if (!consistent) {
+        ++m_resets;
+        restart(sequence, missionTime);
+        return kReset;
+    }
+
+    // Packets before the first one were not expected (thus not pending)
+    if (sequence >= m_first)
+        --m_pending;
+
+    ++m_received;
+    ++m_reordered;
+    setReceived(sequence, missionTime);
+    return kLate;
+}
+
+/**
+ * Resets all the counters
+ */
+void SequenceTracker::clear() {
+    m_started = false;
+    m_first = 0;
+    m_newest = 0;
+    m_received = 0;
+    m_lost = 0;
+    m_pending = 0;
+    m_duplicates = 0;
+    m_reordered = 0;
+    m_resets = 0;
+    m_gaps = 0;
+    m_lastGap = 0;
+    m_longestGap = 0;
+    memset(m_bitmap, 0, sizeof(m_bitmap));
+    memset(m_times, 0, sizeof(m_times));
+
+    ++m_updateCount;
+    notify();
+}
+
+/**
+ * Emits the @c changed() signal if any packet was tracked since the last
+ * call
+ */
+void SequenceTracker::notify() {
+    if (m_notifiedCount != m_updateCount) {
+        m_notifiedCount = m_updateCount;
+        emit changed();
+    }
+}
+
+/**
+ * Starts a new sequence with the given packet, missing packets of the
+ * previous sequence will never arrive
+ */
+void SequenceTracker::restart(const quint64 sequence,
+                              const quint32 missionTime) {
+    m_lost += m_pending;
+    m_pending = 0;
+    memset(m_bitmap, 0, sizeof(m_bitmap));
+
+    m_started = true;
+    m_first = sequence;
+    m_newest = sequence;
+    ++m_received;
+    setReceived(sequence, missionTime);
+}
+
+/**
+ * Returns @c true if the given @a sequence number (which must be inside the
+ * window) was received
+ */
+bool SequenceTracker::isReceived(const quint64 sequence) const {
+    const quint64 bit = sequence % kWindowSize;
+    return (m_bitmap[bit / 64] >> (bit % 64)) & 1;
+}
+
+/**
+ * Marks the given @a sequence number as received
+ */
+void SequenceTracker::setReceived(const quint64 sequence,
+                                  const quint32 missionTime) {
+    const quint64 bit = sequence % kWindowSize;
+    m_bitmap[bit / 64] |= Q_UINT64_C(1) << (bit % 64);
+    m_times[bit] = missionTime;
+}
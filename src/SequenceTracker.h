@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SEQUENCE_TRACKER_H
+#define SEQUENCE_TRACKER_H
+
+#include <QObject>
+#include <QString>
+
+/**
+ * @brief Link quality accounting based on the packet count of each frame
+ *
+ * The tracker keeps a sliding window with the last @c kWindowSize sequence
+ * numbers (packet counts): one bit that tells if the packet was received
+ * and the mission time of the packet. Each packet is classified as:
+ *
+ *     - @c kNext:       the packet that follows the newest packet
+ *     - @c kGap:        a newer packet, one or more packets are missing
+ *     - @c kLate:       an older packet that was missing (re-ordered)
+ *     - @c kDuplicate:  a packet that was already received
+ *     - @c kReset:      the satellite restarted its packet count
+ *
+ * A packet is only considered a reset if its sequence number falls behind
+ * the window, or if its mission time is not consistent with the packets
+ * that surround it in the window (a re-ordered packet must be newer than
+ * the previous packet that was received, and a duplicate must have the
+ * same mission time as the original).
+ *
+ * Missing packets are counted as lost once they leave the window, until
+ * then they are pending and may still arrive late.
+ */
+class SequenceTracker : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(quint64 received
+               READ received
+               NOTIFY changed)
+    Q_PROPERTY(quint64 lost
+               READ lost
+               NOTIFY changed)
+    Q_PROPERTY(quint64 duplicates
+               READ duplicates
+               NOTIFY changed)
+    Q_PROPERTY(quint64 reordered
+               READ reordered
+               NOTIFY changed)
+    Q_PROPERTY(quint64 resets
+               READ resets
+               NOTIFY changed)
+    Q_PROPERTY(quint64 gaps
+               READ gaps
+               NOTIFY changed)
+    Q_PROPERTY(quint64 lastGap
+               READ lastGap
+               NOTIFY changed)
+    Q_PROPERTY(quint64 longestGap
+               READ longestGap
+               NOTIFY changed)
+    Q_PROPERTY(double lossRate
+               READ lossRate
+               NOTIFY changed)
+    Q_PROPERTY(double windowLossRate
+               READ windowLossRate
+               NOTIFY changed)
+
+signals:
+    void changed();
+
+public:
+    enum {
+        kWindowSize = 1024
+    };
+
+    enum Result {
+        kFirst,
+        kNext,
+        kGap,
+        kLate,
+        kDuplicate,
+        kReset
+    };
+    Q_ENUM(Result)
+
+    explicit SequenceTracker(QObject* parent = Q_NULLPTR);
+
+    quint64 received() const;
+    quint64 lost() const;
+    quint64 pending() const;
+    quint64 duplicates() const;
+    quint64 reordered() const;
+    quint64 resets() const;
+    quint64 gaps() const;
+    quint64 lastGap() const;
+    quint64 longestGap() const;
+    double lossRate() const;
+    double windowLossRate() const;
+    QString summary() const;
+
+    Result track(const quint64 sequence, const quint32 missionTime);
+
+public slots:
+    void clear();
+    void notify();
+
+private:
+    void restart(const quint64 sequence, const quint32 missionTime);
+    bool isReceived(const quint64 sequence) const;
+    void setReceived(const quint64 sequence, const quint32 missionTime);
+
+private:
+    bool m_started;
+    quint64 m_first;
+    quint64 m_newest;
+
+    quint64 m_received;
+    quint64 m_lost;
+    quint64 m_pending;
+    quint64 m_duplicates;
+    quint64 m_reordered;
+    quint64 m_resets;
+    quint64 m_gaps;
+    quint64 m_lastGap;
+    quint64 m_longestGap;
+
+    quint64 m_updateCount;
+    quint64 m_notifiedCount;
+
+    quint64 m_bitmap[kWindowSize / 64];
+    quint32 m_times[kWindowSize];
+};
+
+#endif
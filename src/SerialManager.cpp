@@ -26,12 +26,14 @@
 #include <QFile>
 #include <QTimer>
 #include <QDebug>
-#include <QSerialPort>
 #include <QSerialPortInfo>
 #include <QDesktopServices>
+#include <QRegularExpression>
 
 #include "Constants.h"
 #include "SerialManager.h"
+#include "TraceWriter.h"
+#include "LatencyMonitor.h"
 
 /**
  * @brief Pointer to the only instance of this class.
@@ -42,19 +44,49 @@
  */
 static SerialManager* instance = Q_NULLPTR;
 
+/**
+ * Maximum number of serial devices (radios) that can be read at once, the
+ * first three receivers are controlled by the user interface (primary and
+ * backup devices and network source), the rest are used by the sources
+ * given in the command line
+ */
+static const int MAX_RECEIVERS = 8;
+
 /**
  * @brief Constructor for the @a SerialManager class
  */
 SerialManager::SerialManager() :
     m_baudRate(9600),
-    m_dataLen(-1),
-    m_port(Q_NULLPTR),
+    m_draining(false),
+    m_drainPending(false),
+    m_replaying(false),
+    m_connected(false),
     m_enableFileLogging(false)
 {
-    connect(this, &SerialManager::packetReceived,
-            this, &SerialManager::formatReceivedPacket);
+    // Read and frame serial data in a dedicated thread, so that the GUI
+    // thread does not affect how fast we can react to incoming data
+    m_thread.setObjectName("Serial I/O");
+    m_thread.start(QThread::HighPriority);
+
+    // Create the primary receiver
+    receiver(0);
+
+    // Release packets held by the merger when they time out
+    m_receiversClock.start();
+    m_mergeTimer.setSingleShot(true);
+    m_mergeTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_mergeTimer, &QTimer::timeout,
+            this, &SerialManager::onFramesAvailable);
+
+    connect(this, &SerialManager::packetsReceived,
+            this, &SerialManager::formatReceivedBatch);
     connect(this, &SerialManager::connectionChanged,
             this, &SerialManager::configureLogFile);
+    connect(&m_packetLog, &AsyncFileWriter::statisticsChanged,
+            this, &SerialManager::logStatisticsChanged);
+
+    // Measure when the packets reach the raw log
+    m_packetLog.setLatencyStage(LatencyMonitor::kLog);
 
     QTimer::singleShot(500, this, &SerialManager::refreshSerialDevices);
 }
@@ -64,11 +96,16 @@ SerialManager::SerialManager() :
  *        the current log file
  */
 SerialManager::~SerialManager() {
-    if (m_port != Q_NULLPTR)
-        m_port->close();
+    m_thread.quit();
+    m_thread.wait();
 
-    if (m_packetLog.isOpen())
-        m_packetLog.close();
+    foreach (Receiver* receiver, m_receivers) {
+        delete receiver->queue;
+        delete receiver;
+    }
+
+    m_packetLog.close();
+    m_capture.close();
 }
 
 /**
@@ -92,14 +129,42 @@ int SerialManager::baudRate() const {
 }
 
 /**
- * @returns @c true if the application is connected to any serial
+ * @returns the number of receivers that can be used at the same time
+ */
+int SerialManager::maxReceivers() const {
+    return MAX_RECEIVERS;
+}
+
+/**
+ * @returns the number of packets that are waiting to be processed by the
+ *          GUI thread
+ */
+int SerialManager::queueDepth() const {
+    int depth = 0;
+    foreach (const Receiver* receiver, m_receivers)
+        depth += receiver->queue->size();
+
+    return depth;
+}
+
+/**
+ * @returns the number of packets that were discarded by the serial I/O
+ *          thread because the GUI thread could not keep up with them
+ */
+int SerialManager::droppedFrames() const {
+    qint64 frames = 0;
+    foreach (const Receiver* receiver, m_receivers)
+        frames += receiver->reader->droppedFrames();
+
+    return static_cast<int>(frames);
+}
+
+/**
+ * @returns @c true if the application is connected to at least one serial
  *          device, otherwise, this function shall return @c false
  */
 bool SerialManager::connected() const  {
-    if (m_port != Q_NULLPTR)
-        return m_port->isOpen();
-
-    return false;
+    return m_connected;
 }
 
 /**
@@ -111,14 +176,19 @@ bool SerialManager::fileLoggingEnabled() const {
 }
 
 /**
- * @brief SerialManager::deviceName
- * @return
+ * @returns the names of the connected serial devices, separated with '+'
  */
 QString SerialManager::deviceName() const {
-    if (m_port)
-        return m_port->portName();
+    QStringList names;
+    foreach (const Receiver* receiver, m_receivers) {
+        if (receiver->connected)
+            names.append(receiver->deviceName);
+    }
+
+    if (names.isEmpty())
+        return "Undefined";
 
-    return "Undefined";
+    return names.join("+");
 }
 
 /**
@@ -126,12 +196,47 @@ QString SerialManager::deviceName() const {
  *          received from the current serial device.
  */
 QString SerialManager::receivedBytes() const {
-    if (m_port != Q_NULLPTR && m_dataLen >= 0)
-        return sizeStr(m_dataLen);
+    qint64 bytes = 0;
+    foreach (const Receiver* receiver, m_receivers) {
+        if (receiver->connected)
+            bytes += receiver->reader->receivedBytes();
+    }
+
+    if (connected())
+        return sizeStr(bytes);
 
     return "0 " + tr("bytes");
 }
 
+/**
+ * @returns An user-friendly string that represents the number of garbage
+ *          bytes that were discarded while re-synchronizing with the data
+ *          stream of the current serial device.
+ */
+QString SerialManager::droppedBytes() const {
+    qint64 bytes = 0;
+    foreach (const Receiver* receiver, m_receivers)
+        bytes += receiver->reader->droppedBytes();
+
+    return sizeStr(bytes);
+}
+
+/**
+ * @returns An user-friendly string that represents the amount of data that
+ *          is waiting to be written to the packet log file
+ */
+QString SerialManager::logBacklog() const {
+    return sizeStr(m_packetLog.backlog());
+}
+
+/**
+ * @returns An user-friendly string that represents how much data is being
+ *          written to the packet log file per second
+ */
+QString SerialManager::logThroughput() const {
+    return sizeStr(m_packetLog.throughput()) + "/s";
+}
+
 /**
  * @returns A list with the port names (such as COM1, COM2, ttyACMO) of the
  *          ports that have any serial device connected to them
@@ -140,6 +245,33 @@ QStringList SerialManager::serialDevices() const {
     return m_serialDevices;
 }
 
+/**
+ * @returns the status and counters of each receiver (one receiver per
+ *          serial device), the @c firstDeliveries counter tells how many
+ *          packets were delivered by the receiver before any other one
+ */
+QVariantList SerialManager::receiverStats() const {
+    QVariantList list;
+    for (int i = 0; i < m_receivers.count(); ++i) {
+        const Receiver* receiver = m_receivers.at(i);
+        const FrameMerger::SourceStats& stats = m_merger.stats(i);
+
+        QVariantMap map;
+        map.insert("index", i);
+        map.insert("connected", receiver->connected);
+        map.insert("device", receiver->deviceName);
+        map.insert("frames", stats.frames);
+        map.insert("firstDeliveries", stats.firstDeliveries);
+        map.insert("duplicates", stats.duplicates);
+        map.insert("receivedBytes", receiver->reader->receivedBytes());
+        map.insert("droppedBytes", receiver->reader->droppedBytes());
+        map.insert("droppedFrames", receiver->reader->droppedFrames());
+        list.append(map);
+    }
+
+    return list;
+}
+
 void SerialManager::openLogFile() {
     if (packetLogAvailable())
         QDesktopServices::openUrl(QUrl::fromLocalFile(m_packetLog.fileName()));
@@ -152,20 +284,38 @@ void SerialManager::setBaudRate(const int rate) {
     if (rate > 0) {
         m_baudRate = rate;
 
-        if (m_port)
-            m_port->setBaudRate(baudRate());
+        foreach (Receiver* receiver, m_receivers) {
+            QMetaObject::invokeMethod(receiver->reader, "setBaudRate",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(int, baudRate()));
+        }
 
         emit baudRateChanged();
     }
 }
 
 /**
- * @brief SerialManager::startComm
- * @param device
+ * Reads the given @a device with the primary receiver, other receivers
+ * are not affected
  */
 void SerialManager::startComm(const int device) {
-    // Disconnect current serial port device
-    disconnectDevice();
+    openDevice(0, device);
+}
+
+/**
+ * @brief Reads the given @a device with the given @a receiver
+ *
+ * The device that was opened by the receiver is closed, the @c device
+ * index is the index in the @c serialDevices() list, so that 0 (the
+ * <Select Port> virtual device) only closes the receiver.
+ */
+void SerialManager::openDevice(const int receiver, const int device) {
+    // Invalid receiver
+    if (receiver < 0 || receiver >= MAX_RECEIVERS)
+        return;
+
+    // Disconnect current serial port device of the receiver
+    closeReceiver(receiver);
 
     // Ignore the <Select Port> virtual device
     if (device > 0) {
@@ -173,28 +323,10 @@ void SerialManager::startComm(const int device) {
         int portId = device - 1;
         QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
 
-        // Check if port ID is valid
-        if (portId < ports.count()) {
-            // Configure new serial port device
-            m_port = new QSerialPort(ports.at(portId));
-            m_port->setBaudRate(baudRate());
-
-            // Connect signals/slots
-            connect(m_port, SIGNAL(readyRead()),
-                    this,     SLOT(onDataReceived()));
-            connect(m_port, SIGNAL(aboutToClose()),
-                    this,     SLOT(disconnectDevice()));
-
-            // Try to open the serial port device
-            if (m_port->open(QIODevice::ReadOnly)) {
-                emit connectionChanged();
-                emit connectionSuccess(m_port->portName());
-            }
-
-            // There was an error opening the serial port device
-            else
-                disconnectDevice();
-        }
+        // Check if port ID is valid, the serial port device is opened by
+        // the serial I/O thread, which notifies us about the result
+        if (portId < ports.count())
+            openSource(receiver, "serial:" + ports.at(portId).portName());
 
         // Port ID is invalid
         else
@@ -202,6 +334,48 @@ void SerialManager::startComm(const int device) {
     }
 }
 
+/**
+ * @brief Reads the given telemetry @a source with the given @a receiver
+ *
+ * The @a source string can describe a serial port, a network socket, a
+ * pseudo-terminal or a file (see @c Transport::Create()), the transport
+ * is created and opened by the serial I/O thread, which notifies us about
+ * the result.
+ */
+void SerialManager::openSource(const int receiver, const QString& source) {
+    // Invalid receiver
+    if (receiver < 0 || receiver >= MAX_RECEIVERS)
+        return;
+
+    // Disconnect current device of the receiver
+    closeReceiver(receiver);
+
+    // Open the new source
+    if (!source.isEmpty()) {
+        QMetaObject::invokeMethod(this->receiver(receiver)->reader, "open",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(QString, source),
+                                  Q_ARG(int, baudRate()));
+    }
+}
+
+/**
+ * @brief Delivers a @a batch of recorded packets to the application
+ *
+ * Replayed packets go through the same path as the packets received by
+ * the serial devices (so that they are shown in the console and parsed),
+ * but they are not written to the log files of the current session.
+ */
+void SerialManager::replayPackets(const FrameBatch& batch) {
+    if (batch.isEmpty())
+        return;
+
+    m_replaying = true;
+    emit packetsReceived(batch);
+    emit dataReceived();
+    m_replaying = false;
+}
+
 /**
  * @brief SerialManager::enableFileLogging
  * @param enabled
@@ -217,8 +391,10 @@ void SerialManager::enableFileLogging(const bool enabled) {
     if (previousValue != enabled) {
         if (enabled)
             configureLogFile();
-        else if (m_packetLog.isOpen())
+        else {
             m_packetLog.close();
+            m_capture.close();
+        }
     }
 
     // Update UI
@@ -226,100 +402,158 @@ void SerialManager::enableFileLogging(const bool enabled) {
 }
 
 /**
- * @brief SerialManager::onDataReceived
+ * Closes the comm. channel of the given @a receiver and notifies the rest
+ * of the application modules, so that the following tasks can be
+ * performed:
+ *     - Close the current log/received data file (if no other device is
+ *       connected)
+ *     - Update the user interface
  */
-void SerialManager::onDataReceived() {
-    // Check serial port pointer
-    if (!m_port)
+void SerialManager::closeReceiver(const int receiver) {
+    if (receiver >= m_receivers.count())
         return;
 
-    // Read incoming data
-    m_dataLen += m_port->bytesAvailable();
-    m_buffer.append(m_port->readAll());
+    // Close the serial port in the serial I/O thread
+    Receiver* r = m_receivers.at(receiver);
+    QMetaObject::invokeMethod(r->reader, "close", Qt::QueuedConnection);
 
-    // Buffer contains EOT byte, which represents a packet
-    if (m_buffer.contains(EOT_PRIMARY.toLatin1())) {
-        // We could have received part of the next packet - or more than one
-        // packet - so we split the data into packets to read each one
-        // separately.
-        QList<QByteArray> packets = m_buffer.split(EOT_PRIMARY.toLatin1());
+    // Warn user (if serial port was valid)
+    if (r->connected) {
+        r->connected = false;
+        if (!r->deviceName.isEmpty())
+            emit connectionError(r->deviceName);
+    }
 
-        // Check if last packet is complete or not
-        if (m_buffer.endsWith(EOT_PRIMARY.toLatin1()))
-            m_buffer.clear();
-        else {
-            m_buffer = packets.last();
-            packets.removeLast();
-        }
+    // Update UI
+    updateConnectionStatus();
+}
+
+/**
+ * @brief Processes all the packets that were queued by the serial I/O thread
+ *
+ * Packets of every receiver go through the frame merger, which removes
+ * the copies of the packets that were received by more than one device.
+ * Packets are copied into one contiguous batch, which is delivered with a
+ * single emission of the @c packetsReceived() signal, so that the cost of
+ * notifying receivers does not grow with the size of each burst.
+ *
+ * @note The batch is re-used, connected slots must copy any data that they
+ *       need to keep after the emission of the @c packetsReceived() signal.
+ */
+void SerialManager::onFramesAvailable() {
+    // Avoid processing the same packet twice if a receiver spins the
+    // event loop (e.g. by showing a modal dialog), the queues are drained
+    // again once the current drain finishes, otherwise the readers would
+    // never notify us again
+    if (m_draining) {
+        m_drainPending = true;
+        return;
+    }
+
+    m_draining = true;
+    m_batch.clear();
+    TraceSpan span("dispatch");
+
+    // Move every queued packet to the merger
+    for (int i = 0; i < m_receivers.count(); ++i) {
+        // Allow the serial I/O thread to notify us again
+        Receiver* receiver = m_receivers.at(i);
+        receiver->reader->acknowledgeFrames();
+
+        // Packets skip the merger when there is only one device
+        RawFrame* frame = receiver->queue->front();
+        while (frame != Q_NULLPTR) {
+            if (m_merger.bypass(i))
+                m_batch.append(frame->data, frame->size, frame->timestamp);
+            else
+                m_merger.push(i, frame->data, frame->size, frame->timestamp);
 
-        // Read each packet separately
-        foreach (QByteArray packet, packets) {
-            if (!packet.isEmpty())
-                emit packetReceived(packet);
+            receiver->queue->pop();
+            frame = receiver->queue->front();
         }
     }
 
-    // Ensure that buffer stays withing size limits
-    if (m_buffer.size() > MAX_BUFFER_SIZE)
-        m_buffer.clear();
+    // Move the merged packets to the batch, and schedule the release of the
+    // packets that are held in the reorder buffer
+    const qint64 now = MonotonicTime();
+    if (m_merger.release(m_batch, now, false) > 0) {
+        const qint64 wait = m_merger.nextDeadline() - now;
+        m_mergeTimer.start(qMax(1, static_cast<int>(wait / 1000000) + 1));
+    }
+
+    // Notify application
+    span.setValue(m_batch.count());
+    if (!m_batch.isEmpty()) {
+        LatencyMonitor::getInstance()->record(LatencyMonitor::kDispatch,
+                                              m_batch, now);
+        emit packetsReceived(m_batch);
+        emit dataReceived();
+    }
+
+    // Drain again if we were notified while the batch was being processed
+    m_draining = false;
+    if (m_drainPending) {
+        m_drainPending = false;
+        QMetaObject::invokeMethod(this, "onFramesAvailable",
+                                  Qt::QueuedConnection);
+    }
+
+    // Update UI
+    emit queueStatsChanged();
+
+    // Update receiver statistics (at a human-readable rate)
+    if (m_receiversClock.elapsed() >= 250) {
+        m_receiversClock.restart();
+        emit receiverStatsChanged();
+    }
 }
 
 /**
- * Closes the comm. channel with the current serial device and notifies
- * the rest of the application modules, so that the following tasks can
- * be performed:
- *     - Close the current log/received data file
- *     - Update the user interface
- *     - Disconnect serial device signals/slots to the SerialManager
+ * Updates the connection status after the serial I/O thread opens the
+ * serial device with the given @a deviceName
  */
-void SerialManager::disconnectDevice() {
-    // Reset byte counter
-    m_dataLen = -1;
+void SerialManager::onDeviceOpened(const QString& deviceName) {
+    const int index = receiverIndex(sender());
+    if (index < 0)
+        return;
 
-    // Check if serial port pointer is valid
-    if (m_port != Q_NULLPTR) {
-        // Get serial port name
-        QString name = m_port->portName();
+    Receiver* r = m_receivers.at(index);
+    r->connected = true;
+    r->deviceName = deviceName;
+    m_merger.resetStats(index);
 
-        // Disconnect signals/slots of serial port
-        m_port->disconnect(this, SLOT(onDataReceived()));
-        m_port->disconnect(this, SLOT(disconnectDevice()));
+    updateConnectionStatus();
+    emit connectionSuccess(deviceName);
+}
 
-        // Close and delete the serial port
-        m_port->close();
-        m_port->deleteLater();
+/**
+ * Updates the connection status and warns the user if the serial device
+ * with the given @a deviceName could not be opened or was disconnected
+ */
+void SerialManager::onDeviceClosed(const QString& deviceName) {
+    const int index = receiverIndex(sender());
+    if (index < 0)
+        return;
 
-        // Reset pointer
-        m_port = Q_NULLPTR;
+    m_receivers.at(index)->connected = false;
 
-        // Warn user(if serial port was valid)
-        if (!name.isEmpty())
-            emit connectionError(name);
-    }
+    if (!deviceName.isEmpty())
+        emit connectionError(deviceName);
 
-    // Update UI
-    emit connectionChanged();
+    updateConnectionStatus();
 }
 
 /**
  * @brief SerialManager::configureLogFile
  */
 void SerialManager::configureLogFile() {
-    // Close log file
-    if (m_packetLog.isOpen())
-        m_packetLog.close();
-
-    // Serial device is invalid, abort
-    if (!m_port) {
-        m_packetLog.setFileName("");
-        return;
-    }
+    // Close log files (pending data is written & synced to disk)
+    m_packetLog.close();
+    m_capture.close();
 
     // Serial device is not open, abort
-    if (!m_port->isOpen()) {
-        m_packetLog.setFileName("");
+    if (!connected())
         return;
-    }
 
     // File logging disabled
     if (!fileLoggingEnabled())
@@ -327,10 +561,12 @@ void SerialManager::configureLogFile() {
 
     // Get file name and path
     QString format = QDateTime::currentDateTime().toString("yyyy/MMM/dd/");
-    QString fileName = QDateTime::currentDateTime().toString("HH-mm-ss") + ".html";
+    QString baseName = QDateTime::currentDateTime().toString("HH-mm-ss");
+    QString device = deviceName();
+    device.replace(QRegularExpression("[^A-Za-z0-9._+-]"), "_");
     QString path = QString("%1/%2/%3/%4").arg(QDir::homePath(),
                                               qApp->applicationName(),
-                                              m_port->portName(),
+                                              device,
                                               format);
 
     // Generate file path if required
@@ -338,12 +574,13 @@ void SerialManager::configureLogFile() {
     if (!dir.exists())
         dir.mkpath(".");
 
-    // Open file
-    m_packetLog.setFileName(dir.filePath(fileName));
-    if (!m_packetLog.open(QFile::WriteOnly))
+    // Open files, they shall stay open until the device is disconnected
+    if (!m_packetLog.open(dir.filePath(baseName + ".html"), QFile::WriteOnly))
         qWarning() << "Cannot open" << m_packetLog.fileName() << "for writting";
-    else
-        m_packetLog.close();
+
+    // Open timestamped binary capture (used by post-flight tools)
+    if (!m_capture.open(dir.filePath(baseName + ".kcap")))
+        qWarning() << "Cannot open" << m_capture.fileName() << "for writting";
 }
 
 /**
@@ -371,24 +608,98 @@ void SerialManager::refreshSerialDevices() {
 }
 
 /**
- * @brief SerialManager::formatReceivedPacket
- * @param packet
+ * Writes the given @a batch of packets to the log file (in a single call)
+ * and notifies the rest of the application
  */
-void SerialManager::formatReceivedPacket(const QByteArray& packet) {
-    // Do not take into account empty packets
-    if (packet.isEmpty())
+void SerialManager::formatReceivedBatch(const FrameBatch& batch) {
+    // Do not take into account empty batches
+    if (batch.isEmpty())
         return;
 
-    // Write received data to log file
-    if (packetLogAvailable()) {
-        if (m_packetLog.open(QFile::Append)) {
-            m_packetLog.write(packet);
-            m_packetLog.close();
-        }
+    // Queue received data to be written by the log writer thread
+    if (packetLogAvailable() && !m_replaying) {
+        TraceSpan span("log.queue", batch.data().size());
+        m_packetLog.write(batch);
+        m_capture.append(batch);
     }
 
     // Notify application
-    emit packetLogged(QString::fromUtf8(packet));
+    emit packetLogged(QString::fromUtf8(batch.data()));
+}
+
+/**
+ * @returns the index of the receiver that owns the given @a reader, or -1
+ *          if the reader does not belong to any receiver
+ */
+int SerialManager::receiverIndex(QObject* reader) const {
+    for (int i = 0; i < m_receivers.count(); ++i) {
+        if (m_receivers.at(i)->reader == reader)
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Returns the receiver with the given @a index, creating it (and
+ *        any receiver before it) if needed
+ *
+ * Each receiver has its own frame queue and its own frame reader (with
+ * its own packet framer), all readers live in the serial I/O thread.
+ * Receivers are never deleted, so that the queue of a reader is valid
+ * during the whole life of the reader.
+ */
+SerialManager::Receiver* SerialManager::receiver(const int index) {
+    while (m_receivers.count() <= index) {
+        Receiver* r = new Receiver;
+        r->connected = false;
+        r->queue = new FrameQueue(FRAME_QUEUE_SIZE);
+        r->reader = new FrameReader(r->queue);
+        r->reader->moveToThread(&m_thread);
+
+        connect(&m_thread, &QThread::finished,
+                r->reader, &FrameReader::deleteLater);
+        connect(r->reader, &FrameReader::framesAvailable,
+                this, &SerialManager::onFramesAvailable);
+        connect(r->reader, &FrameReader::droppedBytesChanged,
+                this, &SerialManager::droppedBytesChanged);
+        connect(r->reader, &FrameReader::opened,
+                this, &SerialManager::onDeviceOpened);
+        connect(r->reader, &FrameReader::closed,
+                this, &SerialManager::onDeviceClosed);
+
+        m_receivers.append(r);
+        m_merger.resetStats(m_receivers.count() - 1);
+    }
+
+    return m_receivers.at(index);
+}
+
+/**
+ * Updates the number of sources used by the merger and notifies the
+ * application when the first device is connected or when the last device
+ * is disconnected
+ */
+void SerialManager::updateConnectionStatus() {
+    int count = 0;
+    foreach (const Receiver* receiver, m_receivers) {
+        if (receiver->connected)
+            ++count;
+    }
+
+    // Packets are only held and de-duplicated if there is more than one
+    // device, release the packets that are no longer needed to be held
+    m_merger.setSourceCount(count);
+    if (count <= 1 && m_merger.pending() > 0)
+        QTimer::singleShot(0, this, &SerialManager::onFramesAvailable);
+
+    // Update connection status
+    if (m_connected != (count > 0)) {
+        m_connected = count > 0;
+        emit connectionChanged();
+    }
+
+    emit receiverStatsChanged();
 }
 
 /**
@@ -396,7 +707,7 @@ void SerialManager::formatReceivedPacket(const QByteArray& packet) {
  * @return
  */
 bool SerialManager::packetLogAvailable() const {
-    return !m_packetLog.fileName().isEmpty() && fileLoggingEnabled();
+    return m_packetLog.isOpen() && fileLoggingEnabled();
 }
 
 /**
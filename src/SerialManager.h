@@ -24,9 +24,17 @@
 #define SERIAL_MANAGER_H
 
 #include <QtQml>
+#include <QTimer>
+#include <QThread>
 #include <QObject>
+#include <QElapsedTimer>
+
+#include "FrameBatch.h"
+#include "CaptureFile.h"
+#include "FrameMerger.h"
+#include "AsyncFileWriter.h"
+#include "FrameReader.h"
 
-class QSerialPort;
 class SerialManager : public QObject {
     Q_OBJECT
     Q_PROPERTY(bool connected
@@ -38,7 +46,22 @@ class SerialManager : public QObject {
                NOTIFY fileLoggingEnabledChanged)
     Q_PROPERTY(QString receivedBytes
                READ receivedBytes
-               NOTIFY packetReceived)
+               NOTIFY dataReceived)
+    Q_PROPERTY(QString droppedBytes
+               READ droppedBytes
+               NOTIFY droppedBytesChanged)
+    Q_PROPERTY(int queueDepth
+               READ queueDepth
+               NOTIFY queueStatsChanged)
+    Q_PROPERTY(int droppedFrames
+               READ droppedFrames
+               NOTIFY queueStatsChanged)
+    Q_PROPERTY(QString logBacklog
+               READ logBacklog
+               NOTIFY logStatisticsChanged)
+    Q_PROPERTY(QString logThroughput
+               READ logThroughput
+               NOTIFY logStatisticsChanged)
     Q_PROPERTY(QStringList serialDevices
                READ serialDevices
                NOTIFY serialDevicesChanged)
@@ -46,14 +69,22 @@ class SerialManager : public QObject {
                READ baudRate
                WRITE setBaudRate
                NOTIFY baudRateChanged)
+    Q_PROPERTY(QVariantList receiverStats
+               READ receiverStats
+               NOTIFY receiverStatsChanged)
 
 signals:
     void baudRateChanged();
     void connectionChanged();
+    void queueStatsChanged();
+    void logStatisticsChanged();
+    void droppedBytesChanged();
     void serialDevicesChanged();
     void fileLoggingEnabledChanged();
+    void receiverStatsChanged();
+    void dataReceived();
     void packetLogged(const QString& data);
-    void packetReceived(const QByteArray& data);
+    void packetsReceived(const FrameBatch& batch);
     void connectionError(const QString& deviceName);
     void connectionSuccess(const QString& deviceName);
 
@@ -65,38 +96,69 @@ public:
     static SerialManager* getInstance();
 
     int baudRate() const;
+    int maxReceivers() const;
+    int queueDepth() const;
+    int droppedFrames() const;
     bool connected() const;
     bool fileLoggingEnabled() const;
 
     QString deviceName() const;
+    QString logBacklog() const;
+    QString droppedBytes() const;
+    QString logThroughput() const;
     QString receivedBytes() const;
     QStringList serialDevices() const;
+    QVariantList receiverStats() const;
 
 public slots:
     void openLogFile();
     void setBaudRate(const int rate);
     void startComm(const int device);
+    void openDevice(const int receiver, const int device);
+    void openSource(const int receiver, const QString& source);
+    void replayPackets(const FrameBatch& batch);
     void enableFileLogging(const bool enabled);
+    void formatReceivedBatch(const FrameBatch& batch);
 
 private slots:
-    void onDataReceived();
-    void disconnectDevice();
+    void closeReceiver(const int receiver);
+    void onFramesAvailable();
     void configureLogFile();
     void refreshSerialDevices();
-    void formatReceivedPacket(const QByteArray& data);
+    void onDeviceOpened(const QString& deviceName);
+    void onDeviceClosed(const QString& deviceName);
 
 private:
+    struct Receiver {
+        bool connected;
+        QString deviceName;
+        FrameQueue* queue;
+        FrameReader* reader;
+    };
+
+    int receiverIndex(QObject* reader) const;
+    Receiver* receiver(const int index);
+    void updateConnectionStatus();
     bool packetLogAvailable() const;
     QString sizeStr(const qint64 bytes) const;
 
 private:
     int m_baudRate;
-    QFile m_packetLog;
-    qint64 m_dataLen;
-    QByteArray m_buffer;
-    QSerialPort* m_port;
+    bool m_draining;
+    bool m_drainPending;
+    bool m_replaying;
+    bool m_connected;
+    CaptureWriter m_capture;
+    AsyncFileWriter m_packetLog;
     QStringList m_serialDevices;
 
+    QThread m_thread;
+    FrameBatch m_batch;
+    FrameMerger m_merger;
+    QTimer m_mergeTimer;
+    QElapsedTimer m_receiversClock;
+    QVector<Receiver*> m_receivers;
+
     bool m_enableFileLogging;
 };
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QSerialPort>
+
+#include "SerialTransport.h"
+
+/**
+ * Creates a (closed) transport for the serial port with the given
+ * @a portName
+ */
+SerialTransport::SerialTransport(const QString& portName, QObject* parent) :
+    Transport(parent),
+    m_port(new QSerialPort(portName, this))
+{
+    connect(m_port, &QSerialPort::readyRead,
+            this, &SerialTransport::readyRead);
+    connect(m_port, &QSerialPort::errorOccurred,
+            this, &SerialTransport::onError);
+}
+
+/**
+ * Closes the serial port
+ */
+SerialTransport::~SerialTransport() {
+    close();
+}
+
+/**
+ * @returns the name of the serial port (e.g. COM3 or ttyUSB0)
+ */
+QString SerialTransport::name() const {
+    return m_port->portName();
+}
+
+/**
+ * @returns @c true if the serial port is open
+ */
+bool SerialTransport::isOpen() const {
+    return m_port->isOpen();
+}
+
+/**
+ * @returns the description of the last error of the serial port
+ */
+QString SerialTransport::errorString() const {
+    return m_port->errorString();
+}
+
+/**
+ * Opens the serial port in read-only mode
+ */
+bool SerialTransport::open() {
+    return m_port->open(QIODevice::ReadOnly);
+}
+
+/**
+ * Closes the serial port
+ */
+void SerialTransport::close() {
+    if (m_port->isOpen())
+        m_port->close();
+}
+
+/**
+ * Reads up to @a maxSize bytes into the given @a data buffer
+ */
+qint64 SerialTransport::read(char* data, const qint64 maxSize) {
+    return m_port->read(data, maxSize);
+}
+
+/**
+ * Changes the baud @a rate of the serial port
+ */
+void SerialTransport::setBaudRate(const int rate) {
+    m_port->setBaudRate(rate);
+}
+
+/**
+ * Reports fatal errors (e.g. the device was disconnected)
+ */
+void SerialTransport::onError(const int error) {
+    if (error == QSerialPort::ResourceError)
+        emit errorOccurred(m_port->errorString());
+}
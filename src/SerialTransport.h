@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_TRANSPORT_H
+#define SERIAL_TRANSPORT_H
+
+#include "Transport.h"
+
+class QSerialPort;
+
+/**
+ * @brief Reads data from a serial port (the radio of the ground station)
+ */
+class SerialTransport : public Transport {
+    Q_OBJECT
+
+public:
+    explicit SerialTransport(const QString& portName,
+                             QObject* parent = Q_NULLPTR);
+    ~SerialTransport();
+
+    QString name() const override;
+    bool isOpen() const override;
+    QString errorString() const override;
+
+    bool open() override;
+    void close() override;
+    qint64 read(char* data, const qint64 maxSize) override;
+
+    void setBaudRate(const int rate) override;
+
+private slots:
+    void onError(const int error);
+
+private:
+    QSerialPort* m_port;
+};
+
+#endif
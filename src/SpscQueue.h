@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <QVector>
+#include <QAtomicInteger>
+
+/**
+ * @brief Bounded, lock-free, single-producer/single-consumer queue
+ *
+ * Slots are allocated once by the constructor and are written in place, so
+ * that pushing and popping items never allocates memory. The producer
+ * obtains a free slot with @c back(), fills it and publishes it with
+ * @c push(), the consumer reads the oldest slot with @c front() and releases
+ * it with @c pop().
+ *
+ * Only one thread may act as the producer and only one thread may act as
+ * the consumer at any given time.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * Allocates the queue slots, @a capacity is rounded up to the next
+     * power of two
+     */
+    explicit SpscQueue(const int capacity) : m_head(0), m_tail(0) {
+        int slots = 1;
+        while (slots < capacity)
+            slots <<= 1;
+
+        m_slots.resize(slots);
+        m_buffer = m_slots.data();
+        m_mask = static_cast<quint32>(slots - 1);
+    }
+
+    /**
+     * @returns the maximum number of items that the queue can hold
+     */
+    int capacity() const {
+        return static_cast<int>(m_mask + 1);
+    }
+
+    /**
+     * @returns the number of items that are waiting to be consumed
+     */
+    int size() const {
+        return static_cast<int>(m_tail.loadAcquire() - m_head.loadAcquire());
+    }
+
+    /**
+     * @returns a pointer to the next free slot, or @c Q_NULLPTR if the
+     *          queue is full (producer only)
+     */
+    T* back() {
+        const quint32 tail = m_tail.load();
+        if (tail - m_head.loadAcquire() > m_mask)
+            return Q_NULLPTR;
+
+        return m_buffer + (tail & m_mask);
+    }
+
+    /**
+     * Publishes the slot returned by @c back() to the consumer
+     */
+    void push() {
+        m_tail.storeRelease(m_tail.load() + 1);
+    }
+
+    /**
+     * @returns a pointer to the oldest published slot, or @c Q_NULLPTR if
+     *          the queue is empty (consumer only)
+     */
+    T* front() {
+        const quint32 head = m_head.load();
+        if (head == m_tail.loadAcquire())
+            return Q_NULLPTR;
+
+        return m_buffer + (head & m_mask);
+    }
+
+    /**
+     * Returns the slot obtained with @c front() to the producer
+     */
+    void pop() {
+        m_head.storeRelease(m_head.load() + 1);
+    }
+
+private:
+    T* m_buffer;
+    quint32 m_mask;
+    QVector<T> m_slots;
+
+    // Keep producer and consumer indexes in different cache lines
+    char m_padding0[64];
+    QAtomicInteger<quint32> m_head;
+    char m_padding1[64];
+    QAtomicInteger<quint32> m_tail;
+    char m_padding2[64];
+};
+
+#endif
@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QThread>
+#include <QDateTime>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include "TraceWriter.h"
+#include "TelemetryDatabase.h"
+
+/**
+ * Columns of each session table, values are bound in the same order by
+ * @c BindRow()
+ */
+static const char* const COLUMNS[][2] = {
+    {"receivedAt",        "INTEGER"},
+    {"teamId",            "INTEGER"},
+    {"packetCount",       "INTEGER"},
+    {"missionTime",       "INTEGER"},
+    {"altitude",          "REAL"},
+    {"atmPressure",       "REAL"},
+    {"batteryVoltage",    "REAL"},
+    {"intTemperature",    "REAL"},
+    {"extTemperature",    "REAL"},
+    {"airQuality",        "REAL"},
+    {"carbonMonoxide",    "REAL"},
+    {"gpsTime",           "INTEGER"},
+    {"latitude",          "REAL"},
+    {"longitude",         "REAL"},
+    {"gpsAltitude",       "REAL"},
+    {"gpsSatelliteCount", "INTEGER"},
+    {"accelerometerX",    "REAL"},
+    {"accelerometerY",    "REAL"},
+    {"accelerometerZ",    "REAL"},
+    {"magnetometerX",     "REAL"},
+    {"magnetometerY",     "REAL"},
+    {"magnetometerZ",     "REAL"},
+    {"parachute",         "INTEGER"},
+    {"checksum",          "INTEGER"}
+};
+
+/**
+ * Number of columns of each session table
+ */
+static const int COLUMN_COUNT = sizeof(COLUMNS) / sizeof(COLUMNS[0]);
+
+/**
+ * Used to give each database connection a unique name
+ */
+static QAtomicInt CONNECTION_ID(0);
+
+/**
+ * Binds the values of the given @a frame (received at the given unix time,
+ * in milliseconds) to the insert @a query
+ */
+static void BindRow(QSqlQuery& query, const qint64 receivedAt,
+                    const TelemetryFrame& frame) {
+    int i = 0;
+    query.bindValue(i++, receivedAt);
+    query.bindValue(i++, frame.teamId);
+    query.bindValue(i++, frame.packetCount);
+    query.bindValue(i++, static_cast<qint64>(frame.missionTime));
+    query.bindValue(i++, frame.altitude);
+    query.bindValue(i++, frame.atmPressure);
+    query.bindValue(i++, frame.batteryVoltage);
+    query.bindValue(i++, frame.intTemperature);
+    query.bindValue(i++, frame.extTemperature);
+    query.bindValue(i++, frame.airQuality);
+    query.bindValue(i++, frame.carbonMonoxide);
+    query.bindValue(i++, static_cast<qint64>(frame.unixTime));
+    query.bindValue(i++, frame.latitude);
+    query.bindValue(i++, frame.longitude);
+    query.bindValue(i++, frame.gpsAltitude);
+    query.bindValue(i++, frame.gpsSatelliteCount);
+    query.bindValue(i++, frame.accelerometer[0]);
+    query.bindValue(i++, frame.accelerometer[1]);
+    query.bindValue(i++, frame.accelerometer[2]);
+    query.bindValue(i++, frame.magnetometer[0]);
+    query.bindValue(i++, frame.magnetometer[1]);
+    query.bindValue(i++, frame.magnetometer[2]);
+    query.bindValue(i++, frame.parachute ? 1 : 0);
+    query.bindValue(i++, static_cast<qint64>(frame.checksum));
+
+    Q_ASSERT(i == COLUMN_COUNT);
+}
+
+/**
+ * Executes the given SQL @a statement in the given database @a db
+ *
+ * @returns @c true on success
+ */
+static bool Execute(QSqlDatabase& db, const QString& statement) {
+    QSqlQuery query(db);
+    if (!query.exec(statement)) {
+        qWarning() << "SQL error:" << query.lastError().text()
+                   << "in" << statement;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Thread that runs the write loop of a @c TelemetryDatabase
+ */
+class TelemetryDatabaseThread : public QThread {
+public:
+    explicit TelemetryDatabaseThread(TelemetryDatabase* db) : m_db(db) {}
+
+protected:
+    void run() {
+        m_db->writeLoop();
+    }
+
+private:
+    TelemetryDatabase* m_db;
+};
+
+/**
+ * Constructor function, by default, pending frames are inserted every
+ * quarter of a second (or as soon as 1024 frames are pending)
+ */
+TelemetryDatabase::TelemetryDatabase(QObject* parent) : QObject(parent),
+    m_thread(Q_NULLPTR),
+    m_stop(false),
+    m_ready(false),
+    m_initializedDone(false),
+    m_flushRequested(false),
+    m_flushInterval(250),
+    m_flushThreshold(1024),
+    m_maxBacklog(256 * 1024),
+    m_backlog(0),
+    m_rowsWritten(0),
+    m_droppedRows(0)
+{
+    m_pending.reserve(m_flushThreshold);
+}
+
+/**
+ * Inserts any pending frame and closes the database
+ */
+TelemetryDatabase::~TelemetryDatabase() {
+    close();
+}
+
+/**
+ * @returns @c true if the database is open
+ */
+bool TelemetryDatabase::isOpen() const {
+    return m_thread != Q_NULLPTR;
+}
+
+/**
+ * @returns the name of the current (or last) database file
+ */
+QString TelemetryDatabase::fileName() const {
+    return m_fileName;
+}
+
+/**
+ * @returns the name of the table of the current (or last) session
+ */
+QString TelemetryDatabase::tableName() const {
+    return m_tableName;
+}
+
+/**
+ * @returns the number of frames that have not been inserted yet
+ */
+qint64 TelemetryDatabase::backlog() const {
+    return m_backlog.load();
+}
+
+/**
+ * @returns the number of frames inserted since the database was opened
+ */
+qint64 TelemetryDatabase::rowsWritten() const {
+    return m_rowsWritten.load();
+}
+
+/**
+ * @returns the number of frames that were discarded because the writer
+ *          thread could not keep up with the application or because an
+ *          insert failed
+ */
+qint64 TelemetryDatabase::droppedRows() const {
+    return m_droppedRows.load();
+}
+
+/**
+ * @brief Opens (or creates) the database with the given @a fileName and
+ *        starts a new session for the given @a deviceName
+ *
+ * The database is opened by the writer thread, this function waits until
+ * the session table has been created.
+ *
+ * @returns @c true on success
+ */
+bool TelemetryDatabase::open(const QString& fileName,
+                             const QString& deviceName) {
+    // Close current database
+    close();
+
+    // Set session information
+    m_fileName = fileName;
+    m_deviceName = deviceName;
+    m_tableName = "session_" + QDateTime::currentDateTime().toString(
+                "yyyyMMdd_HHmmss_zzz");
+    m_connectionName = QString("TelemetryDatabase-%1").arg(
+                CONNECTION_ID.fetchAndAddRelaxed(1));
+
+    // Reset statistics
+    m_backlog.store(0);
+    m_rowsWritten.store(0);
+    m_droppedRows.store(0);
+
+    // Start the writer thread and wait until it tries to open the database
+    // (the condition may wake up spuriously, so we check the flag)
+    QMutexLocker locker(&m_mutex);
+    m_stop = false;
+    m_ready = false;
+    m_initializedDone = false;
+    m_flushRequested = false;
+    m_thread = new TelemetryDatabaseThread(this);
+    m_thread->setObjectName("SQLite writer");
+    m_thread->start(QThread::LowPriority);
+    while (!m_initializedDone)
+        m_initialized.wait(&m_mutex);
+
+    // The database could not be opened, the thread has finished
+    if (!m_ready) {
+        locker.unlock();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = Q_NULLPTR;
+        return false;
+    }
+
+    emit statisticsChanged();
+    return true;
+}
+
+/**
+ * Queues the given @a frame to be inserted in the session table
+ */
+void TelemetryDatabase::append(const TelemetryFrame& frame) {
+    if (!m_thread)
+        return;
+
+    const qint64 receivedAt = QDateTime::currentMSecsSinceEpoch();
+    QMutexLocker locker(&m_mutex);
+
+    // Do not let the backlog grow without limits
+    if (m_pending.count() >= m_maxBacklog) {
+        m_droppedRows.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    // Append frame to the pending list
+    Row row;
+    row.receivedAt = receivedAt;
+    row.frame = frame;
+    m_pending.append(row);
+    m_backlog.fetchAndAddRelaxed(1);
+
+    // Wake up the writer thread if we have enough frames
+    if (m_pending.count() >= m_flushThreshold)
+        m_condition.wakeOne();
+}
+
+/**
+ * Asks the writer thread to insert all pending frames as soon as possible
+ */
+void TelemetryDatabase::flush() {
+    QMutexLocker locker(&m_mutex);
+    m_flushRequested = true;
+    m_condition.wakeOne();
+}
+
+/**
+ * Inserts all pending frames, stops the writer thread and closes the
+ * database
+ */
+void TelemetryDatabase::close() {
+    if (m_thread) {
+        m_mutex.lock();
+        m_stop = true;
+        m_condition.wakeOne();
+        m_mutex.unlock();
+
+        m_thread->wait();
+        delete m_thread;
+        m_thread = Q_NULLPTR;
+
+        emit statisticsChanged();
+    }
+}
+
+/**
+ * Changes the maximum time (in milliseconds) that frames can stay in
+ * memory before being inserted, use 0 to disable time-based inserts
+ */
+void TelemetryDatabase::setFlushInterval(const int msecs) {
+    QMutexLocker locker(&m_mutex);
+    m_flushInterval = qMax(0, msecs);
+    m_condition.wakeOne();
+}
+
+/**
+ * Changes the number of pending frames that triggers an insert
+ */
+void TelemetryDatabase::setFlushThreshold(const int frames) {
+    QMutexLocker locker(&m_mutex);
+    m_flushThreshold = qMax(1, frames);
+    m_condition.wakeOne();
+}
+
+/**
+ * @brief Main function of the writer thread
+ *
+ * Opens the database (connections can only be used by the thread that
+ * created them), then waits until any of the flush conditions is met and
+ * inserts the pending frames without holding the mutex, so that the
+ * application can keep queueing frames while we write to the disk.
+ */
+void TelemetryDatabase::writeLoop() {
+    {
+        // Open the database and create the session table
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE",
+                                                    m_connectionName);
+        db.setDatabaseName(m_fileName);
+        bool ready = db.open();
+        if (!ready)
+            qWarning() << "Cannot open" << m_fileName
+                       << db.lastError().text();
+        else
+            ready = initialize(db);
+
+        // Prepare the insert statement
+        QSqlQuery query(db);
+        if (ready) {
+            QStringList placeholders;
+            for (int i = 0; i < COLUMN_COUNT; ++i)
+                placeholders.append("?");
+
+            ready = query.prepare(QString("INSERT INTO \"%1\" VALUES (%2)")
+                                  .arg(m_tableName, placeholders.join(",")));
+            if (!ready)
+                qWarning() << "SQL error:" << query.lastError().text();
+        }
+
+        // Notify the application
+        m_mutex.lock();
+        m_ready = ready;
+        m_initializedDone = true;
+        m_initialized.wakeAll();
+
+        // Insert frames until the database is closed
+        QVector<Row> rows;
+        rows.reserve(m_flushThreshold);
+        QElapsedTimer window;
+        window.start();
+
+        while (ready) {
+            // Wait until a flush condition is met
+            if (!m_stop && !m_flushRequested &&
+                    m_pending.count() < m_flushThreshold) {
+                if (m_flushInterval > 0)
+                    m_condition.wait(&m_mutex,
+                                     static_cast<unsigned long>(m_flushInterval));
+                else
+                    m_condition.wait(&m_mutex);
+            }
+
+            // Take pending frames
+            const bool stop = m_stop;
+            m_flushRequested = false;
+            rows.swap(m_pending);
+            m_mutex.unlock();
+
+            // Insert the frames in a single transaction
+            if (!rows.isEmpty()) {
+                if (insert(db, query, rows))
+                    m_rowsWritten.fetchAndAddRelaxed(rows.count());
+                else
+                    m_droppedRows.fetchAndAddRelaxed(rows.count());
+
+                m_backlog.fetchAndAddRelaxed(-rows.count());
+                rows.resize(0);
+            }
+
+            // Update statistics (roughly every second)
+            if (window.elapsed() >= 1000 || stop) {
+                window.restart();
+                emit statisticsChanged();
+            }
+
+            // Exit loop when all frames have been inserted
+            m_mutex.lock();
+            if (stop && m_pending.isEmpty())
+                break;
+        }
+
+        m_mutex.unlock();
+
+        // Close the database
+        query.finish();
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+/**
+ * @brief Configures the given database @a db and creates the tables of the
+ *        current session
+ *
+ * Write-ahead logging lets other processes read the database while we
+ * write to it, and only requires the log to be synchronized with the disk
+ * on checkpoints (which is still safe if the application crashes).
+ *
+ * @returns @c true on success
+ */
+bool TelemetryDatabase::initialize(QSqlDatabase& db) {
+    // Enable write-ahead logging
+    QSqlQuery mode(db);
+    if (!mode.exec("PRAGMA journal_mode=WAL") || !mode.next() ||
+            mode.value(0).toString().toLower() != "wal")
+        qWarning() << "Cannot enable write-ahead logging for" << m_fileName;
+
+    if (!Execute(db, "PRAGMA synchronous=NORMAL"))
+        return false;
+
+    // Register the session
+    if (!Execute(db, "CREATE TABLE IF NOT EXISTS sessions ("
+                     "name TEXT PRIMARY KEY, "
+                     "started INTEGER, "
+                     "device TEXT)"))
+        return false;
+
+    QSqlQuery session(db);
+    session.prepare("INSERT INTO sessions VALUES (?, ?, ?)");
+    session.bindValue(0, m_tableName);
+    session.bindValue(1, QDateTime::currentMSecsSinceEpoch());
+    session.bindValue(2, m_deviceName);
+    if (!session.exec()) {
+        qWarning() << "SQL error:" << session.lastError().text();
+        return false;
+    }
+
+    // Create the session table
+    QStringList columns;
+    for (int i = 0; i < COLUMN_COUNT; ++i)
+        columns.append(QString("%1 %2").arg(COLUMNS[i][0], COLUMNS[i][1]));
+
+    if (!Execute(db, QString("CREATE TABLE \"%1\" (%2)")
+                 .arg(m_tableName, columns.join(", "))))
+        return false;
+
+    // Index by mission time and packet count
+    return Execute(db, QString("CREATE INDEX \"%1_missionTime\" "
+                               "ON \"%1\" (missionTime)").arg(m_tableName)) &&
+           Execute(db, QString("CREATE INDEX \"%1_packetCount\" "
+                               "ON \"%1\" (packetCount)").arg(m_tableName));
+}
+
+/**
+ * Inserts the given @a rows with the prepared insert @a query in a single
+ * transaction of the database @a db
+ *
+ * @returns @c true on success, if any insert fails the transaction is
+ *          rolled back
+ */
+bool TelemetryDatabase::insert(QSqlDatabase& db, QSqlQuery& query,
+                               const QVector<Row>& rows) {
+    TraceSpan span("db.insert", rows.count());
+
+    if (!db.transaction()) {
+        qWarning() << "SQL error:" << db.lastError().text();
+        return false;
+    }
+
+    for (int i = 0; i < rows.count(); ++i) {
+        BindRow(query, rows.at(i).receivedAt, rows.at(i).frame);
+        if (!query.exec()) {
+            qWarning() << "SQL error:" << query.lastError().text();
+            db.rollback();
+            return false;
+        }
+    }
+
+    if (!db.commit()) {
+        qWarning() << "SQL error:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    return true;
+}
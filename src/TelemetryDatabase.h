@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_DATABASE_H
+#define TELEMETRY_DATABASE_H
+
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+
+#include "TelemetryFrame.h"
+
+class QThread;
+class QSqlQuery;
+class QSqlDatabase;
+
+/**
+ * @brief Stores parsed frames in an SQLite database from a background thread
+ *
+ * Each session (i.e. each time that the database is opened) creates its own
+ * table, which is indexed by mission time and packet count, and registers
+ * it in the @c sessions table together with the start time and the device
+ * name. The database uses write-ahead logging, so that other programs can
+ * query it while the flight is in progress.
+ *
+ * Calls to @c append() only copy the frame into a pending list, the writer
+ * thread inserts the pending frames with a prepared statement inside a
+ * single transaction when one of the following conditions is met:
+ *     - The flush interval (in milliseconds) has elapsed
+ *     - The number of pending frames reaches the flush threshold
+ *     - The application calls @c flush() or @c close()
+ */
+class TelemetryDatabase : public QObject {
+    Q_OBJECT
+
+signals:
+    void statisticsChanged();
+
+public:
+    explicit TelemetryDatabase(QObject* parent = Q_NULLPTR);
+    ~TelemetryDatabase();
+
+    bool isOpen() const;
+    QString fileName() const;
+    QString tableName() const;
+
+    qint64 backlog() const;
+    qint64 rowsWritten() const;
+    qint64 droppedRows() const;
+
+    bool open(const QString& fileName, const QString& deviceName);
+    void append(const TelemetryFrame& frame);
+
+public slots:
+    void flush();
+    void close();
+    void setFlushInterval(const int msecs);
+    void setFlushThreshold(const int frames);
+
+private:
+    struct Row {
+        qint64 receivedAt;
+        TelemetryFrame frame;
+    };
+
+    void writeLoop();
+    bool initialize(QSqlDatabase& db);
+    bool insert(QSqlDatabase& db, QSqlQuery& query, const QVector<Row>& rows);
+    friend class TelemetryDatabaseThread;
+
+private:
+    QString m_fileName;
+    QString m_tableName;
+    QString m_deviceName;
+    QString m_connectionName;
+    QThread* m_thread;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+    QWaitCondition m_initialized;
+
+    bool m_stop;
+    bool m_ready;
+    bool m_initializedDone;
+    bool m_flushRequested;
+    QVector<Row> m_pending;
+
+    int m_flushInterval;
+    int m_flushThreshold;
+    int m_maxBacklog;
+
+    QAtomicInteger<qint64> m_backlog;
+    QAtomicInteger<qint64> m_rowsWritten;
+    QAtomicInteger<qint64> m_droppedRows;
+};
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Decoded contents of a single packet generated by the CanSat
+ *
+ * There is one native field for each item of @c DataParser::DataPosition,
+ * followed by the values that are derived from them, which are computed only
+ * once (when the packet is parsed). The structure does not own any memory,
+ * so it can be copied and stored in history buffers at no extra cost.
+ *
+ * Use @c TelemetryFrame() to obtain a frame with all values set to 0.
+ */
+struct TelemetryFrame {
+    // Packet data
+    int teamId;
+    int packetCount;
+    double altitude;
+    double atmPressure;
+    double batteryVoltage;
+    double intTemperature;
+    double extTemperature;
+    double airQuality;
+    double carbonMonoxide;
+    quint64 gpsTime;
+    double gpsLongitudeDeg;
+    double gpsLongitudeMin;
+    double gpsLatitudeDeg;
+    double gpsLatitudeMin;
+    double gpsAltitude;
+    int gpsSatelliteCount;
+    double accelerometer[3];
+    double magnetometer[3];
+    quint32 missionTime;
+    bool parachute;
+    quint32 checksum;
+
+    // Derived values
+    quint64 unixTime;
+    double latitude;
+    double longitude;
+};
+
+#endif
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QVariantMap>
+#include <QVarLengthArray>
+
+#include "DataParser.h"
+#include "TelemetryHistory.h"
+
+Q_STATIC_ASSERT(TelemetryHistory::kChannelCount ==
+                static_cast<int>(DataParser::kChecksumCode));
+
+/**
+ * Constructor function
+ *
+ * @param rawCapacity number of samples kept at full resolution
+ * @param tierCapacity number of buckets kept by each decimated tier
+ * @param tierFactor number of items of a tier that are summarized by each
+ *        bucket of the next tier
+ * @param tierCount total number of tiers (including the full resolution
+ *        tier)
+ */
+TelemetryHistory::TelemetryHistory(QObject* parent,
+                                   const int rawCapacity,
+                                   const int tierCapacity,
+                                   const int tierFactor,
+                                   const int tierCount) : QObject(parent),
+    m_factor(qMax(2, tierFactor)),
+    m_appendCount(0),
+    m_notifiedCount(~Q_UINT64_C(0)),
+    m_lastMissionTime(0),
+    m_timeOffset(0)
+{
+    // Allocate all the memory that we shall use
+    m_tiers.resize(qMax(1, tierCount));
+    for (int i = 0; i < m_tiers.count(); ++i) {
+        Tier& tier = m_tiers[i];
+        tier.head = 0;
+        tier.count = 0;
+        tier.capacity = qMax(1, (i == 0) ? rawCapacity : tierCapacity);
+        tier.start.resize(tier.capacity);
+        tier.end.resize(tier.capacity);
+        tier.mean.resize(tier.capacity * kChannelCount);
+
+        // The full resolution tier does not need min/max values
+        if (i > 0) {
+            tier.min.resize(tier.capacity * kChannelCount);
+            tier.max.resize(tier.capacity * kChannelCount);
+        }
+    }
+
+    m_accumulators.resize(m_tiers.count() - 1);
+    clear();
+}
+
+/**
+ * @returns the number of samples stored at full resolution
+ */
+int TelemetryHistory::count() const {
+    return m_tiers.first().count;
+}
+
+/**
+ * @returns the time of the oldest data stored in any tier (in ms)
+ */
+qint64 TelemetryHistory::firstTime() const {
+    for (int i = m_tiers.count() - 1; i >= 0; --i) {
+        if (m_tiers.at(i).count > 0)
+            return tierStart(i);
+    }
+
+    return 0;
+}
+
+/**
+ * @returns the time of the newest sample (in ms)
+ */
+qint64 TelemetryHistory::lastTime() const {
+    const Tier& raw = m_tiers.first();
+    if (raw.count == 0)
+        return 0;
+
+    return raw.start.at((raw.head + raw.count - 1) % raw.capacity);
+}
+
+/**
+ * @returns the number of tiers (including the full resolution tier)
+ */
+int TelemetryHistory::tierCount() const {
+    return m_tiers.count();
+}
+
+/**
+ * @returns the total number of samples appended since the history was
+ *          created or cleared
+ */
+quint64 TelemetryHistory::appendCount() const {
+    return m_appendCount;
+}
+
+/**
+ * @returns the number of items stored in the given @a tier
+ */
+int TelemetryHistory::tierSize(const int tier) const {
+    if (tier < 0 || tier >= m_tiers.count())
+        return 0;
+
+    return m_tiers.at(tier).count;
+}
+
+/**
+ * @returns the start time of the oldest item of the given @a tier
+ */
+qint64 TelemetryHistory::tierStart(const int tier) const {
+    if (tierSize(tier) == 0)
+        return 0;
+
+    const Tier& t = m_tiers.at(tier);
+    return t.start.at(t.head);
+}
+
+/**
+ * @brief Adds the values of the given @a frame to the history
+ *
+ * The sample is stored in the full resolution tier and added to the
+ * bucket that is being built for the first decimated tier.
+ */
+void TelemetryHistory::append(const TelemetryFrame& frame) {
+    // Keep the timeline monotonic after satellite resets
+    const qint64 missionTime = frame.missionTime;
+    if (m_appendCount > 0 && missionTime < m_lastMissionTime)
+        m_timeOffset += m_lastMissionTime - missionTime;
+
+    m_lastMissionTime = missionTime;
+    const qint64 time = missionTime + m_timeOffset;
+
+    // Get the values of each channel
+    double values[kChannelCount];
+    for (int i = 0; i < kChannelCount; ++i)
+        values[i] = DataParser::frameValue(frame, i);
+
+    // Store the sample at full resolution
+    Tier& raw = m_tiers.first();
+    const int slot = push(raw, time, time);
+    for (int i = 0; i < kChannelCount; ++i)
+        raw.mean[i * raw.capacity + slot] = values[i];
+
+    // Update decimated tiers
+    if (m_tiers.count() > 1)
+        feed(1, time, time, values, values, values);
+
+    ++m_appendCount;
+}
+
+/**
+ * @brief Gets the data of the given @a channel between the @a from and
+ *        @a to times (in ms)
+ *
+ * The newest part of the range is taken from the finest tier that has it
+ * (starting at @a finestTier), older parts are taken from coarser tiers,
+ * the @a points are sorted by time.
+ *
+ * @returns the number of points obtained
+ */
+int TelemetryHistory::query(const int channel, const qint64 from,
+                            const qint64 to, QVector<HistoryPoint>& points,
+                            const int finestTier) const {
+    points.resize(0);
+    if (channel < 0 || channel >= kChannelCount || from > to)
+        return 0;
+
+    struct Segment {
+        int tier;
+        int first;
+        int last;
+    };
+
+    // Find the range of items to take from each tier, from newest to oldest
+    qint64 limit = to + 1;
+    QVarLengthArray<Segment, 8> segments;
+    for (int i = qMax(0, finestTier); i < m_tiers.count(); ++i) {
+        const Tier& tier = m_tiers.at(i);
+        if (tier.count == 0)
+            continue;
+
+        Segment segment;
+        segment.tier = i;
+        segment.first = lowerBound(tier, from);
+        segment.last = lowerBound(tier, limit);
+        if (segment.last > segment.first)
+            segments.append(segment);
+
+        // This tier covers the rest of the range
+        const qint64 oldest = tier.start.at(tier.head);
+        if (oldest <= from)
+            break;
+
+        limit = oldest;
+    }
+
+    // Copy the points, from oldest to newest
+    for (int s = segments.count() - 1; s >= 0; --s) {
+        const Segment& segment = segments.at(s);
+        const Tier& tier = m_tiers.at(segment.tier);
+        const int offset = channel * tier.capacity;
+
+        for (int j = segment.first; j < segment.last; ++j) {
+            const int slot = (tier.head + j) % tier.capacity;
+
+            HistoryPoint point;
+            point.time = tier.start.at(slot);
+            point.end = tier.end.at(slot);
+            point.mean = tier.mean.at(offset + slot);
+            if (segment.tier == 0) {
+                point.min = point.mean;
+                point.max = point.mean;
+            } else {
+                point.min = tier.min.at(offset + slot);
+                point.max = tier.max.at(offset + slot);
+            }
+
+            points.append(point);
+        }
+    }
+
+    return points.count();
+}
+
+/**
+ * @returns the newest value of the given @a channel
+ */
+double TelemetryHistory::latest(const int channel) const {
+    const Tier& raw = m_tiers.first();
+    if (raw.count == 0 || channel < 0 || channel >= kChannelCount)
+        return 0;
+
+    const int slot = (raw.head + raw.count - 1) % raw.capacity;
+    return raw.mean.at(channel * raw.capacity + slot);
+}
+
+/**
+ * @returns a list of objects with the @c time, @c end, @c min, @c max and
+ *          @c mean values of the given @a channel between the @a from and
+ *          @a to times (see @c query())
+ */
+QVariantList TelemetryHistory::range(const int channel,
+                                     const qint64 from,
+                                     const qint64 to) const {
+    QVector<HistoryPoint> points;
+    query(channel, from, to, points);
+
+    QVariantList list;
+    list.reserve(points.count());
+    foreach (const HistoryPoint& point, points) {
+        QVariantMap map;
+        map.insert("time", point.time);
+        map.insert("end", point.end);
+        map.insert("min", point.min);
+        map.insert("max", point.max);
+        map.insert("mean", point.mean);
+        list.append(map);
+    }
+
+    return list;
+}
+
+/**
+ * Removes all the data from the history (memory is not released)
+ */
+void TelemetryHistory::clear() {
+    for (int i = 0; i < m_tiers.count(); ++i) {
+        m_tiers[i].head = 0;
+        m_tiers[i].count = 0;
+    }
+
+    for (int i = 0; i < m_accumulators.count(); ++i)
+        m_accumulators[i].count = 0;
+
+    m_appendCount = 0;
+    m_timeOffset = 0;
+    m_lastMissionTime = 0;
+    notify();
+}
+
+/**
+ * Emits the @c changed() signal if data was added (or removed) since the
+ * last call, this is called by the @c DataParser when it notifies the user
+ * interface, instead of notifying it for every sample
+ */
+void TelemetryHistory::notify() {
+    if (m_notifiedCount != m_appendCount) {
+        m_notifiedCount = m_appendCount;
+        emit changed();
+    }
+}
+
+/**
+ * @brief Adds an item to the bucket that is being built for the given tier
+ *        @a level
+ *
+ * When the bucket is complete, it is stored in the tier and added to the
+ * bucket of the next tier.
+ */
+void TelemetryHistory::feed(const int level, const qint64 start,
+                            const qint64 end, const double* min,
+                            const double* max, const double* mean) {
+    Accumulator& acc = m_accumulators[level - 1];
+
+    // Add item to the bucket
+    if (acc.count == 0) {
+        acc.start = start;
+        for (int i = 0; i < kChannelCount; ++i) {
+            acc.min[i] = min[i];
+            acc.max[i] = max[i];
+            acc.sum[i] = mean[i];
+        }
+    }
+
+    else {
+        for (int i = 0; i < kChannelCount; ++i) {
+            acc.min[i] = qMin(acc.min[i], min[i]);
+            acc.max[i] = qMax(acc.max[i], max[i]);
+            acc.sum[i] += mean[i];
+        }
+    }
+
+    acc.end = end;
+    if (++acc.count < m_factor)
+        return;
+
+    // Bucket is complete, store it in the tier
+    double means[kChannelCount];
+    Tier& tier = m_tiers[level];
+    const int slot = push(tier, acc.start, acc.end);
+    for (int i = 0; i < kChannelCount; ++i) {
+        means[i] = acc.sum[i] / acc.count;
+        tier.min[i * tier.capacity + slot] = acc.min[i];
+        tier.max[i * tier.capacity + slot] = acc.max[i];
+        tier.mean[i * tier.capacity + slot] = means[i];
+    }
+
+    // Start a new bucket and update the next tier
+    acc.count = 0;
+    if (level + 1 < m_tiers.count())
+        feed(level + 1, acc.start, acc.end, acc.min, acc.max, means);
+}
+
+/**
+ * Adds a new item to the given @a tier (overwriting the oldest item if the
+ * tier is full)
+ *
+ * @returns the slot in which the values of the new item must be written
+ */
+int TelemetryHistory::push(Tier& tier, const qint64 start, const qint64 end) {
+    int slot;
+    if (tier.count < tier.capacity) {
+        slot = (tier.head + tier.count) % tier.capacity;
+        ++tier.count;
+    } else {
+        slot = tier.head;
+        tier.head = (tier.head + 1) % tier.capacity;
+    }
+
+    tier.start[slot] = start;
+    tier.end[slot] = end;
+    return slot;
+}
+
+/**
+ * @returns the logical index of the first item of the given @a tier that
+ *          ends at or after the given @a time
+ */
+int TelemetryHistory::lowerBound(const Tier& tier, const qint64 time) const {
+    int first = 0;
+    int count = tier.count;
+    while (count > 0) {
+        const int step = count / 2;
+        const int slot = (tier.head + first + step) % tier.capacity;
+        if (tier.end.at(slot) < time) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    return first;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_HISTORY_H
+#define TELEMETRY_HISTORY_H
+
+#include <QVector>
+#include <QObject>
+#include <QVariantList>
+
+#include "TelemetryFrame.h"
+
+/**
+ * @brief Value of a channel at a given time, for decimated tiers, the point
+ *        summarizes all the samples received between @c time and @c end
+ */
+struct HistoryPoint {
+    qint64 time;
+    qint64 end;
+    double min;
+    double max;
+    double mean;
+};
+
+/**
+ * @brief In-memory history of every telemetry channel
+ *
+ * There is one column per item of @c DataParser::DataPosition (the channel
+ * number is the position of the value in the packet). Samples are indexed
+ * by mission time and stored in a set of fixed-size ring buffers (tiers):
+ *
+ *     - Tier 0 stores every sample received in the recent window
+ *     - Tier N stores one min/max/mean bucket for every F buckets of
+ *       tier N - 1, so each tier covers F times more time than the previous
+ *       one while using the same amount of memory
+ *
+ * Buckets are produced while samples are appended, so appending a sample
+ * is O(1) and memory usage is bounded, no matter how long the session is.
+ *
+ * @note The mission time restarts when the CanSat is reset, the history
+ *       adds an offset to the mission time after each reset, so that the
+ *       timeline of the session is always monotonic.
+ */
+class TelemetryHistory : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int count
+               READ count
+               NOTIFY changed)
+    Q_PROPERTY(qint64 firstTime
+               READ firstTime
+               NOTIFY changed)
+    Q_PROPERTY(qint64 lastTime
+               READ lastTime
+               NOTIFY changed)
+    Q_PROPERTY(int tierCount
+               READ tierCount
+               CONSTANT)
+
+signals:
+    void changed();
+
+public:
+    enum {
+        kChannelCount = 25
+    };
+
+    explicit TelemetryHistory(QObject* parent = Q_NULLPTR,
+                              const int rawCapacity = 16384,
+                              const int tierCapacity = 2048,
+                              const int tierFactor = 16,
+                              const int tierCount = 4);
+
+    int count() const;
+    qint64 firstTime() const;
+    qint64 lastTime() const;
+    int tierCount() const;
+    quint64 appendCount() const;
+
+    int tierSize(const int tier) const;
+    qint64 tierStart(const int tier) const;
+
+    void append(const TelemetryFrame& frame);
+    int query(const int channel, const qint64 from, const qint64 to,
+              QVector<HistoryPoint>& points, const int finestTier = 0) const;
+
+    Q_INVOKABLE double latest(const int channel) const;
+    Q_INVOKABLE QVariantList range(const int channel,
+                                   const qint64 from,
+                                   const qint64 to) const;
+
+public slots:
+    void clear();
+    void notify();
+
+private:
+    struct Tier {
+        int head;
+        int count;
+        int capacity;
+        QVector<qint64> start;
+        QVector<qint64> end;
+        QVector<double> min;
+        QVector<double> max;
+        QVector<double> mean;
+    };
+
+    struct Accumulator {
+        int count;
+        qint64 start;
+        qint64 end;
+        double min[kChannelCount];
+        double max[kChannelCount];
+        double sum[kChannelCount];
+    };
+
+    void feed(const int level, const qint64 start, const qint64 end,
+              const double* min, const double* max, const double* mean);
+    int push(Tier& tier, const qint64 start, const qint64 end);
+    int lowerBound(const Tier& tier, const qint64 time) const;
+
+private:
+    int m_factor;
+    quint64 m_appendCount;
+    quint64 m_notifiedCount;
+    qint64 m_lastMissionTime;
+    qint64 m_timeOffset;
+
+    QVector<Tier> m_tiers;
+    QVector<Accumulator> m_accumulators;
+};
+
+#endif
@@ -0,0 +1,598 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+#include <cstring>
+
+#include <QPen>
+#include <QtMath>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGRenderNode>
+#include <QSGGeometryNode>
+#include <QSGFlatColorMaterial>
+#include <QSGRendererInterface>
+
+#include "TelemetryPlot.h"
+
+static const qint64 NO_COLUMN = std::numeric_limits<qint64>::min();
+
+/**
+ * Paints the vertices of the plot with the QPainter used by the software
+ * renderer, which does not support custom geometry nodes
+ */
+class PlotPainterNode : public QSGRenderNode {
+public:
+    explicit PlotPainterNode(QQuickItem* item) :
+        m_item(item),
+        m_geometry(QSGGeometry::defaultAttributes_Point2D(), 0),
+        m_sx(1), m_tx(0), m_sy(1), m_ty(0)
+    {
+        m_geometry.setDrawingMode(QSGGeometry::DrawLines);
+    }
+
+    QSGGeometry* geometry() {
+        return &m_geometry;
+    }
+
+    void setPen(const QColor& color, const double width) {
+        m_pen = QPen(color, width);
+        m_pen.setCosmetic(true);
+    }
+
+    void setTransform(const double sx, const double tx,
+                      const double sy, const double ty) {
+        m_sx = sx;
+        m_tx = tx;
+        m_sy = sy;
+        m_ty = ty;
+    }
+
+    StateFlags changedStates() const override {
+        return 0;
+    }
+
+    RenderingFlags flags() const override {
+        return BoundedRectRendering;
+    }
+
+    QRectF rect() const override {
+        return QRectF(0, 0, m_item->width(), m_item->height());
+    }
+
+    void render(const RenderState* state) override {
+        QQuickWindow* window = m_item->window();
+        QPainter* painter = static_cast<QPainter*>(
+                    window->rendererInterface()->getResource(
+                        window, QSGRendererInterface::PainterResource));
+        if (!painter)
+            return;
+
+        // Map vertices to item coordinates, skipping empty segments
+        m_lines.resize(0);
+        const QSGGeometry::Point2D* v = m_geometry.vertexDataAsPoint2D();
+        for (int i = 0; i + 1 < m_geometry.vertexCount(); i += 2) {
+            if (v[i].x == v[i + 1].x && v[i].y == v[i + 1].y)
+                continue;
+
+            m_lines.append(QLineF(v[i].x * m_sx + m_tx,
+                                  v[i].y * m_sy + m_ty,
+                                  v[i + 1].x * m_sx + m_tx,
+                                  v[i + 1].y * m_sy + m_ty));
+        }
+
+        // Clip region must be set before the transform
+        painter->save();
+        const QRegion* clip = state->clipRegion();
+        if (clip && !clip->isEmpty())
+            painter->setClipRegion(*clip, Qt::ReplaceClip);
+
+        painter->setTransform(matrix()->toTransform());
+        painter->setOpacity(inheritedOpacity());
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setPen(m_pen);
+        painter->drawLines(m_lines.constData(), m_lines.count());
+        painter->restore();
+    }
+
+private:
+    QQuickItem* m_item;
+    QSGGeometry m_geometry;
+    QVector<QLineF> m_lines;
+    QPen m_pen;
+
+    double m_sx;
+    double m_tx;
+    double m_sy;
+    double m_ty;
+};
+
+/**
+ * Initializes the item with an auto-scaled, one-minute time span
+ */
+TelemetryPlot::TelemetryPlot(QQuickItem* parent) : QQuickItem(parent),
+    m_channel(0),
+    m_timeSpan(60 * 1000),
+    m_color("#72d5a3"),
+    m_lineWidth(1),
+    m_autoScale(true),
+    m_minimumValue(0),
+    m_maximumValue(100),
+    m_invalidated(true),
+    m_visibleColumns(0),
+    m_columnDuration(0),
+    m_originColumn(0),
+    m_lastColumn(NO_COLUMN),
+    m_lastTime(0),
+    m_appendCount(0),
+    m_valueOrigin(0)
+{
+    setFlag(ItemHasContents, true);
+}
+
+/**
+ * Returns the history from which the data is read
+ */
+TelemetryHistory* TelemetryPlot::history() const {
+    return m_history.data();
+}
+
+/**
+ * Returns the channel (@c DataParser::DataPosition) that is plotted
+ */
+int TelemetryPlot::channel() const {
+    return m_channel;
+}
+
+/**
+ * Returns the mission time (in milliseconds) that is visible in the plot
+ */
+int TelemetryPlot::timeSpan() const {
+    return m_timeSpan;
+}
+
+/**
+ * Returns the color of the plotted line
+ */
+QColor TelemetryPlot::color() const {
+    return m_color;
+}
+
+/**
+ * Returns the width (in pixels) of the plotted line
+ */
+double TelemetryPlot::lineWidth() const {
+    return m_lineWidth;
+}
+
+/**
+ * Returns @c true if the vertical range is adjusted to the visible data,
+ * otherwise @c minimumValue and @c maximumValue are used
+ */
+bool TelemetryPlot::autoScale() const {
+    return m_autoScale;
+}
+
+/**
+ * Returns the value shown at the bottom of the plot (without auto-scale)
+ */
+double TelemetryPlot::minimumValue() const {
+    return m_minimumValue;
+}
+
+/**
+ * Returns the value shown at the top of the plot (without auto-scale)
+ */
+double TelemetryPlot::maximumValue() const {
+    return m_maximumValue;
+}
+
+/**
+ * Changes the history from which the data is read, the item is repainted
+ * every time that the history notifies new data
+ */
+void TelemetryPlot::setHistory(TelemetryHistory* history) {
+    if (m_history == history)
+        return;
+
+    if (m_history)
+        disconnect(m_history, SIGNAL(changed()), this, SLOT(update()));
+
+    m_history = history;
+    if (m_history)
+        connect(m_history, SIGNAL(changed()), this, SLOT(update()));
+
+    emit historyChanged();
+    invalidate();
+}
+
+/**
+ * Changes the channel (@c DataParser::DataPosition) that is plotted
+ */
+void TelemetryPlot::setChannel(const int channel) {
+    if (m_channel != channel) {
+        m_channel = channel;
+        emit channelChanged();
+        invalidate();
+    }
+}
+
+/**
+ * Changes the mission time (in milliseconds) that is visible in the plot
+ */
+void TelemetryPlot::setTimeSpan(const int timeSpan) {
+    if (m_timeSpan != timeSpan && timeSpan > 0) {
+        m_timeSpan = timeSpan;
+        emit timeSpanChanged();
+        invalidate();
+    }
+}
+
+/**
+ * Changes the color of the plotted line
+ */
+void TelemetryPlot::setColor(const QColor& color) {
+    if (m_color != color) {
+        m_color = color;
+        emit colorChanged();
+        update();
+    }
+}
+
+/**
+ * Changes the width of the plotted line
+ */
+void TelemetryPlot::setLineWidth(const double width) {
+    if (m_lineWidth != width) {
+        m_lineWidth = width;
+        emit lineWidthChanged();
+        update();
+    }
+}
+
+/**
+ * Enables or disables automatic adjustment of the vertical range
+ */
+void TelemetryPlot::setAutoScale(const bool enabled) {
+    if (m_autoScale != enabled) {
+        m_autoScale = enabled;
+        emit scaleChanged();
+        update();
+    }
+}
+
+/**
+ * Changes the value shown at the bottom of the plot (without auto-scale)
+ */
+void TelemetryPlot::setMinimumValue(const double value) {
+    if (m_minimumValue != value) {
+        m_minimumValue = value;
+        emit scaleChanged();
+        update();
+    }
+}
+
+/**
+ * Changes the value shown at the top of the plot (without auto-scale)
+ */
+void TelemetryPlot::setMaximumValue(const double value) {
+    if (m_maximumValue != value) {
+        m_maximumValue = value;
+        emit scaleChanged();
+        update();
+    }
+}
+
+/**
+ * Synchronizes the scene graph with the history, this function is called
+ * from the render thread while the GUI thread is blocked, so it is safe to
+ * read the history here
+ */
+QSGNode* TelemetryPlot::updatePaintNode(QSGNode* oldNode,
+                                        UpdatePaintNodeData* data) {
+    Q_UNUSED(data);
+
+    // Nothing to draw
+    if (!m_history || width() < 1 || height() < 1) {
+        delete oldNode;
+        m_invalidated = true;
+        return Q_NULLPTR;
+    }
+
+    // The software renderer cannot draw custom geometry, use a QPainter
+    double sx, tx, sy, ty;
+    const QSGRendererInterface* renderer = window()->rendererInterface();
+    if (renderer->graphicsApi() == QSGRendererInterface::Software) {
+        PlotPainterNode* node = static_cast<PlotPainterNode*>(oldNode);
+        if (!node) {
+            node = new PlotPainterNode(this);
+            m_invalidated = true;
+        }
+
+        syncColumns(node->geometry());
+        computeTransform(sx, tx, sy, ty);
+        node->setTransform(sx, tx, sy, ty);
+        node->setPen(m_color, m_lineWidth);
+        node->markDirty(QSGNode::DirtyMaterial);
+        return node;
+    }
+
+    // Create the transform and geometry nodes
+    QSGTransformNode* root = static_cast<QSGTransformNode*>(oldNode);
+    if (!root) {
+        QSGGeometry* geometry = new QSGGeometry(
+                    QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawLines);
+
+        QSGGeometryNode* node = new QSGGeometryNode;
+        node->setGeometry(geometry);
+        node->setMaterial(new QSGFlatColorMaterial);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setFlag(QSGNode::OwnsMaterial);
+
+        root = new QSGTransformNode;
+        root->appendChildNode(node);
+        m_invalidated = true;
+    }
+
+    // Update the vertices of the columns that received new data
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(root->firstChild());
+    QSGGeometry* geometry = node->geometry();
+    geometry->setLineWidth(m_lineWidth);
+    if (syncColumns(geometry))
+        node->markDirty(QSGNode::DirtyGeometry);
+
+    // Update the color
+    QSGFlatColorMaterial* material =
+            static_cast<QSGFlatColorMaterial*>(node->material());
+    if (material->color() != m_color) {
+        material->setColor(m_color);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    // Scroll and scale the plot
+    computeTransform(sx, tx, sy, ty);
+    root->setMatrix(QMatrix4x4(sx, 0, 0, tx,
+                               0, sy, 0, ty,
+                               0, 0, 1, 0,
+                               0, 0, 0, 1));
+
+    return root;
+}
+
+/**
+ * Re-builds the plot when the size of the item changes
+ */
+void TelemetryPlot::geometryChanged(const QRectF& newGeometry,
+                                    const QRectF& oldGeometry) {
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        invalidate();
+}
+
+/**
+ * Discards all the computed columns and schedules a repaint
+ */
+void TelemetryPlot::invalidate() {
+    m_invalidated = true;
+    update();
+}
+
+/**
+ * Updates the columns (and their vertices) that received new samples since
+ * the last call, all the columns are re-built if the layout of the plot or
+ * the history were reset.
+ *
+ * Each column uses four vertices (two line segments): the first one joins
+ * the last value of the previous column with the first value of the column,
+ * the second one goes from the minimum value to the maximum value of the
+ * column. The X coordinate of each vertex is the column number (relative to
+ * the first column that was built) and the Y coordinate is the value of the
+ * channel (relative to the first value that was plotted).
+ *
+ * @returns @c true if the vertex data was changed
+ */
+bool TelemetryPlot::syncColumns(QSGGeometry* geometry) {
+    // Use one column per pixel
+    const int visibleColumns = qMax(2, qCeil(width()));
+    const double duration = qMax(1e-3, m_timeSpan / double(visibleColumns));
+    if (visibleColumns != m_visibleColumns || duration != m_columnDuration) {
+        m_visibleColumns = visibleColumns;
+        m_columnDuration = duration;
+        m_invalidated = true;
+    }
+
+    // The history was cleared
+    const qint64 lastTime = m_history->lastTime();
+    const quint64 appendCount = m_history->appendCount();
+    if (appendCount < m_appendCount || lastTime < m_lastTime)
+        m_invalidated = true;
+
+    // Clear all columns and vertices
+    const int ringSize = m_visibleColumns + 2;
+    bool modified = false;
+    if (m_invalidated) {
+        Column empty;
+        empty.index = NO_COLUMN;
+        empty.valid = false;
+        empty.first = empty.last = empty.min = empty.max = 0;
+        m_columns.fill(empty, ringSize);
+
+        geometry->allocate(ringSize * 4);
+        memset(geometry->vertexData(), 0,
+               geometry->vertexCount() * geometry->sizeOfVertex());
+
+        m_lastTime = 0;
+        m_appendCount = 0;
+        m_lastColumn = NO_COLUMN;
+        m_invalidated = false;
+        modified = true;
+    }
+
+    // Nothing new to plot
+    if (m_history->count() == 0 || appendCount == m_appendCount)
+        return modified;
+
+    // Start plotting at the left border, or re-compute the last column
+    // (which may have been incomplete during the last update)
+    const qint64 newest = static_cast<qint64>(
+                std::floor(lastTime / m_columnDuration));
+    qint64 first = m_lastColumn;
+    if (first == NO_COLUMN) {
+        first = newest - m_visibleColumns + 1;
+        m_originColumn = first;
+        m_valueOrigin = m_history->latest(m_channel);
+    }
+
+    first = qMax(first, newest - ringSize + 1);
+    for (qint64 c = first; c <= newest; ++c) {
+        Column& column = m_columns[((c % ringSize) + ringSize) % ringSize];
+        column.index = c;
+        column.valid = false;
+    }
+
+    // Aggregate the new samples in each column
+    const qint64 from = static_cast<qint64>(
+                std::floor(first * m_columnDuration));
+    m_history->query(m_channel, from, lastTime, m_points);
+    foreach (const HistoryPoint& point, m_points) {
+        const qint64 c = static_cast<qint64>(
+                    std::floor(point.time / m_columnDuration));
+        if (c < first || c > newest)
+            continue;
+
+        Column& column = m_columns[((c % ringSize) + ringSize) % ringSize];
+        const double mean = point.mean - m_valueOrigin;
+        const double min = point.min - m_valueOrigin;
+        const double max = point.max - m_valueOrigin;
+        if (!column.valid) {
+            column.valid = true;
+            column.first = mean;
+            column.min = min;
+            column.max = max;
+        } else {
+            column.min = qMin(column.min, min);
+            column.max = qMax(column.max, max);
+        }
+
+        column.last = mean;
+    }
+
+    // Update the vertices of the modified columns only
+    for (qint64 c = first; c <= newest; ++c)
+        writeColumn(geometry, c);
+
+    m_lastTime = lastTime;
+    m_lastColumn = newest;
+    m_appendCount = appendCount;
+    return true;
+}
+
+/**
+ * Writes the four vertices of the given column, empty columns use
+ * zero-length segments, which are not rasterized
+ */
+void TelemetryPlot::writeColumn(QSGGeometry* geometry, const qint64 index) {
+    const int ringSize = m_columns.count();
+    const int slot = ((index % ringSize) + ringSize) % ringSize;
+    const Column& column = m_columns.at(slot);
+    const float x = index - m_originColumn;
+
+    QSGGeometry::Point2D* v = geometry->vertexDataAsPoint2D() + slot * 4;
+    if (!column.valid) {
+        for (int i = 0; i < 4; ++i)
+            v[i].set(x, 0);
+
+        return;
+    }
+
+    // Find the previous column with data (if it still exists)
+    v[0].set(x, column.first);
+    for (qint64 c = index - 1; c > index - ringSize; --c) {
+        const Column& previous = m_columns.at(((c % ringSize) + ringSize)
+                                              % ringSize);
+        if (previous.index != c)
+            break;
+
+        if (previous.valid) {
+            v[0].set(c - m_originColumn, previous.last);
+            break;
+        }
+    }
+
+    v[1].set(x, column.first);
+    v[2].set(x, column.min);
+    v[3].set(x, column.max);
+}
+
+/**
+ * Calculates the transformation from vertex coordinates to item coordinates,
+ * so that the newest column is aligned with the right border of the item.
+ *
+ * Item coordinates are obtained as @c (x*sx+tx, y*sy+ty).
+ */
+void TelemetryPlot::computeTransform(double& sx, double& tx,
+                                     double& sy, double& ty) {
+    // Nothing has been plotted yet
+    if (m_lastColumn == NO_COLUMN) {
+        sx = sy = 1;
+        tx = ty = 0;
+        return;
+    }
+
+    // Horizontal axis
+    const double columnWidth = width() / m_visibleColumns;
+    sx = columnWidth;
+    tx = (m_visibleColumns - 0.5 - (m_lastColumn - m_originColumn))
+            * columnWidth;
+
+    // Vertical axis, use the range of the visible columns
+    double min = m_minimumValue - m_valueOrigin;
+    double max = m_maximumValue - m_valueOrigin;
+    if (m_autoScale) {
+        bool found = false;
+        const int ringSize = m_columns.count();
+        const qint64 first = m_lastColumn - m_visibleColumns + 1;
+        for (qint64 c = first; c <= m_lastColumn; ++c) {
+            const Column& column = m_columns.at(((c % ringSize) + ringSize)
+                                                % ringSize);
+            if (column.index != c || !column.valid)
+                continue;
+
+            min = found ? qMin(min, column.min) : column.min;
+            max = found ? qMax(max, column.max) : column.max;
+            found = true;
+        }
+
+        // Add some margin to the top and bottom of the plot
+        const double margin = (max - min) * 0.05;
+        min -= (margin > 0) ? margin : 1;
+        max += (margin > 0) ? margin : 1;
+    }
+
+    if (max <= min)
+        max = min + 1;
+
+    sy = -height() / (max - min);
+    ty = height() - min * sy;
+}
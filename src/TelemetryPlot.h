@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_PLOT_H
+#define TELEMETRY_PLOT_H
+
+#include <QColor>
+#include <QVector>
+#include <QPointer>
+#include <QQuickItem>
+
+#ifdef QT_QML_LIB
+#include <QtQml>
+#endif
+
+#include "TelemetryHistory.h"
+
+class QSGGeometry;
+
+/**
+ * @brief Real-time plot of a single channel of a @c TelemetryHistory
+ *
+ * The item builds its geometry directly in the scene graph, without going
+ * through QtCharts or a QML Canvas. The visible time span is divided in one
+ * column per pixel, and each column is drawn as the min/max envelope of the
+ * samples that fall inside it, so the amount of geometry depends only on
+ * the width of the item, no matter how many samples are received.
+ *
+ * Columns are aligned to the mission time and stored in a ring buffer (in
+ * the vertex buffer as well), and vertices contain raw channel values. When
+ * new samples arrive only the columns that received data are re-computed,
+ * scrolling and scaling are applied with a transformation matrix.
+ *
+ * With the software renderer, the same vertices are painted by a
+ * @c QSGRenderNode using the QPainter of the window.
+ */
+class TelemetryPlot : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(TelemetryHistory* history
+               READ history
+               WRITE setHistory
+               NOTIFY historyChanged)
+    Q_PROPERTY(int channel
+               READ channel
+               WRITE setChannel
+               NOTIFY channelChanged)
+    Q_PROPERTY(int timeSpan
+               READ timeSpan
+               WRITE setTimeSpan
+               NOTIFY timeSpanChanged)
+    Q_PROPERTY(QColor color
+               READ color
+               WRITE setColor
+               NOTIFY colorChanged)
+    Q_PROPERTY(double lineWidth
+               READ lineWidth
+               WRITE setLineWidth
+               NOTIFY lineWidthChanged)
+    Q_PROPERTY(bool autoScale
+               READ autoScale
+               WRITE setAutoScale
+               NOTIFY scaleChanged)
+    Q_PROPERTY(double minimumValue
+               READ minimumValue
+               WRITE setMinimumValue
+               NOTIFY scaleChanged)
+    Q_PROPERTY(double maximumValue
+               READ maximumValue
+               WRITE setMaximumValue
+               NOTIFY scaleChanged)
+
+signals:
+    void historyChanged();
+    void channelChanged();
+    void timeSpanChanged();
+    void colorChanged();
+    void lineWidthChanged();
+    void scaleChanged();
+
+public:
+    explicit TelemetryPlot(QQuickItem* parent = Q_NULLPTR);
+
+    static void DeclareQML()
+    {
+#ifdef QT_QML_LIB
+        qmlRegisterType<TelemetryPlot>("KaanSat", 1, 0, "TelemetryPlot");
+#endif
+    }
+
+    TelemetryHistory* history() const;
+    int channel() const;
+    int timeSpan() const;
+    QColor color() const;
+    double lineWidth() const;
+    bool autoScale() const;
+    double minimumValue() const;
+    double maximumValue() const;
+
+public slots:
+    void setHistory(TelemetryHistory* history);
+    void setChannel(const int channel);
+    void setTimeSpan(const int timeSpan);
+    void setColor(const QColor& color);
+    void setLineWidth(const double width);
+    void setAutoScale(const bool enabled);
+    void setMinimumValue(const double value);
+    void setMaximumValue(const double value);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode,
+                             UpdatePaintNodeData* data) override;
+    void geometryChanged(const QRectF& newGeometry,
+                         const QRectF& oldGeometry) override;
+
+private slots:
+    void invalidate();
+
+private:
+    struct Column {
+        qint64 index;
+        bool valid;
+        double first;
+        double last;
+        double min;
+        double max;
+    };
+
+    bool syncColumns(QSGGeometry* geometry);
+    void writeColumn(QSGGeometry* geometry, const qint64 index);
+    void computeTransform(double& sx, double& tx, double& sy, double& ty);
+
+private:
+    QPointer<TelemetryHistory> m_history;
+    int m_channel;
+    int m_timeSpan;
+    QColor m_color;
+    double m_lineWidth;
+    bool m_autoScale;
+    double m_minimumValue;
+    double m_maximumValue;
+
+    bool m_invalidated;
+    int m_visibleColumns;
+    double m_columnDuration;
+    qint64 m_originColumn;
+    qint64 m_lastColumn;
+    qint64 m_lastTime;
+    quint64 m_appendCount;
+    double m_valueOrigin;
+
+    QVector<Column> m_columns;
+    QVector<HistoryPoint> m_points;
+};
+
+#endif
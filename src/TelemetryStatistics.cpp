@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include "DataParser.h"
+#include "TelemetryStatistics.h"
+
+Q_STATIC_ASSERT(TelemetryStatistics::kChannelCount ==
+                static_cast<int>(DataParser::kChecksumCode));
+
+/**
+ * Name of each channel, in the same order as @c DataParser::DataPosition
+ */
+static const char* CHANNEL_NAMES[TelemetryStatistics::kChannelCount] = {
+    "header",
+    "teamId",
+    "packetCount",
+    "altitude",
+    "atmosphericPressure",
+    "voltage",
+    "intTemperature",
+    "extTemperature",
+    "airQuality",
+    "carbonMonoxide",
+    "gpsTime",
+    "gpsLongitudeDeg",
+    "gpsLongitudeMin",
+    "gpsLatitudeDeg",
+    "gpsLatitudeMin",
+    "gpsAltitude",
+    "gpsSatelliteCount",
+    "accelerometerX",
+    "accelerometerY",
+    "accelerometerZ",
+    "magnetometerX",
+    "magnetometerY",
+    "magnetometerZ",
+    "missionTime",
+    "parachute"
+};
+
+/**
+ * Removes the first item of a monotonic queue, memory is reclaimed once the
+ * removed items use more space than the remaining ones
+ */
+static void PopFront(QVector<quint64>& items, int& head) {
+    ++head;
+    if (head >= 1024 && head * 2 >= items.count()) {
+        items.remove(0, head);
+        head = 0;
+    }
+}
+
+/**
+ * Initializes the model with a 10-second window
+ */
+TelemetryStatistics::TelemetryStatistics(QObject* parent) :
+    QAbstractListModel(parent),
+    m_windowSpan(10 * 1000),
+    m_appendCount(0),
+    m_notifiedCount(0),
+    m_head(0),
+    m_count(0),
+    m_capacity(0),
+    m_firstSequence(0),
+    m_removals(0)
+{
+    clear();
+}
+
+/**
+ * Returns the mission time (in milliseconds) covered by the window
+ * statistics
+ */
+int TelemetryStatistics::windowSpan() const {
+    return m_windowSpan;
+}
+
+/**
+ * Returns the number of channels with statistics (the header and the
+ * checksum are not included)
+ */
+int TelemetryStatistics::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid())
+        return 0;
+
+    return kChannelCount - 1;
+}
+
+/**
+ * Returns the statistic identified by @a role for the channel at the given
+ * row, the first row corresponds to @c DataParser::kTeamID
+ */
+QVariant TelemetryStatistics::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount())
+        return QVariant();
+
+    return channelData(index.row() + 1, role);
+}
+
+/**
+ * Returns the names used to access each statistic from QML
+ */
+QHash<int, QByteArray> TelemetryStatistics::roleNames() const {
+    QHash<int, QByteArray> names;
+    names.insert(ChannelRole, "channel");
+    names.insert(NameRole, "name");
+    names.insert(CountRole, "count");
+    names.insert(LastRole, "last");
+    names.insert(MinimumRole, "minimum");
+    names.insert(MaximumRole, "maximum");
+    names.insert(MeanRole, "mean");
+    names.insert(VarianceRole, "variance");
+    names.insert(DeviationRole, "deviation");
+    names.insert(RateRole, "rate");
+    names.insert(UnchangedRole, "unchanged");
+    names.insert(WindowCountRole, "windowCount");
+    names.insert(WindowMinimumRole, "windowMinimum");
+    names.insert(WindowMaximumRole, "windowMaximum");
+    names.insert(WindowMeanRole, "windowMean");
+    names.insert(WindowVarianceRole, "windowVariance");
+    names.insert(WindowDeviationRole, "windowDeviation");
+    names.insert(WindowRateRole, "windowRate");
+    return names;
+}
+
+/**
+ * Updates the statistics of every channel with the values of the given
+ * @a frame. The @a time (in milliseconds) must be monotonic during the
+ * session, use the timeline of the @c TelemetryHistory.
+ */
+void TelemetryStatistics::append(const TelemetryFrame& frame,
+                                 const qint64 time) {
+    // Remove samples that are no longer inside the window
+    expire(time - m_windowSpan);
+
+    // Grow the sample buffer if needed, keeping the oldest sample first
+    if (m_count == m_capacity) {
+        const int capacity = qMax(64, m_capacity * 2);
+        QVector<qint64> times(capacity);
+        QVector<double> values(capacity * kChannelCount);
+        for (int i = 0; i < m_count; ++i) {
+            const int slot = (m_head + i) % m_capacity;
+            times[i] = m_times.at(slot);
+            for (int j = 0; j < kChannelCount; ++j)
+                values[i * kChannelCount + j] =
+                        m_values.at(slot * kChannelCount + j);
+        }
+
+        m_head = 0;
+        m_capacity = capacity;
+        m_times.swap(times);
+        m_values.swap(values);
+    }
+
+    // Store the sample in the window
+    const int slot = (m_head + m_count) % m_capacity;
+    const quint64 sequence = m_firstSequence + m_count;
+    double* values = m_values.data() + slot * kChannelCount;
+    for (int i = 0; i < kChannelCount; ++i)
+        values[i] = DataParser::frameValue(frame, i);
+
+    m_times[slot] = time;
+    ++m_count;
+
+    // Update the statistics of each channel
+    for (int i = 1; i < kChannelCount; ++i) {
+        Channel& c = m_channels[i];
+        const double x = values[i];
+
+        // Session minimum, maximum, rate of change and last change
+        if (c.count == 0) {
+            c.min = x;
+            c.max = x;
+            c.changeTime = time;
+        } else {
+            c.min = qMin(c.min, x);
+            c.max = qMax(c.max, x);
+            if (time > c.lastTime)
+                c.rate = (x - c.last) * 1000 / (time - c.lastTime);
+            if (x != c.last)
+                c.changeTime = time;
+        }
+
+        c.last = x;
+        c.lastTime = time;
+
+        // Session mean and variance
+        ++c.count;
+        double delta = x - c.mean;
+        c.mean += delta / c.count;
+        c.m2 += delta * (x - c.mean);
+
+        // Window mean and variance
+        ++c.windowCount;
+        delta = x - c.windowMean;
+        c.windowMean += delta / c.windowCount;
+        c.windowM2 += delta * (x - c.windowMean);
+
+        // Window minimum and maximum
+        QVector<quint64>& min = c.minQueue.items;
+        while (min.count() > c.minQueue.head && value(min.last(), i) >= x)
+            min.removeLast();
+
+        QVector<quint64>& max = c.maxQueue.items;
+        while (max.count() > c.maxQueue.head && value(max.last(), i) <= x)
+            max.removeLast();
+
+        min.append(sequence);
+        max.append(sequence);
+    }
+
+    ++m_appendCount;
+}
+
+/**
+ * Returns all the statistics of the given @a channel
+ * (@c DataParser::DataPosition), using the role names as keys
+ */
+QVariantMap TelemetryStatistics::get(const int channel) const {
+    QVariantMap map;
+    if (channel <= 0 || channel >= kChannelCount)
+        return map;
+
+    const QHash<int, QByteArray> names = roleNames();
+    for (auto i = names.constBegin(); i != names.constEnd(); ++i)
+        map.insert(QString::fromLatin1(i.value()),
+                   channelData(channel, i.key()));
+
+    return map;
+}
+
+/**
+ * Deletes all the statistics
+ */
+void TelemetryStatistics::clear() {
+    beginResetModel();
+
+    for (int i = 0; i < kChannelCount; ++i) {
+        Channel& c = m_channels[i];
+        c.count = 0;
+        c.last = 0;
+        c.min = 0;
+        c.max = 0;
+        c.mean = 0;
+        c.m2 = 0;
+        c.rate = 0;
+        c.lastTime = 0;
+        c.changeTime = 0;
+        c.windowCount = 0;
+        c.windowMean = 0;
+        c.windowM2 = 0;
+        c.minQueue.head = 0;
+        c.minQueue.items.clear();
+        c.maxQueue.head = 0;
+        c.maxQueue.items.clear();
+    }
+
+    m_head = 0;
+    m_count = 0;
+    m_removals = 0;
+    m_appendCount = 0;
+    m_notifiedCount = 0;
+    m_firstSequence = 0;
+
+    endResetModel();
+    emit changed();
+}
+
+/**
+ * Notifies the views if new samples were appended since the last call
+ */
+void TelemetryStatistics::notify() {
+    if (m_notifiedCount != m_appendCount) {
+        m_notifiedCount = m_appendCount;
+        emit dataChanged(index(0), index(rowCount() - 1));
+        emit changed();
+    }
+}
+
+/**
+ * Changes the mission time (in milliseconds) covered by the window
+ * statistics. Samples that were already removed from the window are not
+ * recovered when the window grows.
+ */
+void TelemetryStatistics::setWindowSpan(const int span) {
+    if (span <= 0 || span == m_windowSpan)
+        return;
+
+    m_windowSpan = span;
+    if (m_count > 0) {
+        const int newest = (m_head + m_count - 1) % m_capacity;
+        expire(m_times.at(newest) - m_windowSpan);
+        emit dataChanged(index(0), index(rowCount() - 1));
+        emit changed();
+    }
+
+    emit windowSpanChanged();
+}
+
+/**
+ * Removes all the samples of the window that are older than @a limit
+ */
+void TelemetryStatistics::expire(const qint64 limit) {
+    while (m_count > 0 && m_times.at(m_head) <= limit) {
+        const double* values = m_values.constData() + m_head * kChannelCount;
+        for (int i = 1; i < kChannelCount; ++i) {
+            Channel& c = m_channels[i];
+            const double x = values[i];
+
+            // Reverse Welford update
+            if (--c.windowCount == 0) {
+                c.windowMean = 0;
+                c.windowM2 = 0;
+            } else {
+                const double delta = x - c.windowMean;
+                c.windowMean -= delta / c.windowCount;
+                c.windowM2 = qMax(0.0, c.windowM2 - delta * (x - c.windowMean));
+            }
+
+            // Remove the sample from the monotonic queues
+            MonotonicQueue& min = c.minQueue;
+            if (min.items.count() > min.head
+                    && min.items.at(min.head) == m_firstSequence)
+                PopFront(min.items, min.head);
+
+            MonotonicQueue& max = c.maxQueue;
+            if (max.items.count() > max.head
+                    && max.items.at(max.head) == m_firstSequence)
+                PopFront(max.items, max.head);
+        }
+
+        m_head = (m_head + 1) % m_capacity;
+        ++m_firstSequence;
+        ++m_removals;
+        --m_count;
+    }
+
+    // Discard the rounding errors accumulated by the reverse updates
+    if (m_removals > static_cast<quint64>(qMax(m_count, 65536)))
+        recomputeWindow();
+}
+
+/**
+ * Re-computes the mean and variance of the window from its samples
+ */
+void TelemetryStatistics::recomputeWindow() {
+    for (int i = 1; i < kChannelCount; ++i) {
+        Channel& c = m_channels[i];
+        c.windowCount = 0;
+        c.windowMean = 0;
+        c.windowM2 = 0;
+
+        for (int j = 0; j < m_count; ++j) {
+            const int slot = (m_head + j) % m_capacity;
+            const double x = m_values.at(slot * kChannelCount + i);
+            const double delta = x - c.windowMean;
+            ++c.windowCount;
+            c.windowMean += delta / c.windowCount;
+            c.windowM2 += delta * (x - c.windowMean);
+        }
+    }
+
+    m_removals = 0;
+}
+
+/**
+ * Returns the value of the given @a channel for the sample with the given
+ * @a sequence number, the sample must be inside the window
+ */
+double TelemetryStatistics::value(const quint64 sequence,
+                                  const int channel) const {
+    const int slot = (m_head + static_cast<int>(sequence - m_firstSequence))
+            % m_capacity;
+    return m_values.at(slot * kChannelCount + channel);
+}
+
+/**
+ * Returns the statistic identified by @a role for the given @a channel
+ */
+QVariant TelemetryStatistics::channelData(const int channel,
+                                          const int role) const {
+    const Channel& c = m_channels[channel];
+    const bool window = c.windowCount > 0;
+
+    switch (role) {
+    case ChannelRole:
+        return channel;
+    case NameRole:
+        return QString::fromLatin1(CHANNEL_NAMES[channel]);
+    case CountRole:
+        return c.count;
+    case LastRole:
+        return c.last;
+    case MinimumRole:
+        return c.min;
+    case MaximumRole:
+        return c.max;
+    case MeanRole:
+        return c.mean;
+    case VarianceRole:
+        return (c.count > 1) ? c.m2 / (c.count - 1) : 0.0;
+    case DeviationRole:
+        return (c.count > 1) ? std::sqrt(c.m2 / (c.count - 1)) : 0.0;
+    case RateRole:
+        return c.rate;
+    case UnchangedRole:
+        return c.lastTime - c.changeTime;
+    case WindowCountRole:
+        return c.windowCount;
+    case WindowMinimumRole:
+        return window ? value(c.minQueue.items.at(c.minQueue.head), channel)
+                      : 0.0;
+    case WindowMaximumRole:
+        return window ? value(c.maxQueue.items.at(c.maxQueue.head), channel)
+                      : 0.0;
+    case WindowMeanRole:
+        return c.windowMean;
+    case WindowVarianceRole:
+        return (c.windowCount > 1) ? c.windowM2 / (c.windowCount - 1) : 0.0;
+    case WindowDeviationRole:
+        return (c.windowCount > 1) ? std::sqrt(c.windowM2 /
+                                               (c.windowCount - 1)) : 0.0;
+    case WindowRateRole: {
+        if (m_count < 2)
+            return 0.0;
+
+        const int first = m_head;
+        const int last = (m_head + m_count - 1) % m_capacity;
+        const qint64 span = m_times.at(last) - m_times.at(first);
+        if (span <= 0)
+            return 0.0;
+
+        return (m_values.at(last * kChannelCount + channel)
+                - m_values.at(first * kChannelCount + channel)) * 1000 / span;
+    }
+    default:
+        return QVariant();
+    }
+}
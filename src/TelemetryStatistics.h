@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TELEMETRY_STATISTICS_H
+#define TELEMETRY_STATISTICS_H
+
+#include <QVector>
+#include <QVariantMap>
+#include <QAbstractListModel>
+
+#include "TelemetryFrame.h"
+
+/**
+ * @brief Running statistics of every numeric telemetry channel
+ *
+ * Statistics are computed for the whole session and for a sliding window
+ * of mission time (@c windowSpan). Every sample is processed in O(1)
+ * (amortized) time:
+ *
+ *     - Mean and variance use Welford's algorithm, the window statistics
+ *       also remove old samples with the inverse of the same update
+ *     - Window minimum and maximum are obtained from monotonic queues
+ *
+ * The model has one row for each channel (@c DataParser::DataPosition,
+ * except the header and checksum). Samples are added as soon as a packet
+ * is parsed, views are notified when @c notify() is called.
+ */
+class TelemetryStatistics : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int windowSpan
+               READ windowSpan
+               WRITE setWindowSpan
+               NOTIFY windowSpanChanged)
+
+signals:
+    void changed();
+    void windowSpanChanged();
+
+public:
+    enum {
+        kChannelCount = 25
+    };
+
+    enum Roles {
+        ChannelRole = Qt::UserRole + 1,
+        NameRole,
+        CountRole,
+        LastRole,
+        MinimumRole,
+        MaximumRole,
+        MeanRole,
+        VarianceRole,
+        DeviationRole,
+        RateRole,
+        UnchangedRole,
+        WindowCountRole,
+        WindowMinimumRole,
+        WindowMaximumRole,
+        WindowMeanRole,
+        WindowVarianceRole,
+        WindowDeviationRole,
+        WindowRateRole
+    };
+
+    explicit TelemetryStatistics(QObject* parent = Q_NULLPTR);
+
+    int windowSpan() const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void append(const TelemetryFrame& frame, const qint64 time);
+    Q_INVOKABLE QVariantMap get(const int channel) const;
+
+public slots:
+    void clear();
+    void notify();
+    void setWindowSpan(const int span);
+
+private:
+    struct MonotonicQueue {
+        int head;
+        QVector<quint64> items;
+    };
+
+    struct Channel {
+        // Session statistics
+        quint64 count;
+        double last;
+        double min;
+        double max;
+        double mean;
+        double m2;
+        double rate;
+        qint64 lastTime;
+        qint64 changeTime;
+
+        // Window statistics
+        int windowCount;
+        double windowMean;
+        double windowM2;
+        MonotonicQueue minQueue;
+        MonotonicQueue maxQueue;
+    };
+
+    void expire(const qint64 time);
+    void recomputeWindow();
+    double value(const quint64 sequence, const int channel) const;
+    QVariant channelData(const int channel, const int role) const;
+
+private:
+    int m_windowSpan;
+    quint64 m_appendCount;
+    quint64 m_notifiedCount;
+
+    // Samples inside the window (a growable ring buffer)
+    int m_head;
+    int m_count;
+    int m_capacity;
+    quint64 m_firstSequence;
+    quint64 m_removals;
+    QVector<qint64> m_times;
+    QVector<double> m_values;
+
+    Channel m_channels[kChannelCount];
+};
+
+#endif
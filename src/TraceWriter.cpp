@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QDebug>
+#include <QThread>
+#include <QDateTime>
+#include <QCoreApplication>
+
+#include "SpscQueue.h"
+#include "TraceWriter.h"
+
+/**
+ * Pointer to the only instance of the trace writer
+ */
+static TraceWriter* instance = Q_NULLPTR;
+
+/**
+ * Set while tracing is enabled, read by every span
+ */
+static QAtomicInt ENABLED(0);
+
+/**
+ * Number of events that each thread can record between two drains
+ */
+static const int BUFFER_CAPACITY = 4096;
+
+/**
+ * Interval (in milliseconds) between drains of the thread buffers
+ */
+static const int DRAIN_INTERVAL = 200;
+
+/**
+ * A span recorded by a thread, times are given in nanoseconds (see
+ * @c MonotonicTime())
+ */
+struct TraceEvent {
+    const char* name;
+    qint64 begin;
+    qint64 end;
+    qint64 value;
+};
+
+/**
+ * Events recorded by a single thread, the thread is the producer and the
+ * GUI thread (which drains the buffers) is the consumer
+ */
+struct TraceBuffer {
+    TraceBuffer() : tid(0), session(0), released(0), queue(BUFFER_CAPACITY) {}
+
+    int tid;
+    int session;
+    QByteArray name;
+    QAtomicInt released;
+    SpscQueue<TraceEvent> queue;
+};
+
+/**
+ * Gives the buffer of a thread back to the trace writer when the thread
+ * finishes, the buffer is re-used by another thread once its last events
+ * have been drained
+ */
+struct TraceBufferHandle {
+    TraceBufferHandle() : buffer(Q_NULLPTR) {}
+    ~TraceBufferHandle() {
+        if (buffer)
+            buffer->released.storeRelease(1);
+
+        buffer = Q_NULLPTR;
+    }
+
+    TraceBuffer* buffer;
+};
+
+/**
+ * Buffer of the calling thread, buffers are owned by the trace writer
+ */
+static thread_local TraceBufferHandle THREAD_BUFFER;
+
+/**
+ * Configures the writer, tracing is disabled by default
+ */
+TraceWriter::TraceWriter() :
+    m_session(0),
+    m_origin(0),
+    m_lastTid(0),
+    m_droppedEvents(0),
+    m_syncBegin(0),
+    m_renderBegin(0)
+{
+    m_block.reserve(64 * 1024);
+    m_file.setSyncMode(AsyncFileWriter::kSyncOnClose);
+
+    m_timer.setInterval(DRAIN_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &TraceWriter::drain);
+}
+
+/**
+ * @returns the only instance of the trace writer
+ */
+TraceWriter* TraceWriter::getInstance() {
+    if (instance == Q_NULLPTR)
+        instance = new TraceWriter();
+
+    return instance;
+}
+
+/**
+ * @returns @c true if tracing is enabled, this function can be called from
+ *          any thread and does not create the trace writer
+ */
+bool TraceWriter::IsEnabled() {
+    return ENABLED.load() != 0;
+}
+
+/**
+ * @returns @c true if tracing is enabled
+ */
+bool TraceWriter::isEnabled() const {
+    return IsEnabled();
+}
+
+/**
+ * @returns the name of the current (or last) trace file
+ */
+QString TraceWriter::fileName() const {
+    return m_file.fileName();
+}
+
+/**
+ * @returns the number of events that were discarded because the buffer of
+ *          their thread was full
+ */
+qint64 TraceWriter::droppedEvents() const {
+    return m_droppedEvents.load();
+}
+
+/**
+ * @brief Records a span with the given @a name that started at @a begin
+ *        and finished at @a end
+ *
+ * This function can be called from any thread, it does not allocate memory
+ * (except the first time that a thread records an event) nor lock a mutex.
+ */
+void TraceWriter::record(const char* name, const qint64 begin,
+                         const qint64 end, const qint64 value) {
+    if (!IsEnabled())
+        return;
+
+    TraceBuffer* buffer = threadBuffer();
+    TraceEvent* event = buffer->queue.back();
+    if (!event) {
+        m_droppedEvents.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    event->name = name;
+    event->begin = begin;
+    event->end = end;
+    event->value = value;
+    buffer->queue.push();
+}
+
+/**
+ * Writes the pending events and closes the trace file
+ */
+void TraceWriter::stop() {
+    if (!IsEnabled())
+        return;
+
+    ENABLED.store(0);
+    m_timer.stop();
+    drain();
+
+    m_file.write("\n]\n");
+    m_file.close();
+
+    if (m_droppedEvents.load() > 0)
+        qWarning() << "Trace buffers overflowed," << m_droppedEvents.load()
+                   << "events were discarded";
+
+    emit enabledChanged();
+}
+
+/**
+ * Starts or stops tracing, the trace is written to a new file in the
+ * application folder
+ */
+void TraceWriter::setEnabled(const bool enabled) {
+    if (enabled)
+        start();
+    else
+        stop();
+}
+
+/**
+ * @brief Starts writing trace events to the file with the given
+ *        @a fileName, if no file name is given, a file is created in
+ *        the application folder
+ *
+ * @returns @c true on success
+ */
+bool TraceWriter::start(const QString& fileName) {
+    stop();
+
+    // Get file name
+    QString name = fileName;
+    if (name.isEmpty()) {
+        const QString path = QString("%1/%2/Traces").arg(
+                    QDir::homePath(), qApp->applicationName());
+        QDir dir(path);
+        if (!dir.exists())
+            dir.mkpath(".");
+
+        name = dir.filePath(QDateTime::currentDateTime().toString(
+                                "yyyy-MM-dd_HH-mm-ss") + ".json");
+    }
+
+    // Discard events recorded after the previous session (the trace file
+    // is closed, so they are not written)
+    drain();
+
+    // Open the file
+    if (!m_file.open(name, QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "Cannot open" << name << "for writting";
+        return false;
+    }
+
+    // Start a new session
+    ++m_session;
+    m_droppedEvents.store(0);
+    m_origin = MonotonicTime();
+
+    // Write the process name
+    m_file.write("[\n");
+    m_file.write(QString("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                         "\"args\":{\"name\":\"%1\"}}")
+                 .arg(qApp->applicationName()).toUtf8());
+
+    // Enable tracing
+    ENABLED.store(1);
+    m_timer.start();
+
+    emit enabledChanged();
+    return true;
+}
+
+/**
+ * Called by the render thread before the scene graph is synchronized with
+ * the QML items (the GUI thread is blocked during synchronization)
+ */
+void TraceWriter::onBeforeSynchronizing() {
+    m_syncBegin = IsEnabled() ? MonotonicTime() : 0;
+}
+
+/**
+ * Called by the render thread after the scene graph was synchronized
+ */
+void TraceWriter::onAfterSynchronizing() {
+    if (m_syncBegin > 0)
+        record("qml.sync", m_syncBegin, MonotonicTime());
+
+    m_syncBegin = 0;
+}
+
+/**
+ * Called by the render thread before the scene graph is rendered
+ */
+void TraceWriter::onBeforeRendering() {
+    m_renderBegin = IsEnabled() ? MonotonicTime() : 0;
+}
+
+/**
+ * Called by the render thread after the frame was swapped, the span
+ * includes the time spent waiting for the buffer swap
+ */
+void TraceWriter::onFrameSwapped() {
+    if (m_renderBegin > 0)
+        record("qml.render", m_renderBegin, MonotonicTime());
+
+    m_renderBegin = 0;
+}
+
+/**
+ * @brief Moves the events of every thread buffer to the trace file
+ *
+ * Events are discarded if the trace file is closed. The buffers of the
+ * threads that finished are moved to the free list once they are empty.
+ */
+void TraceWriter::drain() {
+    QVector<TraceBuffer*> buffers;
+    m_mutex.lock();
+    buffers = m_buffers;
+    m_mutex.unlock();
+
+    const bool enabled = m_file.isOpen();
+    char line[256];
+
+    m_block.resize(0);
+    for (int i = 0; i < buffers.count(); ++i) {
+        TraceBuffer* buffer = buffers.at(i);
+        const bool released = buffer->released.loadAcquire() != 0;
+        TraceEvent* event;
+        while ((event = buffer->queue.front()) != Q_NULLPTR) {
+            if (enabled && event->begin >= m_origin) {
+                // Name the thread before writing its first event
+                if (buffer->session != m_session)
+                    writeThreadName(buffer);
+
+                const double ts = (event->begin - m_origin) / 1e3;
+                const double dur = (event->end - event->begin) / 1e3;
+                int length;
+                if (event->value >= 0)
+                    length = qsnprintf(line, sizeof(line),
+                                       ",\n{\"name\":\"%s\",\"cat\":\"pipeline\","
+                                       "\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                                       "\"ts\":%.3f,\"dur\":%.3f,"
+                                       "\"args\":{\"value\":%lld}}",
+                                       event->name, buffer->tid, ts, dur,
+                                       static_cast<long long>(event->value));
+                else
+                    length = qsnprintf(line, sizeof(line),
+                                       ",\n{\"name\":\"%s\",\"cat\":\"pipeline\","
+                                       "\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                                       "\"ts\":%.3f,\"dur\":%.3f}",
+                                       event->name, buffer->tid, ts, dur);
+
+                if (length > 0)
+                    m_block.append(line, qMin<int>(length, sizeof(line) - 1));
+            }
+
+            buffer->queue.pop();
+        }
+
+        // The thread finished and all its events were drained
+        if (released) {
+            QMutexLocker locker(&m_mutex);
+            m_buffers.removeOne(buffer);
+            m_freeBuffers.append(buffer);
+        }
+    }
+
+    if (enabled && !m_block.isEmpty())
+        m_file.write(m_block);
+}
+
+/**
+ * @returns the buffer of the calling thread, the buffer is taken from the
+ *          free list (or created) and registered the first time that the
+ *          thread records an event
+ */
+TraceBuffer* TraceWriter::threadBuffer() {
+    if (THREAD_BUFFER.buffer == Q_NULLPTR) {
+        TraceBuffer* buffer = Q_NULLPTR;
+        m_mutex.lock();
+        if (!m_freeBuffers.isEmpty()) {
+            buffer = m_freeBuffers.last();
+            m_freeBuffers.removeLast();
+        }
+        m_mutex.unlock();
+
+        if (buffer == Q_NULLPTR)
+            buffer = new TraceBuffer();
+
+        buffer->session = 0;
+        buffer->released.store(0);
+
+        // Name the thread after its object name or its class
+        QThread* thread = QThread::currentThread();
+        if (thread == qApp->thread())
+            buffer->name = "GUI";
+        else if (!thread->objectName().isEmpty())
+            buffer->name = thread->objectName().toUtf8();
+        else
+            buffer->name = thread->metaObject()->className();
+
+        // Remove characters that would need to be escaped in JSON
+        buffer->name.replace('"', '\'');
+        buffer->name.replace('\\', '/');
+
+        QMutexLocker locker(&m_mutex);
+        buffer->tid = ++m_lastTid;
+        m_buffers.append(buffer);
+        THREAD_BUFFER.buffer = buffer;
+    }
+
+    return THREAD_BUFFER.buffer;
+}
+
+/**
+ * Writes the metadata event that names the thread of the given @a buffer
+ */
+void TraceWriter::writeThreadName(TraceBuffer* buffer) {
+    m_block.append(QString(",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                           "\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"%2\"}}")
+                   .arg(buffer->tid)
+                   .arg(QString::fromUtf8(buffer->name)).toUtf8());
+
+    buffer->session = m_session;
+}
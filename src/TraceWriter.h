@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACE_WRITER_H
+#define TRACE_WRITER_H
+
+#include <QTimer>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QAtomicInteger>
+
+#include "Constants.h"
+#include "AsyncFileWriter.h"
+
+struct TraceBuffer;
+
+/**
+ * @brief Writes spans of the ingestion pipeline as Chrome trace events
+ *
+ * When tracing is enabled, each thread records its spans (see @c TraceSpan)
+ * in its own lock-free buffer, which is allocated the first time that the
+ * thread records a span. The GUI thread drains the buffers periodically and
+ * queues the events to an @c AsyncFileWriter in the JSON array format used
+ * by @c chrome://tracing and the Perfetto UI, so that the file can be opened
+ * even if the application does not close it (e.g. after a crash).
+ *
+ * When tracing is disabled, a span costs a single relaxed atomic load.
+ */
+class TraceWriter : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ isEnabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY enabledChanged)
+
+signals:
+    void enabledChanged();
+
+public:
+    static TraceWriter* getInstance();
+
+    static bool IsEnabled();
+    bool isEnabled() const;
+    QString fileName() const;
+    qint64 droppedEvents() const;
+
+    void record(const char* name, const qint64 begin, const qint64 end,
+                const qint64 value = -1);
+
+public slots:
+    void stop();
+    void setEnabled(const bool enabled);
+    bool start(const QString& fileName = QString());
+
+    void onBeforeSynchronizing();
+    void onAfterSynchronizing();
+    void onBeforeRendering();
+    void onFrameSwapped();
+
+private slots:
+    void drain();
+
+private:
+    TraceWriter();
+    TraceBuffer* threadBuffer();
+    void writeThreadName(TraceBuffer* buffer);
+
+private:
+    QTimer m_timer;
+    QByteArray m_block;
+    AsyncFileWriter m_file;
+
+    int m_session;
+    qint64 m_origin;
+
+    QMutex m_mutex;
+    int m_lastTid;
+    QVector<TraceBuffer*> m_buffers;
+    QVector<TraceBuffer*> m_freeBuffers;
+    QAtomicInteger<qint64> m_droppedEvents;
+
+    qint64 m_syncBegin;
+    qint64 m_renderBegin;
+};
+
+/**
+ * @brief Records the time elapsed between its construction and its
+ *        destruction as a trace event
+ *
+ * The @a name must be a string literal, an optional @a value (e.g. the
+ * number of bytes or packets that were processed) is shown as an argument
+ * of the event.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const qint64 value = -1) :
+        m_name(name),
+        m_value(value),
+        m_begin(TraceWriter::IsEnabled() ? MonotonicTime() : 0) {}
+
+    ~TraceSpan() {
+        if (m_begin > 0)
+            TraceWriter::getInstance()->record(m_name, m_begin,
+                                               MonotonicTime(), m_value);
+    }
+
+    void setValue(const qint64 value) {
+        m_value = value;
+    }
+
+private:
+    Q_DISABLE_COPY(TraceSpan)
+
+    const char* m_name;
+    qint64 m_value;
+    qint64 m_begin;
+};
+
+#endif
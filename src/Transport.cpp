@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QUrl>
+
+#include "Transport.h"
+#include "FileTransport.h"
+#include "SerialTransport.h"
+#include "NetworkTransport.h"
+#include "DescriptorTransport.h"
+
+/**
+ * Constructor function
+ */
+Transport::Transport(QObject* parent) : QObject(parent) {}
+
+/**
+ * @brief Creates the transport described by the given @a source string
+ *
+ * @returns the new (closed) transport, or @c Q_NULLPTR if the source is
+ *          not valid or not supported on this platform
+ */
+Transport* Transport::Create(const QString& source, QObject* parent) {
+    // Plain serial port names
+    const int colon = source.indexOf(':');
+    if (colon <= 0)
+        return new SerialTransport(source, parent);
+
+    const QString scheme = source.left(colon).toLower();
+    const QString path = source.mid(colon + 1);
+
+    if (scheme == "serial")
+        return new SerialTransport(path, parent);
+
+    if (scheme == "file")
+        return new FileTransport(QUrl(source).toLocalFile(), parent);
+
+    if (scheme == "tcp" || scheme == "udp") {
+        const QUrl url(source);
+        if (!url.isValid() || url.port() <= 0)
+            return Q_NULLPTR;
+
+        const NetworkTransport::Protocol protocol = (scheme == "tcp") ?
+                    NetworkTransport::kTcp : NetworkTransport::kUdp;
+        return new NetworkTransport(protocol, url.host(),
+                                    static_cast<quint16>(url.port()),
+                                    parent);
+    }
+
+#ifdef Q_OS_UNIX
+    if (scheme == "pty")
+        return new DescriptorTransport(path, parent);
+
+    if (scheme == "stdin")
+        return new DescriptorTransport(QString(), parent);
+#endif
+
+    return Q_NULLPTR;
+}
+
+/**
+ * Changes the baud @a rate of the transport, only used by serial ports
+ */
+void Transport::setBaudRate(const int rate) {
+    Q_UNUSED(rate);
+}
+
+/**
+ * @brief Stops or resumes the delivery of data
+ *
+ * Only transports that produce data on demand (e.g. files) can be paused,
+ * the data of devices and sockets keeps arriving anyway.
+ *
+ * @returns @c false if the transport cannot be paused
+ */
+bool Transport::setPaused(const bool paused) {
+    Q_UNUSED(paused);
+    return false;
+}
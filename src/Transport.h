@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <QObject>
+#include <QString>
+
+/**
+ * @brief Source of raw telemetry data
+ *
+ * The frame reader does not care where the data comes from, it only needs
+ * to be notified when there is data available and to copy it into the
+ * packet framer. Transports are created from a source string with
+ * @c Transport::Create():
+ *
+ *     - @c serial:COM3, @c serial:ttyUSB0    Serial port
+ *     - @c tcp://host:port                   TCP client (e.g. a relay)
+ *     - @c udp://:port, @c udp://host:port   UDP datagrams sent to a port
+ *     - @c pty:/dev/pts/4                    Pseudo-terminal (Unix only)
+ *     - @c stdin:                            Standard input (Unix only)
+ *     - @c file:/path/log.kcap               Raw log or binary capture,
+ *                                            read as fast as possible
+ *
+ * Strings without a scheme are considered serial port names.
+ *
+ * Transports that produce data on demand can be paused with @c setPaused(),
+ * so that the frame reader can wait for the consumer instead of dropping
+ * packets.
+ *
+ * The @c errorOccurred() signal is emitted when the transport can no longer
+ * provide data (e.g. the device was disconnected), the owner shall close
+ * the transport.
+ */
+class Transport : public QObject {
+    Q_OBJECT
+
+signals:
+    void readyRead();
+    void errorOccurred(const QString& message);
+
+public:
+    explicit Transport(QObject* parent = Q_NULLPTR);
+
+    static Transport* Create(const QString& source,
+                             QObject* parent = Q_NULLPTR);
+
+    virtual QString name() const = 0;
+    virtual bool isOpen() const = 0;
+    virtual QString errorString() const = 0;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual qint64 read(char* data, const qint64 maxSize) = 0;
+
+    virtual void setBaudRate(const int rate);
+    virtual bool setPaused(const bool paused);
+};
+
+#endif
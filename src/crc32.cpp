@@ -0,0 +1,359 @@
+/*
+ *  COPYRIGHT (C) 1986 Gary S. Brown. You may use this program, or
+ *  code or tables extracted from it, as desired without restriction.
+ *
+ *  First, the polynomial itself and its table of feedback terms.  The
+ *  polynomial is
+ *  X^32+X^26+X^23+X^22+X^16+X^12+X^11+X^10+X^8+X^7+X^5+X^4+X^2+X^1+X^0
+ *
+ *  Note that we take it "backwards" and put the highest-order term in
+ *  the lowest-order bit.  The X^32 term is "implied"; the LSB is the
+ *  X^31 term, etc.  The X^0 term (usually shown as "+1") results in
+ *  the MSB being 1
+ *
+ *  Note that the usual hardware shift register implementation, which
+ *  is what we're using (we're merely optimizing it by doing eight-bit
+ *  chunks at a time) shifts bits into the lowest-order term.  In our
+ *  implementation, that means shifting towards the right.  Why do we
+ *  do it this way?  Because the calculated CRC must be transmitted in
+ *  order from highest-order term to lowest-order term.  UARTs transmit
+ *  characters in order from LSB to MSB.  By storing the CRC this way
+ *  we hand it to the UART in the order low-byte to high-byte; the UART
+ *  sends each low-bit to hight-bit; and the result is transmission bit
+ *  by bit from highest- to lowest-order term without requiring any bit
+ *  shuffling on our part.  Reception works similarly
+ *
+ *  The feedback terms table consists of 256, 32-bit entries.  Notes
+ *
+ *      The table can be generated at runtime if desired; code to do so
+ *      is shown later.  It might not be obvious, but the feedback
+ *      terms simply represent the results of eight shift/xor opera
+ *      tions for all combinations of data and CRC register values
+ *
+ *      The values must be right-shifted by eight bits by the "updcrc
+ *      logic; the shift must be unsigned (bring in zeroes).  On some
+ *      hardware you could probably optimize the shift in assembler by
+ *      using byte-swap instructions
+ *      polynomial $edb88320
+ *
+ *
+ * CRC32 code derived from work by Gary S. Brown.
+ */ 
+
+/*
+ * The byte-wise algorithm above is extended in two ways:
+ *
+ *  - Slicing-by-8/16: sixteen tables are derived from the original table,
+ *    so that 8 or 16 bytes can be processed per iteration using independent
+ *    table lookups (Intel's "slicing-by-N" technique)
+ *
+ *  - Carry-less multiplication: on x86 CPUs with PCLMULQDQ and SSE4.1, data
+ *    is folded 64 bytes at a time and reduced with a Barrett reduction,
+ *    as described in "Fast CRC Computation for Generic Polynomials Using
+ *    PCLMULQDQ Instruction" (Intel, 2009). The kernel and its constants
+ *    follow the implementation used by Chromium's zlib
+ *
+ * The best implementation is selected at runtime (using CPUID), all of them
+ * produce exactly the same results as the original byte-wise code.
+ */
+
+#include "crc32.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define CRC32_X86_SIMD
+    #include <emmintrin.h>
+    #include <smmintrin.h>
+    #include <wmmintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define CRC32_TARGET_CLMUL
+    #else
+        #include <cpuid.h>
+        #define CRC32_TARGET_CLMUL __attribute__((target("sse4.1,pclmul")))
+    #endif
+#endif
+
+/*
+ * Reversed representation of the CRC32 polynomial
+ */
+static const uint32_t CRC32_POLY = 0xEDB88320UL;
+
+/*
+ * Minimum number of bytes required to use the PCLMULQDQ kernel
+ */
+static const size_t CLMUL_MIN_SIZE = 64;
+
+/*
+ * Lookup tables used by the slicing-by-N implementation, the first table
+ * is the same table that was used by the original byte-wise code
+ */
+struct SliceTables {
+    uint32_t t[16][256];
+
+    SliceTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ CRC32_POLY : (crc >> 1);
+
+            t[0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int n = 1; n < 16; ++n)
+                t[n][i] = (t[n - 1][i] >> 8) ^ t[0][t[n - 1][i] & 0xFF];
+        }
+    }
+};
+
+/*
+ * Returns the lookup tables, they are generated the first time that this
+ * function is called (the initialization of local statics is thread-safe)
+ */
+static const SliceTables& Tables()
+{
+    static const SliceTables tables;
+    return tables;
+}
+
+/*
+ * Reads a 32-bit little-endian word (compiles to a single load on x86)
+ */
+static inline uint32_t Load32 (const uint8_t* p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) |
+           ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/*
+ * Byte-wise update of the CRC register
+ */
+static inline uint32_t UpdateBytes (const SliceTables& tab, uint32_t crc,
+                                    const uint8_t* p, size_t size)
+{
+    while (size--)
+        crc = tab.t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+/*
+ * Slicing-by-16 (and by-8 for the remaining bytes) update of the CRC
+ * register
+ */
+static uint32_t UpdateSlicing (uint32_t crc, const uint8_t* p, size_t size)
+{
+    const SliceTables& tab = Tables();
+
+    while (size >= 16) {
+        const uint32_t a = Load32 (p) ^ crc;
+        const uint32_t b = Load32 (p + 4);
+        const uint32_t c = Load32 (p + 8);
+        const uint32_t d = Load32 (p + 12);
+
+        crc = tab.t[15][a & 0xFF] ^ tab.t[14][(a >> 8) & 0xFF] ^
+              tab.t[13][(a >> 16) & 0xFF] ^ tab.t[12][a >> 24] ^
+              tab.t[11][b & 0xFF] ^ tab.t[10][(b >> 8) & 0xFF] ^
+              tab.t[9][(b >> 16) & 0xFF] ^ tab.t[8][b >> 24] ^
+              tab.t[7][c & 0xFF] ^ tab.t[6][(c >> 8) & 0xFF] ^
+              tab.t[5][(c >> 16) & 0xFF] ^ tab.t[4][c >> 24] ^
+              tab.t[3][d & 0xFF] ^ tab.t[2][(d >> 8) & 0xFF] ^
+              tab.t[1][(d >> 16) & 0xFF] ^ tab.t[0][d >> 24];
+
+        p += 16;
+        size -= 16;
+    }
+
+    if (size >= 8) {
+        const uint32_t a = Load32 (p) ^ crc;
+        const uint32_t b = Load32 (p + 4);
+
+        crc = tab.t[7][a & 0xFF] ^ tab.t[6][(a >> 8) & 0xFF] ^
+              tab.t[5][(a >> 16) & 0xFF] ^ tab.t[4][a >> 24] ^
+              tab.t[3][b & 0xFF] ^ tab.t[2][(b >> 8) & 0xFF] ^
+              tab.t[1][(b >> 16) & 0xFF] ^ tab.t[0][b >> 24];
+
+        p += 8;
+        size -= 8;
+    }
+
+    return UpdateBytes (tab, crc, p, size);
+}
+
+#ifdef CRC32_X86_SIMD
+
+/*
+ * Returns true if the CPU supports the PCLMULQDQ and SSE4.1 instructions
+ */
+static bool CpuHasClmul()
+{
+    unsigned int ecx = 0;
+
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid (info, 1);
+    ecx = (unsigned int) info[2];
+#else
+    unsigned int eax, ebx, edx;
+    if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx))
+        return false;
+#endif
+
+    const unsigned int PCLMULQDQ = 1u << 1;
+    const unsigned int SSE41 = 1u << 19;
+    return (ecx & PCLMULQDQ) && (ecx & SSE41);
+}
+
+/*
+ * Returns the flag that selects the PCLMULQDQ kernel, it is initialized with
+ * the CPU capabilities the first time that the function is called
+ */
+static bool& ClmulEnabled()
+{
+    static bool enabled = CpuHasClmul();
+    return enabled;
+}
+
+/*
+ * Folds @a size bytes (at least 64, multiple of 16) into the CRC register
+ * using carry-less multiplications
+ */
+CRC32_TARGET_CLMUL
+static uint32_t UpdateClmul (uint32_t crc, const uint8_t* buf, size_t size)
+{
+    /*
+     * Bit-reflected folding constants (x^N mod P) and Barrett reduction
+     * constants of the CRC32 polynomial
+     */
+    const __m128i k1k2 = _mm_set_epi64x (0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x (0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x (0x0000000000LL, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x (0x01f7011641LL, 0x01db710641LL);
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    /* Load the first 64 bytes and add the initial CRC value */
+    x1 = _mm_loadu_si128 ((const __m128i*) (buf + 0x00));
+    x2 = _mm_loadu_si128 ((const __m128i*) (buf + 0x10));
+    x3 = _mm_loadu_si128 ((const __m128i*) (buf + 0x20));
+    x4 = _mm_loadu_si128 ((const __m128i*) (buf + 0x30));
+    x1 = _mm_xor_si128 (x1, _mm_cvtsi32_si128 ((int) crc));
+
+    x0 = k1k2;
+    buf += 64;
+    size -= 64;
+
+    /* Fold 64 bytes at a time (four parallel streams) */
+    while (size >= 64) {
+        x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128 (x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128 (x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128 (x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128 (x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128 (x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128 (x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128 ((const __m128i*) (buf + 0x00));
+        y6 = _mm_loadu_si128 ((const __m128i*) (buf + 0x10));
+        y7 = _mm_loadu_si128 ((const __m128i*) (buf + 0x20));
+        y8 = _mm_loadu_si128 ((const __m128i*) (buf + 0x30));
+
+        x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x5), y5);
+        x2 = _mm_xor_si128 (_mm_xor_si128 (x2, x6), y6);
+        x3 = _mm_xor_si128 (_mm_xor_si128 (x3, x7), y7);
+        x4 = _mm_xor_si128 (_mm_xor_si128 (x4, x8), y8);
+
+        buf += 64;
+        size -= 64;
+    }
+
+    /* Fold the four streams into 128 bits */
+    x0 = k3k4;
+
+    x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+    x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+    x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+    x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x4), x5);
+
+    /* Fold the remaining blocks of 16 bytes */
+    while (size >= 16) {
+        x2 = _mm_loadu_si128 ((const __m128i*) buf);
+
+        x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+        x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x2), x5);
+
+        buf += 16;
+        size -= 16;
+    }
+
+    /* Fold 128 bits into 64 bits */
+    x2 = _mm_clmulepi64_si128 (x1, x0, 0x10);
+    x3 = _mm_setr_epi32 (~0, 0, ~0, 0);
+    x1 = _mm_srli_si128 (x1, 8);
+    x1 = _mm_xor_si128 (x1, x2);
+
+    x0 = k5k0;
+    x2 = _mm_srli_si128 (x1, 4);
+    x1 = _mm_and_si128 (x1, x3);
+    x1 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+    x1 = _mm_xor_si128 (x1, x2);
+
+    /* Barrett reduction to 32 bits */
+    x0 = poly;
+    x2 = _mm_and_si128 (x1, x3);
+    x2 = _mm_clmulepi64_si128 (x2, x0, 0x10);
+    x2 = _mm_and_si128 (x2, x3);
+    x2 = _mm_clmulepi64_si128 (x2, x0, 0x00);
+    x1 = _mm_xor_si128 (x1, x2);
+
+    return (uint32_t) _mm_extract_epi32 (x1, 1);
+}
+
+#endif
+
+uint32_t CRC32 (const void* buf, size_t size)
+{
+    return CRC32_Update (0, buf, size);
+}
+
+uint32_t CRC32_Update (uint32_t crc, const void* buf, size_t size)
+{
+    assert (buf || !size);
+
+    const uint8_t* p = static_cast<const uint8_t*> (buf);
+    crc ^= 0xFFFFFFFFUL;
+
+#ifdef CRC32_X86_SIMD
+    if (ClmulEnabled() && size >= CLMUL_MIN_SIZE) {
+        const size_t chunk = size & ~static_cast<size_t> (15);
+        crc = UpdateClmul (crc, p, chunk);
+        p += chunk;
+        size -= chunk;
+    }
+#endif
+
+    crc = UpdateSlicing (crc, p, size);
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+int CRC32_SetAccelerated (int enabled)
+{
+#ifdef CRC32_X86_SIMD
+    static const bool supported = CpuHasClmul();
+    ClmulEnabled() = enabled && supported;
+    return supported;
+#else
+    (void) enabled;
+    return 0;
+#endif
+}
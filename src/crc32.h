@@ -53,6 +53,23 @@ extern "C" {
 
 extern uint32_t CRC32 (const void* buf, size_t size);
 
+/*
+ * Continues the calculation of a CRC32 code, @a crc is the value returned
+ * by the previous call (or 0 for the first block of data). Calling this
+ * function for consecutive blocks gives the same result as calling CRC32()
+ * once with all the data.
+ */
+extern uint32_t CRC32_Update (uint32_t crc, const void* buf, size_t size);
+
+/*
+ * Enables or disables the carry-less multiplication (PCLMULQDQ) code path,
+ * which is enabled by default when the CPU supports it. Returns 0 if the CPU
+ * does not support it, in which case the slicing-by-16 code is always used.
+ * This function is meant for tests and must not be called while other
+ * threads are calculating CRC32 codes.
+ */
+extern int CRC32_SetAccelerated (int enabled);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,8 @@
 
 #include <QtQml>
 #include <QQuickStyle>
+#include <QQuickWindow>
+#include <QCommandLineParser>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 
@@ -29,7 +31,18 @@
 #include "AppQuiter.h"
 #include "DataParser.h"
 #include "Translator.h"
+#include "LatencyMonitor.h"
+#include "ReplayEngine.h"
 #include "SerialManager.h"
+#include "TelemetryPlot.h"
+#include "TraceWriter.h"
+
+/**
+ * First receiver used by the sources given in the command line, receivers
+ * 0 to 2 belong to the device and source selectors of the user interface,
+ * which close the device of their receiver when their model changes
+ */
+static const int FIRST_SOURCE_RECEIVER = 3;
 
 /**
  * @brief Entry-point function of the application
@@ -49,34 +62,116 @@ int main(int argc, char** argv) {
     // Create application controller
     QGuiApplication app(argc, argv);
 
+    // Parse command line arguments
+    QCommandLineParser arguments;
+    arguments.addHelpOption();
+    arguments.addVersionOption();
+    arguments.addOption(QCommandLineOption("source",
+                                           "Telemetry source to read (e.g. "
+                                           "tcp://host:port, udp://:port, "
+                                           "pty:/dev/pts/4, stdin: or "
+                                           "file:/path/log.kcap), can be "
+                                           "given up to 5 times",
+                                           "source"));
+    arguments.addOption(QCommandLineOption("replay",
+                                           "Capture (.kcap) or raw log to "
+                                           "play back on startup",
+                                           "file"));
+    arguments.addOption(QCommandLineOption("trace",
+                                           "Write a Chrome trace-event (JSON) "
+                                           "file with the spans of the "
+                                           "ingestion pipeline",
+                                           "file"));
+    arguments.process(app);
+
     // Create application modules
     DataParser parser;
     AppQuiter appQuiter;
     Translator translator;
+    ReplayEngine replay(&parser);
     QQmlApplicationEngine engine;
     QQuickStyle::setStyle("Universal");
 
     // Register QML modules
     Translator::DeclareQML();
+    DataParser::DeclareQML();
+    TelemetryPlot::DeclareQML();
 
-    // Enable file logging for CSV and serial data
+    // Enable file logging for CSV, database and serial data
     parser.enableCsvLogging(true);
+    parser.enableDatabaseLogging(true);
     SerialManager::getInstance()->enableFileLogging(true);
 
+    // Start tracing before any source is opened
+    if (arguments.isSet("trace"))
+        TraceWriter::getInstance()->start(arguments.value("trace"));
+
+    // Open the sources given in the command line, warn about the sources
+    // that do not fit in the available receivers
+    const QStringList sources = arguments.values("source");
+    const int maxSources = SerialManager::getInstance()->maxReceivers() -
+            FIRST_SOURCE_RECEIVER;
+    for (int i = 0; i < sources.count(); ++i) {
+        if (i >= maxSources) {
+            qWarning() << "Ignoring source" << sources.at(i) << "- at most"
+                       << maxSources << "sources can be given";
+            continue;
+        }
+
+        SerialManager::getInstance()->openSource(FIRST_SOURCE_RECEIVER + i,
+                                                 sources.at(i));
+    }
+
+    // Play back the recording given in the command line
+    if (arguments.isSet("replay") && replay.open(arguments.value("replay")))
+        replay.play();
+
     // Configure QML engine context properties
     engine.rootContext()->setContextProperty("AppName", app.applicationName());
     engine.rootContext()->setContextProperty("AppCompany", app.organizationName());
     engine.rootContext()->setContextProperty("AppVersion", app.applicationVersion());
     engine.rootContext()->setContextProperty("CDataParser", &parser);
     engine.rootContext()->setContextProperty("CAppQuiter", &appQuiter);
+    engine.rootContext()->setContextProperty("CReplayEngine", &replay);
     engine.rootContext()->setContextProperty ("Translator", &translator);
     engine.rootContext()->setContextProperty("CSerialManager", SerialManager::getInstance());
+    engine.rootContext()->setContextProperty("CLatencyMonitor", LatencyMonitor::getInstance());
+    engine.rootContext()->setContextProperty("CTraceWriter", TraceWriter::getInstance());
     engine.load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
 
     // Exit if QML interface contains errors
     if (engine.rootObjects().isEmpty())
         return EXIT_FAILURE;
 
+    // Measure when published data is rendered (frameSwapped is emitted by
+    // the render thread)
+    QQuickWindow* window = qobject_cast<QQuickWindow*>(engine.rootObjects().first());
+    if (window) {
+        QObject::connect(window, &QQuickWindow::frameSwapped,
+                         LatencyMonitor::getInstance(),
+                         &LatencyMonitor::onFrameSwapped,
+                         Qt::DirectConnection);
+
+        // Trace scene graph synchronization and rendering
+        TraceWriter* trace = TraceWriter::getInstance();
+        QObject::connect(window, &QQuickWindow::beforeSynchronizing,
+                         trace, &TraceWriter::onBeforeSynchronizing,
+                         Qt::DirectConnection);
+        QObject::connect(window, &QQuickWindow::afterSynchronizing,
+                         trace, &TraceWriter::onAfterSynchronizing,
+                         Qt::DirectConnection);
+        QObject::connect(window, &QQuickWindow::beforeRendering,
+                         trace, &TraceWriter::onBeforeRendering,
+                         Qt::DirectConnection);
+        QObject::connect(window, &QQuickWindow::frameSwapped,
+                         trace, &TraceWriter::onFrameSwapped,
+                         Qt::DirectConnection);
+    }
+
+    // Close the trace file before the application exits
+    QObject::connect(&app, &QGuiApplication::aboutToQuit,
+                     TraceWriter::getInstance(), &TraceWriter::stop);
+
     // Enter application event loop
     return app.exec();
 }
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtTest>
+
+#include "crc32.h"
+#include "Tests.h"
+
+/**
+ * Maximum length of the buffers used by the tests
+ */
+static const int MAX_LENGTH = 4096;
+
+/**
+ * @returns the CRC32 of @a size bytes of @a buf, calculated one byte at a time
+ *          with the classic 256-entry table (used as the reference)
+ */
+static quint32 BytewiseCrc32(const quint8* buf, const int size) {
+    static quint32 table[256];
+    if (table[1] == 0) {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+
+            table[i] = crc;
+        }
+    }
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < size; ++i)
+        crc = table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * Checks that the slicing-by-16 and the PCLMULQDQ implementations of
+ * CRC32() and CRC32_Update() produce the same results as the reference
+ */
+class Crc32Test : public QObject {
+    Q_OBJECT
+
+private:
+    QByteArray m_data;
+    bool m_clmulSupported;
+
+    const quint8* bytes(const int offset) const {
+        return reinterpret_cast<const quint8*>(m_data.constData() + offset);
+    }
+
+private slots:
+    void initTestCase() {
+        qsrand(0x5eed);
+        m_data.resize(MAX_LENGTH + 64);
+        for (int i = 0; i < m_data.size(); ++i)
+            m_data[i] = static_cast<char>(qrand() & 0xFF);
+
+        m_clmulSupported = CRC32_SetAccelerated(1) != 0;
+    }
+
+    void cleanupTestCase() {
+        CRC32_SetAccelerated(1);
+    }
+
+    void init() {
+        QFETCH_GLOBAL(bool, accelerated);
+        if (accelerated && !m_clmulSupported)
+            QSKIP("The CPU does not support PCLMULQDQ");
+
+        CRC32_SetAccelerated(accelerated);
+    }
+
+    void initTestCase_data() {
+        QTest::addColumn<bool>("accelerated");
+        QTest::newRow("slicing") << false;
+        QTest::newRow("pclmul") << true;
+    }
+
+    void checkValue() {
+        QCOMPARE(CRC32("123456789", 9), quint32(0xcbf43926));
+        QCOMPARE(CRC32(Q_NULLPTR, 0), quint32(0));
+    }
+
+    void wholeBuffers() {
+        for (int offset = 0; offset < 16; ++offset) {
+            for (int length = 0; length <= MAX_LENGTH; ++length) {
+                const quint32 expected = BytewiseCrc32(bytes(offset), length);
+                const quint32 actual = CRC32(bytes(offset),
+                                             static_cast<size_t>(length));
+                if (actual != expected)
+                    QFAIL(qPrintable(QString("offset %1, length %2")
+                                     .arg(offset).arg(length)));
+            }
+        }
+    }
+
+    void splitUpdates() {
+        for (int i = 0; i < 5000; ++i) {
+            const int offset = qrand() % 64;
+            const int length = qrand() % (MAX_LENGTH + 1);
+            const int split = length > 0 ? qrand() % (length + 1) : 0;
+
+            const quint32 first = CRC32(bytes(offset),
+                                        static_cast<size_t>(split));
+            const quint32 actual = CRC32_Update(first, bytes(offset + split),
+                                                static_cast<size_t>(length -
+                                                                    split));
+            const quint32 expected = BytewiseCrc32(bytes(offset), length);
+            if (actual != expected)
+                QFAIL(qPrintable(QString("offset %1, length %2, split %3")
+                                 .arg(offset).arg(length).arg(split)));
+        }
+    }
+};
+
+int RunCrc32Test(int argc, char** argv) {
+    Crc32Test test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "Crc32Test.moc"
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtTest>
+
+#include "crc32.h"
+#include "Constants.h"
+#include "DataParser.h"
+#include "FrameBatch.h"
+#include "FrameMerger.h"
+#include "Tests.h"
+
+/**
+ * @returns a valid packet with the given packet @a count and mission @a time
+ *          (without the primary EOT code, as delivered by the framer)
+ */
+static QByteArray Packet(const int count, const int time) {
+    QByteArray packet = HEADER_CODE;
+    for (int i = DataParser::kTeamID; i < DataParser::kChecksumCode; ++i) {
+        packet.append(DATA_SEPARATOR.toLatin1());
+        if (i == DataParser::kPacketCount)
+            packet.append(QByteArray::number(count));
+        else if (i == DataParser::kMisionTime)
+            packet.append(QByteArray::number(time));
+        else
+            packet.append('0');
+    }
+
+    if (ENABLE_CRC32) {
+        packet.append(DATA_SEPARATOR.toLatin1());
+        const quint32 crc = CRC32(packet.constData(),
+                                  static_cast<size_t>(packet.size()));
+        packet.append(QByteArray::number(crc));
+    }
+
+    packet.append(EOT_SECONDARY.toLatin1());
+    return packet;
+}
+
+/**
+ * Tests the de-duplication of the packets received by several radios
+ */
+class FrameMergerTest : public QObject {
+    Q_OBJECT
+
+private:
+    void push(FrameMerger& merger, const int source, const QByteArray& packet,
+              const qint64 timestamp) {
+        merger.push(source, packet.constData(), packet.size(), timestamp);
+    }
+
+    QByteArray frame(const FrameBatch& batch, const int index) {
+        return QByteArray(batch.frameData(index), batch.frameSize(index));
+    }
+
+private slots:
+    void checkPacket() {
+        quint64 count;
+        quint64 time;
+        const QByteArray valid = Packet(70, 7000);
+        QVERIFY(DataParser::CheckPacket(valid.constData(), valid.size(),
+                                        count, time));
+        QCOMPARE(count, quint64(70));
+        QCOMPARE(time, quint64(7000));
+
+        // Extra field
+        QByteArray damaged = valid;
+        damaged.insert(damaged.size() - 1, ",9");
+        QVERIFY(!DataParser::CheckPacket(damaged.constData(), damaged.size(),
+                                         count, time));
+
+        // Missing secondary EOT code
+        damaged = valid;
+        damaged.chop(1);
+        QVERIFY(!DataParser::CheckPacket(damaged.constData(), damaged.size(),
+                                         count, time));
+
+        // Wrong header
+        damaged = valid;
+        damaged[0] = 'X';
+        QVERIFY(!DataParser::CheckPacket(damaged.constData(), damaged.size(),
+                                         count, time));
+    }
+
+    void duplicatesAreDiscarded() {
+        FrameMerger merger;
+        merger.setSourceCount(2);
+
+        const QByteArray packet = Packet(70, 7000);
+        push(merger, 0, packet, 1);
+        push(merger, 1, packet, 2);
+
+        FrameBatch batch;
+        merger.release(batch, 3, true);
+        QCOMPARE(batch.count(), 1);
+        QCOMPARE(frame(batch, 0), packet);
+        QCOMPARE(merger.stats(0).firstDeliveries, qint64(1));
+        QCOMPARE(merger.stats(1).duplicates, qint64(1));
+    }
+
+    void singleSourceIsPassThrough() {
+        FrameMerger merger;
+        QVERIFY(merger.bypass(0));
+        QCOMPARE(merger.stats(0).frames, qint64(1));
+        QCOMPARE(merger.stats(0).firstDeliveries, qint64(1));
+
+        // Duplicates are delivered as-is (the sequence tracker reports them)
+        const QByteArray packet = Packet(70, 7000);
+        push(merger, 0, packet, 1);
+        push(merger, 0, packet, 2);
+        QVERIFY(!merger.bypass(0));
+
+        FrameBatch batch;
+        merger.release(batch, 3, false);
+        QCOMPARE(batch.count(), 2);
+        QCOMPARE(merger.stats(0).duplicates, qint64(0));
+        QVERIFY(merger.bypass(0));
+
+        // Packets are merged as soon as there is a second source
+        merger.setSourceCount(2);
+        QVERIFY(!merger.bypass(0));
+    }
+
+    void damagedCopyDoesNotReplaceValidCopy() {
+        FrameMerger merger;
+        merger.setSourceCount(2);
+
+        // The first radio delivers a damaged copy (extra field), the backup
+        // radio delivers the valid copy later
+        const QByteArray valid = Packet(70, 7000);
+        QByteArray damaged = valid;
+        damaged.insert(damaged.size() - 1, ",9");
+
+        push(merger, 0, damaged, 1);
+        push(merger, 1, valid, 2);
+
+        FrameBatch batch;
+        merger.release(batch, 3, true);
+        QCOMPARE(batch.count(), 2);
+        QCOMPARE(frame(batch, 0), damaged);
+        QCOMPARE(frame(batch, 1), valid);
+        QCOMPARE(merger.stats(1).duplicates, qint64(0));
+        QCOMPARE(merger.stats(1).firstDeliveries, qint64(1));
+    }
+};
+
+int RunFrameMergerTest(int argc, char** argv) {
+    FrameMergerTest test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "FrameMergerTest.moc"
@@ -0,0 +1,107 @@
+#
+# Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+#-------------------------------------------------------------------------------
+# Unit tests (build with qmake tests)
+#-------------------------------------------------------------------------------
+
+UI_DIR = uic
+MOC_DIR = moc
+RCC_DIR = qrc
+OBJECTS_DIR = obj
+
+CONFIG += c++11
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = cansat-tests
+
+QT += gui
+QT += qml
+QT += sql
+QT += core
+QT += network
+QT += widgets
+QT += serialport
+QT += testlib
+
+INCLUDEPATH += ../src
+
+#-------------------------------------------------------------------------------
+# Import source code
+#-------------------------------------------------------------------------------
+
+HEADERS += \
+    Tests.h \
+    ../src/AsyncFileWriter.h \
+    ../src/CaptureFile.h \
+    ../src/Constants.h \
+    ../src/crc32.h \
+    ../src/CsvWriter.h \
+    ../src/DataParser.h \
+    ../src/DescriptorTransport.h \
+    ../src/FileTransport.h \
+    ../src/FrameBatch.h \
+    ../src/FrameMerger.h \
+    ../src/FrameReader.h \
+    ../src/LatencyMonitor.h \
+    ../src/NetworkTransport.h \
+    ../src/NumberParser.h \
+    ../src/PacketFramer.h \
+    ../src/SequenceTracker.h \
+    ../src/SerialManager.h \
+    ../src/SerialTransport.h \
+    ../src/SpscQueue.h \
+    ../src/TelemetryDatabase.h \
+    ../src/TelemetryFrame.h \
+    ../src/TelemetryHistory.h \
+    ../src/TelemetryStatistics.h \
+    ../src/TraceWriter.h \
+    ../src/Transport.h
+
+SOURCES += \
+    Crc32Test.cpp \
+    FrameMergerTest.cpp \
+    main.cpp \
+    ../src/AsyncFileWriter.cpp \
+    ../src/CaptureFile.cpp \
+    ../src/crc32.cpp \
+    ../src/CsvWriter.cpp \
+    ../src/DataParser.cpp \
+    ../src/DescriptorTransport.cpp \
+    ../src/FileTransport.cpp \
+    ../src/FrameBatch.cpp \
+    ../src/FrameMerger.cpp \
+    ../src/FrameReader.cpp \
+    ../src/LatencyMonitor.cpp \
+    ../src/NetworkTransport.cpp \
+    ../src/NumberParser.cpp \
+    ../src/PacketFramer.cpp \
+    ../src/SequenceTracker.cpp \
+    ../src/SerialManager.cpp \
+    ../src/SerialTransport.cpp \
+    ../src/TelemetryDatabase.cpp \
+    ../src/TelemetryHistory.cpp \
+    ../src/TelemetryStatistics.cpp \
+    ../src/TraceWriter.cpp \
+    ../src/Transport.cpp
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include "FlightSimulator.h"
+
+/**
+ * Standard gravity (m/s^2)
+ */
+static const double GRAVITY = 9.80665;
+
+/**
+ * Altitude (above sea level) and position of the launch site
+ */
+static const double SITE_ALTITUDE = 1566;
+static const double SITE_LATITUDE = 20.6565;
+static const double SITE_LONGITUDE = -103.3254;
+
+/**
+ * Wind speed (m/s) and meters per degree of latitude
+ */
+static const double WIND_SPEED = 3.5;
+static const double METERS_PER_DEGREE = 111320;
+
+/**
+ * GPS time of the start of the simulation (seconds since Jan 6, 1980)
+ */
+static const quint64 START_GPS_TIME = 1241000000;
+
+/**
+ * Creates a simulator with the default profile (700 m apogee, 10 s on the
+ * launch pad), the @a seed is used for the sensor noise
+ */
+FlightSimulator::FlightSimulator(const quint32 seed) :
+    m_seed(seed),
+    m_random(seed),
+    m_apogee(700),
+    m_padTime(10),
+    m_ascentTime(12),
+    m_freeFallTime(2),
+    m_descentRate(5),
+    m_launchGpsTime(START_GPS_TIME)
+{
+    reset();
+}
+
+/**
+ * Changes the maximum altitude (in meters above the ground)
+ */
+void FlightSimulator::setApogee(const double meters) {
+    m_apogee = qMax(10.0, meters);
+    m_ascentTime = 2 * std::sqrt(m_apogee / 10);
+}
+
+/**
+ * Changes the time that the CanSat waits on the ground before the launch
+ */
+void FlightSimulator::setPadTime(const double seconds) {
+    m_padTime = qMax(0.0, seconds);
+}
+
+/**
+ * @returns the maximum altitude (in meters above the ground)
+ */
+double FlightSimulator::apogee() const {
+    return m_apogee;
+}
+
+/**
+ * @returns the time (in seconds) between the start of the mission and the
+ *          landing
+ */
+double FlightSimulator::flightTime() const {
+    const double fall = 0.5 * GRAVITY * m_freeFallTime * m_freeFallTime;
+    const double descent = qMax(0.0, m_apogee - fall) / m_descentRate;
+    return m_padTime + m_ascentTime + m_freeFallTime + descent;
+}
+
+/**
+ * Restarts the noise generator, so that the same readings are generated
+ * again
+ */
+void FlightSimulator::reset() {
+    m_random = m_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+}
+
+/**
+ * @returns the readings of the CanSat at the given @a missionTime (in
+ *          milliseconds)
+ */
+FlightState FlightSimulator::stateAt(const quint32 missionTime) {
+    FlightState state;
+    const double t = missionTime / 1000.0;
+
+    // Altitude & vertical acceleration
+    double accel = 0;
+    const double altitude = altitudeAt(t, accel);
+    state.altitude = qMax(0.0, altitude + noise(0.3));
+    state.parachute = t >= m_padTime + m_ascentTime + m_freeFallTime;
+
+    // Standard atmosphere (kPa)
+    const double h = altitude + SITE_ALTITUDE;
+    state.pressure = 101.325 * std::pow(1 - 2.25577e-5 * h, 5.25588)
+            + noise(0.01);
+
+    // Temperatures drop 6.5 °C per kilometer, the inside of the CanSat
+    // warms up slowly
+    state.extTemperature = 24 - 6.5 * altitude / 1000 + noise(0.1);
+    state.intTemperature = 27 + 3 * (1 - std::exp(-t / 600)) + noise(0.05);
+
+    // Battery drains linearly
+    state.voltage = qMax(3.3, 4.15 - t * 0.00025) + noise(0.005);
+
+    // Gas sensors
+    state.airQuality = qBound(0.0, 12 + altitude / 100 + noise(0.5), 100.0);
+    state.carbonMonoxide = qBound(0.0, 3 + noise(0.2), 100.0);
+
+    // GPS drifts with the wind once the CanSat is released
+    const double drift = WIND_SPEED * qMax(0.0, t - m_padTime);
+    state.gpsTime = m_launchGpsTime + static_cast<quint64>(t);
+    state.latitude = SITE_LATITUDE + drift * 0.6 / METERS_PER_DEGREE
+            + noise(0.000005);
+    state.longitude = SITE_LONGITUDE + drift * 0.8 / METERS_PER_DEGREE
+            + noise(0.000005);
+    state.gpsAltitude = h + noise(2);
+    state.satellites = 7 + static_cast<int>(t / 60) % 3;
+
+    // Accelerometer (the CanSat spins slowly under the parachute)
+    const double spin = state.parachute ? t * 0.8 : 0;
+    state.accelerometer[0] = 0.3 * std::sin(spin) + noise(0.05);
+    state.accelerometer[1] = 0.3 * std::cos(spin) + noise(0.05);
+    state.accelerometer[2] = accel + noise(0.05);
+
+    // Magnetometer (uT), rotates with the CanSat
+    state.magnetometer[0] = 28 * std::cos(spin) + noise(0.3);
+    state.magnetometer[1] = 28 * std::sin(spin) + noise(0.3);
+    state.magnetometer[2] = -32 + noise(0.3);
+
+    return state;
+}
+
+/**
+ * @returns a random number with a normal distribution, zero mean and the
+ *          given standard deviation @a sigma
+ */
+double FlightSimulator::noise(const double sigma) {
+    // Sum of uniform numbers (Irwin-Hall), good enough for sensor noise
+    double sum = 0;
+    for (int i = 0; i < 4; ++i) {
+        m_random = m_random * 6364136223846793005ULL + 1442695040888963407ULL;
+        sum += static_cast<double>(m_random >> 11) / 9007199254740992.0;
+    }
+
+    return (sum - 2) * std::sqrt(3.0) * sigma;
+}
+
+/**
+ * @returns the altitude (above the ground) at the given time @a t (in
+ *          seconds) and the vertical acceleration that would be measured
+ *          by the accelerometer
+ */
+double FlightSimulator::altitudeAt(const double t, double& verticalAccel) const {
+    // On the launch pad
+    if (t < m_padTime) {
+        verticalAccel = GRAVITY;
+        return 0;
+    }
+
+    // Climbing (decelerating until the apogee)
+    double s = t - m_padTime;
+    if (s < m_ascentTime) {
+        const double x = 1 - s / m_ascentTime;
+        verticalAccel = GRAVITY - 2 * m_apogee / (m_ascentTime * m_ascentTime);
+        if (s < 1)
+            verticalAccel += 3 * GRAVITY;
+
+        return m_apogee * (1 - x * x);
+    }
+
+    // Free fall after the release
+    s -= m_ascentTime;
+    const double fall = 0.5 * GRAVITY * m_freeFallTime * m_freeFallTime;
+    if (s < m_freeFallTime) {
+        verticalAccel = 0;
+        return qMax(0.0, m_apogee - 0.5 * GRAVITY * s * s);
+    }
+
+    // Descent under the parachute
+    s -= m_freeFallTime;
+    verticalAccel = GRAVITY;
+    return qMax(0.0, m_apogee - fall - m_descentRate * s);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FLIGHT_SIMULATOR_H
+#define FLIGHT_SIMULATOR_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Sensor readings of the simulated CanSat at a given mission time
+ */
+struct FlightState {
+    double altitude;
+    double pressure;
+    double voltage;
+    double intTemperature;
+    double extTemperature;
+    double airQuality;
+    double carbonMonoxide;
+    quint64 gpsTime;
+    double latitude;
+    double longitude;
+    double gpsAltitude;
+    int satellites;
+    double accelerometer[3];
+    double magnetometer[3];
+    bool parachute;
+};
+
+/**
+ * @brief Generates a realistic flight profile of the CanSat
+ *
+ * The flight starts on the ground, then the rocket climbs to the apogee,
+ * the CanSat is released and falls freely until the parachute opens, and
+ * it descends at a constant rate until it lands. Every reading is derived
+ * from the altitude (e.g. the pressure follows the standard atmosphere)
+ * and gets some gaussian noise, the GPS position drifts with the wind.
+ *
+ * The simulation is deterministic for a given seed.
+ */
+class FlightSimulator {
+public:
+    explicit FlightSimulator(const quint32 seed = 1);
+
+    void setApogee(const double meters);
+    void setPadTime(const double seconds);
+
+    double apogee() const;
+    double flightTime() const;
+
+    void reset();
+    FlightState stateAt(const quint32 missionTime);
+
+private:
+    double noise(const double sigma);
+    double altitudeAt(const double t, double& verticalAccel) const;
+
+private:
+    quint32 m_seed;
+    quint64 m_random;
+
+    double m_apogee;
+    double m_padTime;
+    double m_ascentTime;
+    double m_freeFallTime;
+    double m_descentRate;
+    quint64 m_launchGpsTime;
+};
+
+#endif
@@ -0,0 +1,705 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <QUrl>
+#include <QDebug>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+
+#ifdef Q_OS_UNIX
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <termios.h>
+#endif
+
+#include "crc32.h"
+#include "PacketGenerator.h"
+
+/**
+ * Maximum length of a generated packet
+ */
+static const int MAX_PACKET_SIZE = 512;
+
+/**
+ * Maximum amount of data generated in a single step
+ */
+static const int MAX_BURST_SIZE = 256 * 1024;
+
+/**
+ * Maximum size of a UDP datagram (so that datagrams are not fragmented)
+ */
+static const int MAX_DATAGRAM_SIZE = 1400;
+
+/**
+ * Maximum amount of data waiting to be sent to a TCP client before the
+ * generator waits for it
+ */
+static const qint64 MAX_PENDING_BYTES = 4 * 1024 * 1024;
+
+/**
+ * Names of the faults, used in the statistics
+ */
+static const char* FAULT_NAMES[PacketGenerator::kFaultCount] = {
+    "corrupt",
+    "truncate",
+    "duplicate",
+    "reset",
+    "drop"
+};
+
+/**
+ * Creates a generator that writes one packet per second (mission time
+ * advances one second per packet) without faults
+ */
+PacketGenerator::PacketGenerator(QObject* parent) : QObject(parent),
+    m_output(kNone),
+    m_ptyMaster(-1),
+    m_ptySlave(-1),
+    m_server(Q_NULLPTR),
+    m_udp(Q_NULLPTR),
+    m_udpPort(0),
+    m_random(1),
+    m_teamId(1),
+    m_crcEnabled(false),
+    m_rate(1),
+    m_baudRate(0),
+    m_missionStep(0),
+    m_packetLimit(0),
+    m_durationLimit(0),
+    m_packetCount(0),
+    m_missionTime(0),
+    m_nextPacketTime(0),
+    m_linkFreeTime(0),
+    m_generated(0),
+    m_packets(0),
+    m_skipped(0),
+    m_bytes(0),
+    m_lastPackets(0),
+    m_lastBytes(0)
+{
+    for (int i = 0; i < kFaultCount; ++i) {
+        m_faults[i] = 0;
+        m_probabilities[i] = 0;
+    }
+
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_statsTimer.setInterval(1000);
+    connect(&m_timer, &QTimer::timeout,
+            this, &PacketGenerator::onTimeout);
+    connect(&m_statsTimer, &QTimer::timeout,
+            this, &PacketGenerator::printStatistics);
+}
+
+/**
+ * Closes the output
+ */
+PacketGenerator::~PacketGenerator() {
+    m_file.close();
+
+#ifdef Q_OS_UNIX
+    if (m_ptyMaster >= 0)
+        ::close(m_ptyMaster);
+    if (m_ptySlave >= 0)
+        ::close(m_ptySlave);
+#endif
+}
+
+/**
+ * @returns the simulator that generates the readings of the packets
+ */
+FlightSimulator& PacketGenerator::simulator() {
+    return m_simulator;
+}
+
+/**
+ * @returns a description of the output (e.g. the path of the pty that
+ *          shall be read by the ground station)
+ */
+QString PacketGenerator::outputName() const {
+    return m_outputName;
+}
+
+/**
+ * @brief Opens the given @a output, see the class documentation for the
+ *        supported output strings
+ *
+ * @returns @c true on success
+ */
+bool PacketGenerator::open(const QString& output) {
+    const int colon = output.indexOf(':');
+    const QString scheme = output.left(qMax(0, colon)).toLower();
+    const QUrl url(output);
+
+    // Regular file
+    if (scheme == "file") {
+        QString path = url.toLocalFile();
+        if (path.isEmpty())
+            path = output.mid(colon + 1);
+
+        m_file.setFileName(path);
+        if (!m_file.open(QFile::WriteOnly | QFile::Append)) {
+            qWarning() << "Cannot open" << path << m_file.errorString();
+            return false;
+        }
+
+        m_output = kFile;
+        m_outputName = path;
+        return true;
+    }
+
+    // Standard output
+    if (scheme == "stdout") {
+        if (!m_file.open(stdout, QFile::WriteOnly))
+            return false;
+
+        m_output = kFile;
+        m_outputName = "stdout";
+        return true;
+    }
+
+#ifdef Q_OS_UNIX
+    // Pseudo-terminal, the slave side is kept open (in raw mode) so that
+    // the ground station can open and close it at any time. The master is
+    // non-blocking, so that the generator keeps running (and skips packets)
+    // while nobody reads the pty
+    if (scheme == "pty") {
+        const int master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 ||
+                fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK)) {
+            qWarning() << "Cannot create pseudo-terminal";
+            if (master >= 0)
+                ::close(master);
+
+            return false;
+        }
+
+        m_outputName = QString::fromLocal8Bit(ptsname(master));
+        m_ptySlave = ::open(ptsname(master), O_RDWR | O_NOCTTY);
+
+        struct termios options;
+        if (m_ptySlave >= 0 && tcgetattr(m_ptySlave, &options) == 0) {
+            cfmakeraw(&options);
+            tcsetattr(m_ptySlave, TCSANOW, &options);
+        }
+
+        m_ptyMaster = master;
+        m_output = kPty;
+        return true;
+    }
+#endif
+
+    // TCP server
+    if (scheme == "tcp" && url.port() > 0) {
+        const QHostAddress address = url.host().isEmpty() ?
+                    QHostAddress(QHostAddress::Any) : QHostAddress(url.host());
+
+        m_server = new QTcpServer(this);
+        if (!m_server->listen(address, static_cast<quint16>(url.port()))) {
+            qWarning() << "Cannot listen on" << output
+                       << m_server->errorString();
+            return false;
+        }
+
+        connect(m_server, &QTcpServer::newConnection,
+                this, &PacketGenerator::onNewConnection);
+
+        m_output = kTcp;
+        m_outputName = QString("tcp://%1:%2").arg(
+                    url.host().isEmpty() ? "localhost" : url.host(),
+                    QString::number(url.port()));
+        return true;
+    }
+
+    // UDP datagrams
+    if (scheme == "udp" && url.port() > 0) {
+        m_udpHost = url.host().isEmpty() ? QHostAddress(QHostAddress::LocalHost)
+                                         : QHostAddress(url.host());
+        m_udpPort = static_cast<quint16>(url.port());
+        if (m_udpHost.isNull()) {
+            qWarning() << "Invalid UDP host" << url.host();
+            return false;
+        }
+
+        m_udp = new QUdpSocket(this);
+        m_output = kUdp;
+        m_outputName = QString("udp://%1:%2").arg(m_udpHost.toString(),
+                                                  QString::number(m_udpPort));
+        return true;
+    }
+
+    qWarning() << "Unsupported output" << output;
+    return false;
+}
+
+/**
+ * Changes the @a seed of the random number generators (faults & noise)
+ */
+void PacketGenerator::setSeed(const quint32 seed) {
+    m_random = seed * 2654435761ULL + 1;
+    m_simulator = FlightSimulator(seed);
+}
+
+/**
+ * Changes the team ID written in every packet
+ */
+void PacketGenerator::setTeamId(const int teamId) {
+    m_teamId = teamId;
+}
+
+/**
+ * Changes the number of packets written per second, use 0 to write them
+ * as fast as the output (or the simulated link) accepts them
+ */
+void PacketGenerator::setRate(const double packetsPerSecond) {
+    m_rate = qMax(0.0, packetsPerSecond);
+}
+
+/**
+ * Limits the throughput to the one of a serial link with the given
+ * @a baudRate (10 bits per byte), use 0 to disable the limit
+ */
+void PacketGenerator::setBaudRate(const int baudRate) {
+    m_baudRate = qMax(0, baudRate);
+}
+
+/**
+ * Changes the mission time between consecutive packets, use 0 to derive
+ * it from the packet rate
+ */
+void PacketGenerator::setMissionStep(const int milliseconds) {
+    m_missionStep = qMax(0, milliseconds);
+}
+
+/**
+ * Enables or disables the CRC-32 field at the end of each packet
+ */
+void PacketGenerator::setCrcEnabled(const bool enabled) {
+    m_crcEnabled = enabled;
+}
+
+/**
+ * Stops the generator after the given number of @a packets, use 0 to
+ * generate packets forever
+ */
+void PacketGenerator::setPacketLimit(const qint64 packets) {
+    m_packetLimit = qMax<qint64>(0, packets);
+}
+
+/**
+ * Stops the generator after the given number of @a seconds, use 0 to
+ * generate packets forever
+ */
+void PacketGenerator::setDuration(const double seconds) {
+    m_durationLimit = static_cast<qint64>(qMax(0.0, seconds) * 1e9);
+}
+
+/**
+ * Changes the @a probability (between 0 and 1) with which the given
+ * @a fault is injected in each packet
+ */
+void PacketGenerator::setFaultProbability(const Fault fault,
+                                          const double probability) {
+    if (fault >= 0 && fault < kFaultCount)
+        m_probabilities[fault] = qBound(0.0, probability, 1.0);
+}
+
+/**
+ * Starts writing packets
+ */
+void PacketGenerator::start() {
+    if (m_missionStep <= 0)
+        m_missionStep = m_rate > 0 ? qMax(1, qRound(1000 / m_rate)) : 1000;
+
+    m_clock.start();
+    m_nextPacketTime = 0;
+    m_linkFreeTime = 0;
+
+    const bool unlimited = m_rate <= 0 && m_baudRate <= 0;
+    m_timer.start(unlimited ? 0 : 1);
+    m_statsTimer.start();
+
+    qInfo().noquote() << "Writing packets to" << m_outputName;
+}
+
+/**
+ * Stops writing packets, prints the final statistics and emits the
+ * @c finished() signal
+ */
+void PacketGenerator::stop() {
+    if (!m_timer.isActive())
+        return;
+
+    m_timer.stop();
+    m_statsTimer.stop();
+    m_file.flush();
+
+    foreach (QTcpSocket* client, m_clients)
+        client->flush();
+
+    printStatistics();
+    emit finished();
+}
+
+/**
+ * @brief Writes the packets that are due
+ *
+ * The number of packets is limited by the packet rate, by the throughput
+ * of the simulated serial link and by @c MAX_BURST_SIZE. The backlog is
+ * discarded if the output could not keep up for more than one second.
+ */
+void PacketGenerator::onTimeout() {
+    const qint64 now = m_clock.nsecsElapsed();
+
+    // Wait for the output (e.g. a slow or missing TCP client, or a pty
+    // that nobody reads), the duration limit still applies
+    if (outputBusy()) {
+        m_nextPacketTime = now;
+        m_linkFreeTime = now;
+        if (m_durationLimit > 0 && now >= m_durationLimit)
+            stop();
+
+        return;
+    }
+
+    // Do not accumulate more than one second of backlog
+    if (m_nextPacketTime < now - 1000000000)
+        m_nextPacketTime = now;
+
+    // The link can not "save" idle time
+    if (m_linkFreeTime < now)
+        m_linkFreeTime = now;
+
+    // Generate due packets
+    m_buffer.clear();
+    m_packetEnds.clear();
+    while (m_buffer.size() < MAX_BURST_SIZE) {
+        if (m_rate > 0 && m_nextPacketTime > now)
+            break;
+        if (m_baudRate > 0 && m_linkFreeTime > now)
+            break;
+        if (m_packetLimit > 0 && m_generated >= m_packetLimit)
+            break;
+
+        const int size = m_buffer.size();
+        generatePacket(m_buffer);
+        ++m_generated;
+
+        if (m_rate > 0)
+            m_nextPacketTime += static_cast<qint64>(1e9 / m_rate);
+        if (m_baudRate > 0)
+            m_linkFreeTime += static_cast<qint64>(
+                        (m_buffer.size() - size) * 1e10 / m_baudRate);
+    }
+
+    write(m_buffer);
+
+    // Check limits
+    if ((m_packetLimit > 0 && m_generated >= m_packetLimit) ||
+            (m_durationLimit > 0 && now >= m_durationLimit))
+        stop();
+}
+
+/**
+ * Prints the number of packets and bytes written and the number of faults
+ * injected (in total and per second)
+ */
+void PacketGenerator::printStatistics() {
+    const double seconds = m_clock.nsecsElapsed() / 1e9;
+    const qint64 packets = m_packets - m_lastPackets;
+    const qint64 bytes = m_bytes - m_lastBytes;
+    m_lastPackets = m_packets;
+    m_lastBytes = m_bytes;
+
+    QString faults;
+    for (int i = 0; i < kFaultCount; ++i) {
+        if (m_probabilities[i] > 0)
+            faults += QString("  %1 %2").arg(FAULT_NAMES[i],
+                                              QString::number(m_faults[i]));
+    }
+
+    if (m_skipped > 0)
+        faults += QString("  skipped %1").arg(m_skipped);
+
+    qInfo().noquote() << QString::asprintf("%8.1f s %12lld packets %10lld "
+                                           "packets/s %10.1f KB/s",
+                                           seconds,
+                                           static_cast<long long>(m_packets),
+                                           static_cast<long long>(packets),
+                                           bytes / 1024.0) + faults;
+}
+
+/**
+ * Accepts new TCP clients, every client receives the same packets
+ */
+void PacketGenerator::onNewConnection() {
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket* client = m_server->nextPendingConnection();
+        m_clients.append(client);
+
+        connect(client, &QTcpSocket::disconnected, this, [this, client]() {
+            m_clients.removeAll(client);
+            client->deleteLater();
+            qInfo() << "Client disconnected";
+        });
+
+        qInfo().noquote() << "Client connected from"
+                          << client->peerAddress().toString();
+    }
+}
+
+/**
+ * @returns @c true if the output can not take more data right now
+ */
+bool PacketGenerator::outputBusy() const {
+#ifdef Q_OS_UNIX
+    // The pty is full (e.g. nobody reads it)
+    if (m_output == kPty) {
+        struct pollfd fd;
+        fd.fd = m_ptyMaster;
+        fd.events = POLLOUT;
+        fd.revents = 0;
+        return poll(&fd, 1, 0) <= 0 || !(fd.revents & POLLOUT);
+    }
+#endif
+
+    if (m_output != kTcp)
+        return false;
+
+    if (m_clients.isEmpty())
+        return true;
+
+    foreach (const QTcpSocket* client, m_clients) {
+        if (client->bytesToWrite() > MAX_PENDING_BYTES)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Writes the given @a data to the output, UDP datagrams contain as many
+ * complete packets as possible
+ */
+void PacketGenerator::write(const QByteArray& data) {
+    if (data.isEmpty())
+        return;
+
+    switch (m_output) {
+    case kFile:
+        m_file.write(data);
+        break;
+    case kPty:
+        writePty(data);
+        return;
+    case kTcp:
+        foreach (QTcpSocket* client, m_clients)
+            client->write(data);
+        break;
+    case kUdp: {
+        int begin = 0;
+        int end = 0;
+        foreach (const int packetEnd, m_packetEnds) {
+            if (packetEnd - begin > MAX_DATAGRAM_SIZE && end > begin) {
+                m_udp->writeDatagram(data.constData() + begin, end - begin,
+                                     m_udpHost, m_udpPort);
+                begin = end;
+            }
+
+            end = packetEnd;
+        }
+
+        if (end > begin)
+            m_udp->writeDatagram(data.constData() + begin, end - begin,
+                                 m_udpHost, m_udpPort);
+        break;
+    }
+    default:
+        break;
+    }
+
+    m_bytes += data.size();
+}
+
+/**
+ * @brief Writes as much of the given @a data as the pty accepts
+ *
+ * The packets that do not fit (completely) in the pty are not written
+ * again, they are counted as skipped instead.
+ */
+void PacketGenerator::writePty(const QByteArray& data) {
+    int written = 0;
+
+#ifdef Q_OS_UNIX
+    while (written < data.size()) {
+        const ssize_t bytes = ::write(m_ptyMaster, data.constData() + written,
+                                      static_cast<size_t>(data.size() -
+                                                          written));
+        if (bytes > 0)
+            written += static_cast<int>(bytes);
+        else if (bytes < 0 && errno == EINTR)
+            continue;
+        else
+            break;
+    }
+#endif
+
+    for (int i = m_packetEnds.count() - 1; i >= 0; --i) {
+        if (m_packetEnds.at(i) <= written)
+            break;
+
+        --m_packets;
+        ++m_skipped;
+    }
+
+    m_bytes += written;
+}
+
+/**
+ * @brief Generates the next packet (with the faults that were selected
+ *        at random) and appends it to the given @a buffer
+ *
+ * Can also be used without an output, e.g. to build a corpus of packets
+ * for the benchmarks.
+ */
+void PacketGenerator::generatePacket(QByteArray& buffer) {
+    // The CanSat was reset
+    if (happens(kReset)) {
+        m_packetCount = 0;
+        m_missionTime = 0;
+    }
+
+    char packet[MAX_PACKET_SIZE];
+    int length = encodePacket(packet, sizeof(packet));
+
+    ++m_packetCount;
+    m_missionTime += static_cast<quint32>(m_missionStep);
+
+    // The packet was lost
+    if (happens(kDrop))
+        return;
+
+    // Replace a random byte (EOT bytes are not modified)
+    if (happens(kCorrupt)) {
+        const int index = static_cast<int>(random() * (length - 2));
+        packet[index] = static_cast<char>(' ' + random() * 95);
+    }
+
+    // Cut the packet (EOT bytes are lost)
+    if (happens(kTruncate))
+        length = 1 + static_cast<int>(random() * (length - 3));
+
+    buffer.append(packet, length);
+    m_packetEnds.append(buffer.size());
+    ++m_packets;
+
+    // Send the packet again
+    if (happens(kDuplicate)) {
+        buffer.append(packet, length);
+        m_packetEnds.append(buffer.size());
+        ++m_packets;
+    }
+}
+
+/**
+ * @brief Writes the current packet into the given @a buffer
+ *
+ * The fields follow the order of @c DataParser::DataPosition, the CRC-32
+ * code (if enabled) is calculated over all previous fields and
+ * separators, in the same way as the data parser does.
+ *
+ * @returns the length of the packet (including the EOT bytes)
+ */
+int PacketGenerator::encodePacket(char* buffer, const int size) {
+    const FlightState s = m_simulator.stateAt(m_missionTime);
+
+    // GPS coordinates are split in degrees & minutes (with the same sign)
+    const int latDeg = static_cast<int>(s.latitude);
+    const int lonDeg = static_cast<int>(s.longitude);
+    const double latMin = (s.latitude - latDeg) * 60;
+    const double lonMin = (s.longitude - lonDeg) * 60;
+
+    int length = snprintf(buffer, static_cast<size_t>(size),
+                          "KAANSATQRO,%d,%u,%.2f,%.3f,%.3f,%.2f,%.2f,%.2f,"
+                          "%.2f,%llu,%d,%.4f,%d,%.4f,%.1f,%d,%.3f,%.3f,%.3f,"
+                          "%.2f,%.2f,%.2f,%u,%d",
+                          m_teamId,
+                          m_packetCount,
+                          s.altitude,
+                          s.pressure,
+                          s.voltage,
+                          s.intTemperature,
+                          s.extTemperature,
+                          s.airQuality,
+                          s.carbonMonoxide,
+                          static_cast<unsigned long long>(s.gpsTime),
+                          lonDeg, lonMin,
+                          latDeg, latMin,
+                          s.gpsAltitude,
+                          s.satellites,
+                          s.accelerometer[0],
+                          s.accelerometer[1],
+                          s.accelerometer[2],
+                          s.magnetometer[0],
+                          s.magnetometer[1],
+                          s.magnetometer[2],
+                          m_missionTime,
+                          s.parachute ? 1 : 0);
+
+    if (m_crcEnabled) {
+        buffer[length++] = ',';
+        const quint32 crc = CRC32(buffer, static_cast<size_t>(length));
+        length += snprintf(buffer + length, static_cast<size_t>(size - length),
+                           "%u", crc);
+    }
+
+    buffer[length++] = '\r';
+    buffer[length++] = '\n';
+    return length;
+}
+
+/**
+ * @returns a random number between 0 (inclusive) and 1 (exclusive)
+ */
+double PacketGenerator::random() {
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    return static_cast<double>(m_random >> 11) / 9007199254740992.0;
+}
+
+/**
+ * @returns @c true if the given @a fault shall be injected (and counts it)
+ */
+bool PacketGenerator::happens(const Fault fault) {
+    if (m_probabilities[fault] <= 0 || random() >= m_probabilities[fault])
+        return false;
+
+    ++m_faults[fault];
+    return true;
+}
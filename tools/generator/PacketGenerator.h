@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PACKET_GENERATOR_H
+#define PACKET_GENERATOR_H
+
+#include <QFile>
+#include <QList>
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QElapsedTimer>
+
+#include "FlightSimulator.h"
+
+class QTcpServer;
+class QTcpSocket;
+class QUdpSocket;
+
+/**
+ * @brief Writes synthetic telemetry packets to a file, pty or socket
+ *
+ * Packets follow the layout of @c DataParser::DataPosition (with an
+ * optional CRC-32 field) and contain the readings of a simulated flight.
+ * Packets are written at a fixed rate (or as fast as the output accepts
+ * them), optionally limited by the throughput of a serial link with the
+ * given baud rate. Faults are injected at random with the configured
+ * probabilities:
+ *
+ *     - Corruption: a random byte of the packet is replaced
+ *     - Truncation: the end of the packet (and its EOT bytes) is lost
+ *     - Duplication: the packet is written twice
+ *     - Reset: packet count and mission time restart from zero
+ *     - Drop: the packet is not written (but its packet count is used)
+ *
+ * Outputs are described with the same source strings used by the ground
+ * station, from the point of view of the writer:
+ *
+ *     - @c file:/path/log.txt    Append packets to a file
+ *     - @c stdout:               Write packets to the standard output
+ *     - @c pty:                  Create a pseudo-terminal (Unix only), the
+ *                                generator waits while the pty is full
+ *     - @c tcp://:port           Serve packets to every TCP client
+ *     - @c udp://host:port       Send packets as UDP datagrams
+ */
+class PacketGenerator : public QObject {
+    Q_OBJECT
+
+signals:
+    void finished();
+
+public:
+    enum Fault {
+        kCorrupt,
+        kTruncate,
+        kDuplicate,
+        kReset,
+        kDrop,
+        kFaultCount
+    };
+
+    explicit PacketGenerator(QObject* parent = Q_NULLPTR);
+    ~PacketGenerator();
+
+    FlightSimulator& simulator();
+
+    QString outputName() const;
+    bool open(const QString& output);
+
+    void setSeed(const quint32 seed);
+    void setTeamId(const int teamId);
+    void setRate(const double packetsPerSecond);
+    void setBaudRate(const int baudRate);
+    void setMissionStep(const int milliseconds);
+    void setCrcEnabled(const bool enabled);
+    void setPacketLimit(const qint64 packets);
+    void setDuration(const double seconds);
+    void setFaultProbability(const Fault fault, const double probability);
+
+    void generatePacket(QByteArray& buffer);
+
+public slots:
+    void start();
+    void stop();
+
+private slots:
+    void onTimeout();
+    void printStatistics();
+    void onNewConnection();
+
+private:
+    bool outputBusy() const;
+    void write(const QByteArray& data);
+    void writePty(const QByteArray& data);
+    int encodePacket(char* buffer, const int size);
+
+    double random();
+    bool happens(const Fault fault);
+
+private:
+    enum Output {
+        kNone,
+        kFile,
+        kPty,
+        kTcp,
+        kUdp
+    };
+
+    Output m_output;
+    QString m_outputName;
+
+    QFile m_file;
+    int m_ptyMaster;
+    int m_ptySlave;
+    QTcpServer* m_server;
+    QList<QTcpSocket*> m_clients;
+    QUdpSocket* m_udp;
+    QHostAddress m_udpHost;
+    quint16 m_udpPort;
+
+    FlightSimulator m_simulator;
+    quint64 m_random;
+
+    int m_teamId;
+    bool m_crcEnabled;
+    double m_rate;
+    int m_baudRate;
+    int m_missionStep;
+    qint64 m_packetLimit;
+    qint64 m_durationLimit;
+    double m_probabilities[kFaultCount];
+
+    quint32 m_packetCount;
+    quint32 m_missionTime;
+
+    QTimer m_timer;
+    QTimer m_statsTimer;
+    QElapsedTimer m_clock;
+    qint64 m_nextPacketTime;
+    qint64 m_linkFreeTime;
+
+    QByteArray m_buffer;
+    QVector<int> m_packetEnds;
+
+    qint64 m_generated;
+    qint64 m_packets;
+    qint64 m_skipped;
+    qint64 m_bytes;
+    qint64 m_lastPackets;
+    qint64 m_lastBytes;
+    qint64 m_faults[kFaultCount];
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2018 Kaan-Sat <https://kaansat.com.mx/>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "PacketGenerator.h"
+
+/**
+ * @brief Entry-point function of the telemetry generator
+ *
+ * Writes synthetic CanSat packets to a file, pty or socket, so that the
+ * ground station can be tested (and load-tested) without hardware, e.g.:
+ *
+ *     cansat-generator --output pty: --rate 200 --corrupt 0.01
+ *     cansat-gss --source pty:/dev/pts/4
+ *
+ * @returns the exit status of the @c qApp event loop
+ */
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cansat-generator");
+    QCoreApplication::setApplicationVersion("1.0");
+
+    // Define command line options
+    QCommandLineParser arguments;
+    arguments.setApplicationDescription("Synthetic CanSat telemetry generator");
+    arguments.addHelpOption();
+    arguments.addVersionOption();
+
+    const QCommandLineOption output("output",
+                                    "Output: file:/path, stdout:, pty:, "
+                                    "tcp://:port or udp://host:port",
+                                    "output", "pty:");
+    const QCommandLineOption rate("rate",
+                                  "Packets per second, 0 writes packets as "
+                                  "fast as possible",
+                                  "rate", "1");
+    const QCommandLineOption baud("baud",
+                                  "Limit the throughput to a serial link "
+                                  "with the given baud rate",
+                                  "baud", "0");
+    const QCommandLineOption step("step",
+                                  "Mission time between packets (ms), "
+                                  "derived from the rate by default",
+                                  "ms", "0");
+    const QCommandLineOption count("count",
+                                   "Stop after the given number of packets",
+                                   "packets", "0");
+    const QCommandLineOption duration("duration",
+                                      "Stop after the given number of seconds",
+                                      "seconds", "0");
+    const QCommandLineOption team("team", "Team ID", "id", "1");
+    const QCommandLineOption apogee("apogee", "Apogee of the flight (m)",
+                                    "meters", "700");
+    const QCommandLineOption seed("seed", "Random seed", "seed", "1");
+    const QCommandLineOption crc("crc", "Append a CRC-32 field");
+    const QCommandLineOption corrupt("corrupt",
+                                     "Probability of corrupting a byte",
+                                     "p", "0");
+    const QCommandLineOption truncate("truncate",
+                                      "Probability of truncating a packet",
+                                      "p", "0");
+    const QCommandLineOption duplicate("duplicate",
+                                       "Probability of repeating a packet",
+                                       "p", "0");
+    const QCommandLineOption reset("reset",
+                                   "Probability of resetting the CanSat",
+                                   "p", "0");
+    const QCommandLineOption drop("drop",
+                                  "Probability of losing a packet",
+                                  "p", "0");
+
+    arguments.addOptions({output, rate, baud, step, count, duration, team,
+                          apogee, seed, crc, corrupt, truncate, duplicate,
+                          reset, drop});
+    arguments.process(app);
+
+    // Configure the generator
+    PacketGenerator generator;
+    generator.setSeed(arguments.value(seed).toUInt());
+    generator.setTeamId(arguments.value(team).toInt());
+    generator.setRate(arguments.value(rate).toDouble());
+    generator.setBaudRate(arguments.value(baud).toInt());
+    generator.setMissionStep(arguments.value(step).toInt());
+    generator.setPacketLimit(arguments.value(count).toLongLong());
+    generator.setDuration(arguments.value(duration).toDouble());
+    generator.setCrcEnabled(arguments.isSet(crc));
+    generator.simulator().setApogee(arguments.value(apogee).toDouble());
+
+    generator.setFaultProbability(PacketGenerator::kCorrupt,
+                                  arguments.value(corrupt).toDouble());
+    generator.setFaultProbability(PacketGenerator::kTruncate,
+                                  arguments.value(truncate).toDouble());
+    generator.setFaultProbability(PacketGenerator::kDuplicate,
+                                  arguments.value(duplicate).toDouble());
+    generator.setFaultProbability(PacketGenerator::kReset,
+                                  arguments.value(reset).toDouble());
+    generator.setFaultProbability(PacketGenerator::kDrop,
+                                  arguments.value(drop).toDouble());
+
+    // Open the output and start writing packets
+    if (!generator.open(arguments.value(output)))
+        return EXIT_FAILURE;
+
+    QObject::connect(&generator, &PacketGenerator::finished,
+                     &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    generator.start();
+
+    return app.exec();
+}